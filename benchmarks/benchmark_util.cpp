@@ -0,0 +1,77 @@
+///
+/// @file benchmark_util.cpp
+///
+/// Contains the implementation of the shared benchmark helpers, including the
+/// counting replacements of the global operator new and delete.
+///
+
+#include "benchmark_util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+namespace
+{
+
+std::atomic<std::uint64_t> allocationCount{0};
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size ? size : 1))
+  {
+    return p;
+  }
+
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+std::uint64_t jvs::benchmarks::allocation_count() noexcept
+{
+  return allocationCount.load(std::memory_order_relaxed);
+}
+
+void jvs::benchmarks::report(const char* name, const Result& result)
+{
+  std::cout << std::left << std::setw(36) << name << std::right << std::fixed
+    << std::setprecision(1) << std::setw(10) << result.nanosPerOp << " ns/op"
+    << std::setprecision(3) << std::setw(10) << result.allocationsPerOp << " allocs/op\n";
+}
+
+void jvs::benchmarks::report_percentiles(const char* name,
+  std::vector<std::chrono::steady_clock::duration> samples)
+{
+  if (samples.empty())
+  {
+    return;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  auto percentile = [&](double p)
+  {
+    auto index = std::min(samples.size() - 1, static_cast<std::size_t>(p * samples.size()));
+    return std::chrono::duration<double, std::micro>(samples[index]).count();
+  };
+
+  std::cout << std::left << std::setw(24) << name << std::right << std::fixed
+    << std::setprecision(2)
+    << " p50 " << std::setw(8) << percentile(0.50) << " us"
+    << "  p99 " << std::setw(8) << percentile(0.99) << " us"
+    << "  p99.9 " << std::setw(8) << percentile(0.999) << " us\n";
+}
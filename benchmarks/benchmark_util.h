@@ -0,0 +1,75 @@
+///
+/// @file benchmark_util.h
+///
+/// Contains the measurement and reporting helpers shared by the benchmarks.
+///
+
+#if !defined(JVS_NETLIB_BENCHMARK_UTIL_H_)
+#define JVS_NETLIB_BENCHMARK_UTIL_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace jvs::benchmarks
+{
+
+// Number of global operator new calls so far. Linking this replaces the
+// global operator new and delete with counting versions.
+std::uint64_t allocation_count() noexcept;
+
+struct Result
+{
+  double nanosPerOp;
+  double allocationsPerOp;
+};
+
+// Calls `func` `warmupIterations` times to warm up per-thread caches, then
+// returns the time and allocations per call over `iterations` calls. `func`
+// is passed the iteration index if it takes one.
+template <typename FuncT>
+Result measure(std::size_t iterations, FuncT&& func, std::size_t warmupIterations = 1000)
+{
+  auto call = [&](std::size_t i)
+  {
+    if constexpr (std::is_invocable_v<FuncT&, std::size_t>)
+    {
+      func(i);
+    }
+    else
+    {
+      func();
+    }
+  };
+
+  for (std::size_t i = 0; i < warmupIterations; ++i)
+  {
+    call(i);
+  }
+
+  auto allocationsBefore = allocation_count();
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < iterations; ++i)
+  {
+    call(i);
+  }
+
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  auto allocations = allocation_count() - allocationsBefore;
+  return {
+    std::chrono::duration<double, std::nano>(elapsed).count() / iterations,
+    static_cast<double>(allocations) / iterations
+  };
+}
+
+void report(const char* name, const Result& result);
+
+// Prints the 50th, 99th and 99.9th percentile of `samples`, which may be
+// empty (nothing is printed then).
+void report_percentiles(const char* name, std::vector<std::chrono::steady_clock::duration> samples);
+
+} // namespace jvs::benchmarks
+
+#endif // !JVS_NETLIB_BENCHMARK_UTIL_H_
@@ -0,0 +1,239 @@
+///
+/// @file busy_poll_latency_benchmark.cpp
+///
+/// Measures UDP round-trip latency on loopback, comparing an echo thread
+/// sleeping in a blocking Socket::recvfrom (and a client sleeping in a
+/// blocking recv) with a BusyPoller echoing from a pinned, spinning thread
+/// (and a client spinning on non-blocking recv). Reports percentiles of the
+/// round-trip time.
+///
+/// Usage: busy-poll-latency-benchmark [round trips] [poller CPU] [client CPU]
+///
+/// The two spinning threads need a CPU each; with fewer CPUs the busy poll
+/// results mostly measure the scheduler.
+///
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <jvs-netlib/busy_poller.h>
+#include <jvs-netlib/error.h>
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_errors.h>
+
+#include "benchmark_util.h"
+
+namespace
+{
+
+using namespace jvs;
+using namespace jvs::net;
+
+using Clock = std::chrono::steady_clock;
+using jvs::benchmarks::report_percentiles;
+
+void pin_current_thread(int cpu) noexcept
+{
+  if (cpu < 0)
+  {
+    return;
+  }
+
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+}
+
+// Sends a datagram and waits for the echo, `iterations` times; returns the
+// round-trip times, or none if a send or receive failed.
+template <typename ReceiveFuncT>
+std::vector<Clock::duration> measure(std::size_t iterations, Socket& client,
+  const IpEndPoint& server, ReceiveFuncT&& receive)
+{
+  std::vector<Clock::duration> samples;
+  samples.reserve(iterations);
+  std::uint64_t payload[8]{};
+  // The first round trips warm up caches and the echo path.
+  for (std::size_t i = 0; i < iterations + 1000; ++i)
+  {
+    payload[0] = i;
+    auto start = Clock::now();
+    auto sent = client.sendto(payload, sizeof(payload), server);
+    if (!sent)
+    {
+      log_all_unhandled_errors(sent.take_error(), std::cerr, "sendto: ");
+      return {};
+    }
+
+    if (!receive(payload, sizeof(payload)))
+    {
+      return {};
+    }
+
+    auto elapsed = Clock::now() - start;
+    if (i >= 1000)
+    {
+      samples.push_back(elapsed);
+    }
+  }
+
+  return samples;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  std::size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 20000;
+  int pollerCpu = (argc > 2) ? std::atoi(argv[2]) : 1;
+  int clientCpu = (argc > 3) ? std::atoi(argv[3]) : 2;
+  if (std::thread::hardware_concurrency() < 3)
+  {
+    std::cerr << "Warning: fewer than 3 CPUs; busy polling threads will compete.\n";
+    pollerCpu = -1;
+    clientCpu = -1;
+  }
+
+  auto loopback = *IpEndPoint::parse("127.0.0.1:0");
+  pin_current_thread(clientCpu);
+
+  // Blocking: both ends sleep in recv until the datagram arrives.
+  Socket blockingServer(IpAddress::Family::IPv4, Socket::Transport::Udp);
+  auto blockingEp = blockingServer.bind(loopback);
+  if (!blockingEp)
+  {
+    log_all_unhandled_errors(blockingEp.take_error(), std::cerr, "bind: ");
+    return 1;
+  }
+
+  std::thread echoThread([&]
+    {
+      pin_current_thread(pollerCpu);
+      char buffer[64];
+      for (;;)
+      {
+        auto received = blockingServer.recvfrom(buffer, sizeof(buffer));
+        if (!received)
+        {
+          consume_error(received.take_error());
+          return;
+        }
+
+        // An empty datagram ends the echo thread.
+        if (received->first == 0)
+        {
+          return;
+        }
+
+        consume_error(blockingServer.sendto(buffer, received->first, received->second)
+          .take_error());
+      }
+    });
+
+  Socket blockingClient(IpAddress::Family::IPv4, Socket::Transport::Udp);
+  auto blocking = measure(iterations, blockingClient, *blockingEp,
+    [&](void* buffer, std::size_t length)
+    {
+      auto received = blockingClient.recv(buffer, length);
+      if (!received)
+      {
+        log_all_unhandled_errors(received.take_error(), std::cerr, "recv: ");
+        return false;
+      }
+
+      return true;
+    });
+
+  consume_error(blockingClient.sendto(nullptr, 0, *blockingEp).take_error());
+  echoThread.join();
+  blockingClient.close();
+  blockingServer.close();
+
+  // Busy polling: the echo side spins in a BusyPoller, the client spins on
+  // non-blocking recv.
+  BusyPoller::Options options;
+  options.cpu = pollerCpu;
+  auto poller = BusyPoller::create(options);
+  if (!poller)
+  {
+    log_all_unhandled_errors(poller.take_error(), std::cerr, "BusyPoller: ");
+    return 1;
+  }
+
+  Socket pollingServer(IpAddress::Family::IPv4, Socket::Transport::Udp);
+  auto pollingEp = pollingServer.bind(loopback);
+  if (!pollingEp)
+  {
+    log_all_unhandled_errors(pollingEp.take_error(), std::cerr, "bind: ");
+    return 1;
+  }
+
+  auto added = poller->add(pollingServer, [](Socket& s)
+    {
+      char buffer[64];
+      for (;;)
+      {
+        auto received = s.recvfrom(buffer, sizeof(buffer));
+        if (!received)
+        {
+          bool drained = received.error_is_a<NonBlockingStatus>();
+          consume_error(received.take_error());
+          return drained;
+        }
+
+        consume_error(s.sendto(buffer, received->first, received->second).take_error());
+      }
+    });
+  if (added)
+  {
+    log_all_unhandled_errors(std::move(added), std::cerr, "add: ");
+    return 1;
+  }
+
+  Socket pollingClient(IpAddress::Family::IPv4, Socket::Transport::Udp, /*nonBlocking*/ true);
+  auto polling = measure(iterations, pollingClient, *pollingEp,
+    [&](void* buffer, std::size_t length)
+    {
+      for (;;)
+      {
+        auto received = pollingClient.recv(buffer, length);
+        if (received)
+        {
+          return true;
+        }
+
+        if (!received.error_is_a<NonBlockingStatus>())
+        {
+          log_all_unhandled_errors(received.take_error(), std::cerr, "recv: ");
+          return false;
+        }
+
+        consume_error(received.take_error());
+      }
+    });
+
+  consume_error(poller->remove(pollingServer));
+  poller->stop();
+  pollingClient.close();
+  pollingServer.close();
+
+  if (blocking.empty() || polling.empty())
+  {
+    return 1;
+  }
+
+  report_percentiles("blocking recv", std::move(blocking));
+  report_percentiles("busy poll", std::move(polling));
+  return 0;
+}
@@ -0,0 +1,92 @@
+///
+/// @file socket_construction_benchmark.cpp
+///
+/// Measures the cost (time and operator new allocations) of constructing and
+/// closing a Socket, compared to the getaddrinfo lookup plus socket call which
+/// Socket construction used to perform, and to a bare socket/close pair. Note
+/// that getaddrinfo allocates with malloc, which isn't counted.
+///
+
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <jvs-netlib/ip_address.h>
+#include <jvs-netlib/socket.h>
+
+#include "benchmark_util.h"
+
+int main(int argc, char** argv)
+{
+  using namespace jvs::net;
+  using jvs::benchmarks::measure;
+  using jvs::benchmarks::report;
+
+  std::size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 100000;
+  std::size_t failures = 0;
+
+  auto construct = measure(iterations, [&]
+    {
+      Socket sock(IpAddress::Family::IPv4, Socket::Transport::Tcp);
+      if (sock.descriptor() < 0)
+      {
+        ++failures;
+      }
+
+      sock.close();
+    });
+
+  // What every construction did before: resolve the wildcard address of the
+  // family, then create the socket.
+  auto lookupAndSocket = measure(iterations, [&]
+    {
+      addrinfo hints{};
+      hints.ai_family = AF_INET;
+      hints.ai_socktype = SOCK_STREAM;
+      hints.ai_flags = AI_PASSIVE;
+      addrinfo* ainfo = nullptr;
+      if (::getaddrinfo(nullptr, "0", &hints, &ainfo) != 0)
+      {
+        ++failures;
+        return;
+      }
+
+      int fd = ::socket(ainfo->ai_family, ainfo->ai_socktype, IPPROTO_TCP);
+      ::freeaddrinfo(ainfo);
+      if (fd < 0)
+      {
+        ++failures;
+        return;
+      }
+
+      ::close(fd);
+    });
+
+  auto bareSocket = measure(iterations, [&]
+    {
+      int fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+      if (fd < 0)
+      {
+        ++failures;
+        return;
+      }
+
+      ::close(fd);
+    });
+
+  report("Socket construct + close", construct);
+  report("getaddrinfo + socket + close", lookupAndSocket);
+  report("socket + close", bareSocket);
+  if (failures)
+  {
+    std::cerr << failures << " sockets couldn't be created.\n";
+    return 1;
+  }
+
+  return 0;
+}
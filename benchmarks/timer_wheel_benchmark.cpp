@@ -0,0 +1,92 @@
+///
+/// @file timer_wheel_benchmark.cpp
+///
+/// Measures the cost (time and heap allocations) of arming, re-arming and
+/// cancelling TimerWheel timers, and of advancing the wheel, with a large
+/// number of idle-timeout style deadlines pending.
+///
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <jvs-netlib/timer_wheel.h>
+
+#include "benchmark_util.h"
+
+int main(int argc, char** argv)
+{
+  using namespace jvs::net;
+  using jvs::benchmarks::measure;
+  using jvs::benchmarks::report;
+  using std::chrono::milliseconds;
+
+  std::size_t timerCount = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+  auto start = TimerWheel::Clock::now();
+  TimerWheel wheel(milliseconds(1), start);
+  std::size_t fired = 0;
+  std::vector<TimerWheel::Timer> timers(timerCount);
+  for (auto& timer : timers)
+  {
+    timer.set_callback([&] { ++fired; });
+  }
+
+  // Idle timeouts spread over the next few minutes.
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int> delays(1, 5 * 60 * 1000);
+  std::vector<milliseconds> deadlines(timerCount);
+  for (auto& deadline : deadlines)
+  {
+    deadline = milliseconds(delays(random));
+  }
+
+  auto arm = measure(timerCount, [&](std::size_t i)
+    {
+      wheel.arm(timers[i], start + deadlines[i]);
+    }, /*warmupIterations*/ 0);
+
+  // What a connection does on every read: push its idle timeout back.
+  auto rearm = measure(timerCount, [&](std::size_t i)
+    {
+      wheel.arm(timers[i], start + deadlines[i] + milliseconds(1000));
+    }, /*warmupIterations*/ 0);
+
+  auto cancel = measure(timerCount / 2, [&](std::size_t i)
+    {
+      wheel.cancel(timers[2 * i]);
+    }, /*warmupIterations*/ 0);
+
+  // The remaining half fire, over 100 ms steps.
+  std::size_t steps = 0;
+  auto now = start;
+  auto advanceStart = std::chrono::steady_clock::now();
+  while (wheel.size() != 0)
+  {
+    now += milliseconds(100);
+    wheel.advance(now);
+    ++steps;
+  }
+
+  auto advanceElapsed = std::chrono::steady_clock::now() - advanceStart;
+
+  report("arm", arm);
+  report("re-arm", rearm);
+  report("cancel", cancel);
+  std::cout << std::left << std::setw(36) << "advance (per expired timer)" << std::right
+    << std::fixed << std::setprecision(1) << std::setw(10)
+    << std::chrono::duration<double, std::nano>(advanceElapsed).count() / (fired ? fired : 1)
+    << " ns/op (" << steps << " steps)\n";
+  if (fired != timerCount - timerCount / 2)
+  {
+    std::cerr << "Expected " << timerCount - timerCount / 2 << " timers to fire, got "
+      << fired << ".\n";
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,181 @@
+///
+/// @file unix_socket_latency_benchmark.cpp
+///
+/// Measures request/response round-trip latency between two threads over a
+/// loopback TCP connection and over a Unix domain stream socket pair, with
+/// blocking sockets on both ends. Reports percentiles of the round-trip time.
+///
+/// Usage: unix-socket-latency-benchmark [round trips] [message size]
+///
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <jvs-netlib/error.h>
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_options.h>
+#include <jvs-netlib/unix_socket.h>
+
+#include "benchmark_util.h"
+
+namespace
+{
+
+using namespace jvs;
+using namespace jvs::net;
+
+using Clock = std::chrono::steady_clock;
+using jvs::benchmarks::report_percentiles;
+
+// Receives exactly `length` bytes; false if the connection failed or closed.
+template <typename SocketT>
+bool recv_all(SocketT& s, char* buffer, std::size_t length)
+{
+  while (length > 0)
+  {
+    auto received = s.recv(buffer, length);
+    if (!received || *received == 0)
+    {
+      consume_error(received.take_error());
+      return false;
+    }
+
+    buffer += *received;
+    length -= *received;
+  }
+
+  return true;
+}
+
+template <typename SocketT>
+bool send_all(SocketT& s, const char* buffer, std::size_t length)
+{
+  while (length > 0)
+  {
+    auto sent = s.send(buffer, length);
+    if (!sent)
+    {
+      consume_error(sent.take_error());
+      return false;
+    }
+
+    buffer += *sent;
+    length -= *sent;
+  }
+
+  return true;
+}
+
+// Echoes messages from `server` on a separate thread while `client` sends
+// `iterations` of them; returns the round-trip times, or none on failure.
+// Both sockets are closed.
+template <typename SocketT>
+std::vector<Clock::duration> measure(std::size_t iterations, std::size_t messageSize,
+  SocketT& client, SocketT& server)
+{
+  // The first round trips warm up caches and the echo path.
+  std::size_t total = iterations + 1000;
+  std::thread echoThread([&]
+    {
+      std::vector<char> buffer(messageSize);
+      for (std::size_t i = 0; i < total; ++i)
+      {
+        if (!recv_all(server, buffer.data(), messageSize) ||
+          !send_all(server, buffer.data(), messageSize))
+        {
+          break;
+        }
+      }
+
+      server.close();
+    });
+
+  std::vector<Clock::duration> samples;
+  samples.reserve(iterations);
+  std::vector<char> buffer(messageSize);
+  for (std::size_t i = 0; i < total; ++i)
+  {
+    auto start = Clock::now();
+    if (!send_all(client, buffer.data(), messageSize) ||
+      !recv_all(client, buffer.data(), messageSize))
+    {
+      samples.clear();
+      break;
+    }
+
+    auto elapsed = Clock::now() - start;
+    if (i >= 1000)
+    {
+      samples.push_back(elapsed);
+    }
+  }
+
+  client.close();
+  echoThread.join();
+  return samples;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  std::size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 20000;
+  std::size_t messageSize = (argc > 2) ? std::strtoul(argv[2], nullptr, 10) : 64;
+  if (iterations == 0 || messageSize == 0)
+  {
+    std::cerr << "Round trips and message size must be positive.\n";
+    return 1;
+  }
+
+  Socket listener(IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  auto listenerEp = listener.bind(*IpEndPoint::parse("127.0.0.1:0"));
+  if (!listenerEp)
+  {
+    log_all_unhandled_errors(listenerEp.take_error(), std::cerr, "bind: ");
+    return 1;
+  }
+
+  consume_error(listener.listen().take_error());
+  Socket tcpClient(IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  auto connected = tcpClient.connect(*listenerEp);
+  if (!connected)
+  {
+    log_all_unhandled_errors(connected.take_error(), std::cerr, "connect: ");
+    return 1;
+  }
+
+  auto tcpServer = listener.accept();
+  if (!tcpServer)
+  {
+    log_all_unhandled_errors(tcpServer.take_error(), std::cerr, "accept: ");
+    return 1;
+  }
+
+  listener.close();
+  consume_error(tcpClient.set_option<sockopt::TcpNoDelay>(true));
+  consume_error(tcpServer->set_option<sockopt::TcpNoDelay>(true));
+  auto tcp = measure(iterations, messageSize, tcpClient, *tcpServer);
+
+  auto unixPair = UnixSocket::pair(UnixSocket::Transport::Stream);
+  if (!unixPair)
+  {
+    log_all_unhandled_errors(unixPair.take_error(), std::cerr, "socketpair: ");
+    return 1;
+  }
+
+  auto unixStream = measure(iterations, messageSize, unixPair->first, unixPair->second);
+  if (tcp.empty() || unixStream.empty())
+  {
+    std::cerr << "A connection failed during the measurement.\n";
+    return 1;
+  }
+
+  report_percentiles("loopback TCP", std::move(tcp));
+  report_percentiles("Unix domain stream", std::move(unixStream));
+  return 0;
+}
@@ -0,0 +1,82 @@
+///
+/// @file would_block_benchmark.cpp
+///
+/// Measures the cost (time and heap allocations) of a failed recv on an empty
+/// non-blocking socket and of a discarded SocketError, compared to creating a
+/// SocketError with an eagerly formatted message (which is what every socket
+/// error used to cost).
+///
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <jvs-netlib/error.h>
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_errors.h>
+
+#include "benchmark_util.h"
+
+int main(int argc, char** argv)
+{
+  using namespace jvs;
+  using namespace jvs::net;
+  using jvs::benchmarks::measure;
+  using jvs::benchmarks::report;
+
+  std::size_t iterations = (argc > 1) ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+
+  Socket sock(IpAddress::Family::IPv4, Socket::Transport::Udp, /*nonBlocking*/ true);
+  auto boundEp = sock.bind(*IpEndPoint::parse("127.0.0.1:0"));
+  if (!boundEp)
+  {
+    log_all_unhandled_errors(boundEp.take_error(), std::cerr, "bind: ");
+    return 1;
+  }
+
+  char buffer[64];
+  std::size_t unexpected = 0;
+  auto failedRecv = measure(iterations, [&]
+    {
+      auto received = sock.recv(buffer, sizeof(buffer));
+      if (received || !received.error_is_a<NonBlockingStatus>())
+      {
+        ++unexpected;
+      }
+
+      consume_error(received.take_error());
+    });
+
+  auto discardedError = measure(iterations, []
+    {
+      auto e = make_error<SocketError>(errcodes::EConnRefused);
+      if (!e.is_a<SocketError>())
+      {
+        std::abort();
+      }
+
+      consume_error(std::move(e));
+    });
+
+  auto eagerError = measure(iterations, []
+    {
+      consume_error(make_error<SocketError>(
+        errcodes::EConnRefused, std::string(std::strerror(errcodes::EConnRefused))));
+    });
+
+  sock.close();
+
+  report("failed recv (NonBlockingStatus)", failedRecv);
+  report("discarded SocketError", discardedError);
+  report("SocketError with formatted message", eagerError);
+  if (unexpected)
+  {
+    std::cerr << unexpected << " recv calls didn't report would-block.\n";
+    return 1;
+  }
+
+  return 0;
+}
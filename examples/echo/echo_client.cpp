@@ -14,6 +14,7 @@
 #include <string_view>
 #include <utility>
 
+#include <jvs-netlib/buffered_reader.h>
 #include <jvs-netlib/error.h>
 #include <jvs-netlib/socket.h>
 #include <jvs-netlib/transport_end_point.h>
@@ -58,40 +59,6 @@ Socket& operator<<(Socket& s, const std::string& data)
   return s;
 }
 
-// Socket stream-extraction operator
-Socket& operator>>(Socket& s, std::string& data)
-{
-  char startBuf = 0;
-  auto recvResult = s.recv(&startBuf, 0);
-  if (!recvResult)
-  {
-    handle_all_errors(recvResult.take_error(), reportError);
-  }
-
-  auto bytesToRead = s.available();
-  if (!bytesToRead)
-  {
-    handle_all_errors(bytesToRead.take_error(), reportError);
-  }
-
-  std::vector<char> buffer(*bytesToRead);
-  auto bytesRead = s.recv(&buffer[0], buffer.size());
-  if (!bytesRead)
-  {
-    handle_all_errors(bytesRead.take_error(), reportError);
-  }
-
-  if (!*bytesRead)
-  {
-    // Connection was closed.
-    return s;
-  }
-
-  data.reserve(*bytesRead);
-  data.append(buffer.data(), *bytesRead);
-  return s;
-}
-
 int main(int argc, char** argv)
 {
   if (argc <= 1)
@@ -107,14 +74,24 @@ int main(int argc, char** argv)
     auto remoteEp = client.connect(ep->ip_end_point());
     if (remoteEp)
     {
+      BufferedReader reader(client);
       std::string input;
-      std::string reply;
       while (std::getline(std::cin, input))
       {
         client << input;
-        client >> reply;
-        std::cout << reply << '\n';
-        reply.clear();
+        auto reply = reader.read_some();
+        if (!reply)
+        {
+          handle_all_errors(reply.take_error(), reportError);
+        }
+
+        if (!*reply)
+        {
+          // Connection was closed.
+          break;
+        }
+
+        std::cout << **reply << '\n';
       }
 
       client.close();
@@ -4,18 +4,27 @@
 /// Example usage of the Socket class to act as an echo protocol server.
 /// 
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <cstdlib>
 #include <functional>
-#include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string_view>
 #include <utility>
 #include <vector>
 
+#include <jvs-netlib/buffered_reader.h>
+#include <jvs-netlib/executor.h>
 #include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_errors.h>
 #include <jvs-netlib/transport_end_point.h>
+#if defined(__linux__)
+#include <jvs-netlib/reactor.h>
+#endif
 
 #include "print_data.h"
 
@@ -35,68 +44,295 @@ void reportError(const jvs::ErrorInfoBase& e)
 
 void handleClient(Socket& client)
 {
-  std::vector<std::uint8_t> buffer;
+  BufferedReader reader(client);
   for (;;)
   {
-    char startBuf = 0;
-    auto recvResult = client.recv(&startBuf, 0);
-    if (!recvResult)
+    auto received = reader.read_some();
+    if (!received)
     {
-      handle_all_errors(recvResult.take_error(), reportError);
+      handle_all_errors(received.take_error(), reportError);
     }
 
-    auto bytesAvailable = client.available();
-    if (!bytesAvailable)
+    if (!*received)
     {
-      handle_all_errors(bytesAvailable.take_error(), reportError);
+      // Remote end disconnected.
+      std::cout << "Remote end disconnected.\n";
+      client.close();
+      break;
     }
 
-    if (*bytesAvailable > buffer.size())
+    std::string_view data = **received;
+    std::cout << "Received " << data.size() << " bytes: \"";
+    print_data(data.data(), data.data() + data.size(), std::cout);
+    std::cout << "\"\n";
+    auto sentBytes = client.send(data.data(), data.size());
+    if (!sentBytes)
     {
-      buffer.resize(*bytesAvailable);
+      consume_error(sentBytes.take_error());
+      client.close();
+      break;
     }
 
-    auto receivedSize = client.recv(&buffer[0], buffer.size());
-    if (receivedSize)
+    std::cout << "Sent " << *sentBytes << " bytes back.\n";
+  }
+}
+
+#if defined(__linux__)
+
+///
+/// @class ReactorEchoServer
+///
+/// Waits for client readiness with a Reactor on the calling thread and posts
+/// the work of draining and echoing a ready client to a fixed-size Executor,
+/// so no worker is held by an idle client.
+///
+class ReactorEchoServer final
+{
+public:
+  ReactorEchoServer(Reactor&& reactor, Executor&& executor, Socket& listener)
+    : reactor_(std::move(reactor)), listener_(listener), executor_(std::move(executor))
+  {
+  }
+
+  // Serves clients until the last connected one has disconnected.
+  Error run()
+  {
+    if (auto e = listener_.set_nonblocking(true))
+    {
+      return e;
+    }
+
+    if (auto e = reactor_.add(listener_, Reactor::Readable,
+      [this](Reactor::EventMask) { accept_clients(); }))
     {
-      if (*receivedSize)
+      return e;
+    }
+
+    while (!done_)
+    {
+      auto dispatched = reactor_.run_once();
+      if (!dispatched)
       {
-        std::cout << "Received " << *receivedSize << " bytes: \"";
-        print_data(buffer.data(), buffer.data() + *receivedSize,
-          std::cout);
-        std::cout << "\"\n";
-        auto sentBytes =
-          client.send(buffer.data(), *receivedSize);
-        if (!sentBytes)
+        return dispatched.take_error();
+      }
+
+      close_finished();
+    }
+
+    return reactor_.remove(listener_);
+  }
+
+private:
+  struct Client
+  {
+    explicit Client(Socket&& s) : socket(std::move(s))
+    {
+    }
+
+    Socket socket;
+    // Readiness events not yet handled. A task is queued or running for the
+    // client while this is non-zero, so its socket is only read by one worker
+    // at a time.
+    std::atomic<std::size_t> pending{0};
+  };
+
+  Reactor reactor_;
+  Socket& listener_;
+  std::size_t clients_{0};
+  bool done_{false};
+  // Clients whose session ended on a worker; the Reactor isn't thread-safe,
+  // so they are removed from it and closed on the Reactor thread.
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<Client>> finished_;
+  // Last, so that it is destroyed (and its workers joined) first.
+  Executor executor_;
+
+  void accept_clients()
+  {
+    for (;;)
+    {
+      auto connection = listener_.accept();
+      if (!connection)
+      {
+        if (!connection.error_is_a<NonBlockingStatus>())
         {
-          consume_error(sentBytes.take_error());
-          client.close();
-          break;
+          handle_all_errors(connection.take_error(), reportError);
         }
 
-        std::cout << "Sent " << *sentBytes << " bytes back.\n";
+        consume_error(connection.take_error());
+        return;
       }
-      else
+
+      std::cout << "Received connection (" << to_string(connection->local()) << " <- "
+        << to_string(*connection->remote()) << ")\n";
+      auto client = std::make_shared<Client>(std::move(*connection));
+      if (auto e = client->socket.set_nonblocking(true))
       {
-        // Remote end disconnected.
-        std::cout << "Remote end disconnected.\n";
-        client.close();
-        break;
+        handle_all_errors(std::move(e), reportError);
+      }
+
+      if (auto e = reactor_.add(client->socket, Reactor::Readable,
+        [this, client](Reactor::EventMask) { on_ready(client); }))
+      {
+        handle_all_errors(std::move(e), reportError);
       }
+
+      ++clients_;
+      // Data may have arrived before the socket was registered.
+      on_ready(client);
     }
-    else
+  }
+
+  void on_ready(const std::shared_ptr<Client>& client)
+  {
+    if (client->pending.fetch_add(1) == 0)
+    {
+      executor_.post([this, client] { serve(client); });
+    }
+  }
+
+  // Runs on a worker.
+  void serve(const std::shared_ptr<Client>& client)
+  {
+    std::size_t seen = 0;
+    do
+    {
+      seen = client->pending.load();
+      if (!echo_available(client->socket))
+      {
+        // `pending` is left non-zero, so no further task is posted.
+        std::lock_guard lock(mutex_);
+        finished_.push_back(client);
+        reactor_.wake();
+        return;
+      }
+    } while (client->pending.fetch_sub(seen) != seen);
+  }
+
+  void close_finished()
+  {
+    std::vector<std::shared_ptr<Client>> finished;
+    {
+      std::lock_guard lock(mutex_);
+      finished.swap(finished_);
+    }
+
+    for (auto& client : finished)
     {
-      handle_all_errors(
-        receivedSize.take_error(), reportError);
+      consume_error(reactor_.remove(client->socket));
+      client->socket.close();
+      done_ = (--clients_ == 0);
+    }
+  }
+
+  // Echoes everything the client has sent so far. Returns false once the
+  // client has disconnected or failed.
+  static bool echo_available(Socket& client)
+  {
+    std::array<char, 16 * 1024> buffer;
+    for (;;)
+    {
+      auto received = client.recv(buffer.data(), buffer.size());
+      if (!received)
+      {
+        bool pending = received.error_is_a<NonBlockingStatus>();
+        consume_error(received.take_error());
+        return pending;
+      }
+
+      if (*received == 0)
+      {
+        std::cout << "Remote end disconnected.\n";
+        return false;
+      }
+
+      std::cout << "Received " << *received << " bytes: \"";
+      print_data(buffer.data(), buffer.data() + *received, std::cout);
+      std::cout << "\"\n";
+      // Replies are small enough to fit the send buffer; a real server would
+      // queue what can't be sent and wait for Writable.
+      auto sent = client.send(buffer.data(), *received);
+      if (!sent || *sent != *received)
+      {
+        consume_error(sent.take_error());
+        return false;
+      }
+
+      std::cout << "Sent " << *sent << " bytes back.\n";
     }
-  }                
+  }
+};
+
+// Serves TCP clients until the last connected one has disconnected.
+void serveTcpClients(Socket& server)
+{
+  auto reactor = Reactor::create();
+  if (!reactor)
+  {
+    handle_all_errors(reactor.take_error(), reportError);
+  }
+
+  auto executor = Executor::create();
+  if (!executor)
+  {
+    handle_all_errors(executor.take_error(), reportError);
+  }
+
+  ReactorEchoServer echoServer(std::move(*reactor), std::move(*executor), server);
+  if (auto e = echoServer.run())
+  {
+    handle_all_errors(std::move(e), reportError);
+  }
 }
 
-void handleTcpClient(Socket&& client)
+#else
+
+// Without a Reactor each client holds a worker for as long as it is
+// connected, so clients beyond the number of workers are turned away rather
+// than left waiting for one.
+inline constexpr std::size_t MaxClients = 64;
+
+// Serves TCP clients until the last connected one has disconnected.
+void serveTcpClients(Socket& server)
 {
-  handleClient(client);
+  Executor::Options options;
+  options.threads = MaxClients;
+  auto executor = Executor::create(options);
+  if (!executor)
+  {
+    handle_all_errors(executor.take_error(), reportError);
+  }
+
+  std::atomic<std::size_t> connections{0};
+  do
+  {
+    auto connection = server.accept();
+    if (!connection)
+    {
+      handle_all_errors(connection.take_error(), reportError);
+    }
+
+    std::cout << "Received connection (" << to_string(connection->local()) << " <- "
+      << to_string(*connection->remote()) << ")\n";
+    if (connections.load() == executor->size())
+    {
+      std::cout << "Too many clients; closing connection.\n";
+      connection->close();
+      continue;
+    }
+
+    connections.fetch_add(1);
+    auto client = std::make_shared<Socket>(std::move(*connection));
+    executor->post([client, &connections]
+      {
+        handleClient(*client);
+        connections.fetch_sub(1);
+      });
+  } while (connections.load() != 0);
 }
 
+#endif
+
 }  // namespace
 
 int main(int argc, char** argv)
@@ -129,56 +365,14 @@ int main(int argc, char** argv)
 
       if (listenEp)
       {
-        std::vector<std::future<void>> connections{};
         std::cout << "Listening on " << to_string(*listenEp) << ".\n";
-        // Run forever (until the control handler is invoked).
-        for (;;)
+        if (isUdp)
+        {
+          handleClient(server);
+        }
+        else
         {
-          auto connection = server.accept();
-          if (connection ||
-            (!connection && connection.error_is_a<UnsupportedError>() &&
-              requestedEp->transport() == Socket::Transport::Udp))
-          {
-            if (connection)
-            {
-              std::cout << "Received connection ("
-                << to_string(connection->local()) << " <- "
-                << to_string(*connection->remote()) << ")\n";
-            }
-            else
-            {
-              consume_error(connection.take_error());
-            }
-
-            if (!isUdp)
-            {
-              auto echoTask = std::async(std::launch::async,
-                handleTcpClient, std::move(*connection));
-              connections.push_back(std::move(echoTask));
-            }
-            else
-            {
-              handleClient(server);
-            }
-          }
-          else
-          {
-            handle_all_errors(connection.take_error(), reportError);
-          }
-
-          for (std::size_t i = connections.size(); i-- > 0; )
-          {
-            auto status = connections[i].wait_for(std::chrono::milliseconds(5));
-            if (status == std::future_status::ready)
-            {
-              connections.erase(connections.begin() + i);
-            }
-          }
-
-          if (connections.empty())
-          {
-            break;
-          }
+          serveTcpClients(server);
         }
       }
       else
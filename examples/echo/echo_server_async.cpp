@@ -0,0 +1,138 @@
+///
+/// @file echo_server_async.cpp
+///
+/// Example usage of the AsyncSocket class to act as an echo protocol server
+/// serving every client from a single thread with coroutines.
+///
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <span>
+#include <string_view>
+
+#include <jvs-netlib/async_socket.h>
+#include <jvs-netlib/error.h>
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/reactor.h>
+#include <jvs-netlib/socket.h>
+#include <jvs-netlib/task.h>
+
+#include "print_data.h"
+
+using namespace jvs;
+using namespace jvs::net;
+
+namespace
+{
+
+void reportError(const jvs::ErrorInfoBase& e)
+{
+  std::cout.flush();
+  e.log(std::cerr);
+  std::cerr << '\n';
+  std::exit(1);
+}
+
+// Reads like the blocking handler in echo_server.cpp, but suspends instead
+// of blocking the thread.
+Task<> handleClient(AsyncSocket client)
+{
+  std::array<std::byte, 16 * 1024> buffer;
+  for (;;)
+  {
+    auto received = co_await client.async_recv(buffer);
+    if (!received || *received == 0)
+    {
+      consume_error(received.take_error());
+      std::cout << "Remote end disconnected.\n";
+      break;
+    }
+
+    auto data = reinterpret_cast<const char*>(buffer.data());
+    std::cout << "Received " << *received << " bytes: \"";
+    print_data(data, data + *received, std::cout);
+    std::cout << "\"\n";
+    auto sent = co_await client.async_send(std::span(buffer.data(), *received));
+    if (!sent)
+    {
+      consume_error(sent.take_error());
+      break;
+    }
+
+    std::cout << "Sent " << *sent << " bytes back.\n";
+  }
+
+  client.close();
+}
+
+Task<> acceptClients(AsyncSocket& server)
+{
+  for (;;)
+  {
+    auto client = co_await server.async_accept();
+    if (!client)
+    {
+      handle_all_errors(client.take_error(), reportError);
+    }
+
+    std::cout << "Received connection (" << to_string(client->socket().local()) << " <- "
+      << to_string(*client->socket().remote()) << ")\n";
+    handleClient(std::move(*client)).detach();
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc <= 1)
+  {
+    handle_all_errors(create_string_error("Usage: ", argv[0],
+      " <local-address>:<port>\n"), reportError);
+  }
+
+  std::string_view localEpStr = argv[1];
+  auto localEp = IpEndPoint::parse(localEpStr);
+  if (!localEp)
+  {
+    handle_all_errors(
+      create_string_error("Unable to parse endpoint: ", localEpStr), reportError);
+  }
+
+  auto reactor = Reactor::create();
+  if (!reactor)
+  {
+    handle_all_errors(reactor.take_error(), reportError);
+  }
+
+  Socket listener(localEp->address().family(), Socket::Transport::Tcp);
+  auto boundEp = listener.bind(*localEp);
+  if (!boundEp)
+  {
+    handle_all_errors(boundEp.take_error(), reportError);
+  }
+
+  auto listenEp = listener.listen();
+  if (!listenEp)
+  {
+    handle_all_errors(listenEp.take_error(), reportError);
+  }
+
+  auto server = AsyncSocket::create(*reactor, std::move(listener));
+  if (!server)
+  {
+    handle_all_errors(server.take_error(), reportError);
+  }
+
+  std::cout << "Listening on " << to_string(*listenEp) << ".\n";
+  acceptClients(*server).detach();
+  // Run forever (until the control handler is invoked).
+  if (auto e = reactor->run())
+  {
+    handle_all_errors(std::move(e), reportError);
+  }
+
+  return 0;
+}
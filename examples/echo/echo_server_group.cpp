@@ -0,0 +1,108 @@
+///
+/// @file echo_server_group.cpp
+///
+/// Example usage of the ServerGroup class to act as a multi-threaded echo
+/// protocol server, with one SO_REUSEPORT listener per CPU.
+///
+
+#include <array>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+#include <pthread.h>
+
+#include <jvs-netlib/error.h>
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/reactor.h>
+#include <jvs-netlib/server_group.h>
+#include <jvs-netlib/socket.h>
+
+using namespace jvs;
+using namespace jvs::net;
+
+namespace
+{
+
+void reportError(const jvs::ErrorInfoBase& e)
+{
+  std::cout.flush();
+  e.log(std::cerr);
+  std::cerr << '\n';
+  std::exit(1);
+}
+
+bool echo(Socket& client, Reactor::EventMask /*events*/)
+{
+  std::array<char, 16 * 1024> buffer;
+  for (;;)
+  {
+    auto received = client.recv(buffer.data(), buffer.size());
+    if (!received)
+    {
+      bool pending = received.error_is_a<NonBlockingStatus>();
+      consume_error(received.take_error());
+      return pending;
+    }
+
+    if (*received == 0)
+    {
+      // Remote end disconnected.
+      return false;
+    }
+
+    // Replies are small enough to fit the send buffer; a real server would
+    // queue what can't be sent and wait for Writable.
+    auto sent = client.send(buffer.data(), *received);
+    if (!sent || *sent != *received)
+    {
+      consume_error(sent.take_error());
+      return false;
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc <= 1)
+  {
+    handle_all_errors(create_string_error("Usage: ", argv[0],
+      " <local-address>:<port> [--steer]\n"), reportError);
+  }
+
+  std::string_view localEpStr = argv[1];
+  auto localEp = IpEndPoint::parse(localEpStr);
+  if (!localEp)
+  {
+    handle_all_errors(
+      create_string_error("Unable to parse endpoint: ", localEpStr), reportError);
+  }
+
+  // Block the stop signals before the worker threads inherit the mask, so
+  // that only sigwait below receives them.
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+  ServerGroup::Options options;
+  options.cpu_steering = (argc > 2 && std::string_view(argv[2]) == "--steer");
+  auto group = ServerGroup::create(*localEp, echo, options);
+  if (!group)
+  {
+    handle_all_errors(group.take_error(), reportError);
+  }
+
+  std::cout << "Listening on " << to_string(group->local()) << " with "
+    << group->size() << " threads.\n";
+
+  // Run until interrupted.
+  int signal = 0;
+  sigwait(&signals, &signal);
+  group->stop();
+  return 0;
+}
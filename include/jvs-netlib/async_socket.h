@@ -0,0 +1,109 @@
+///
+/// @file async_socket.h
+///
+/// Contains the declarations for jvs::net::AsyncSocket, coroutine-based
+/// socket operations driven by a Reactor.
+///
+
+#if !defined(JVS_NETLIB_ASYNC_SOCKET_H_)
+#define JVS_NETLIB_ASYNC_SOCKET_H_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+
+#include "error.h"
+#include "ip_end_point.h"
+#include "reactor.h"
+#include "socket.h"
+#include "task.h"
+
+namespace jvs::net
+{
+
+///
+/// @class AsyncSocket
+///
+/// Non-blocking socket registered with a Reactor, offering awaitable
+/// operations. Each operation is attempted straight away; if it would block,
+/// the awaiting coroutine is suspended until the reactor reports readiness
+/// and is then resumed from Reactor::run_once() to try again.
+///
+/// At most one receiving operation (async_accept, async_recv) and one sending
+/// operation (async_connect, async_send) may be pending at a time. The
+/// AsyncSocket may be moved while operations are pending, but not destroyed.
+///
+class AsyncSocket final
+{
+public:
+  AsyncSocket(AsyncSocket&&) noexcept;
+  AsyncSocket& operator=(AsyncSocket&&) noexcept;
+  // Unregisters the socket from the reactor. Like ~Socket, doesn't close it.
+  ~AsyncSocket();
+
+  // Switches the socket to non-blocking mode and registers it with the
+  // reactor, which must outlive the AsyncSocket.
+  static Expected<AsyncSocket> create(Reactor& reactor, Socket&& socket) noexcept;
+
+  Socket& socket() noexcept;
+  Reactor& reactor() noexcept;
+
+  // Accepted sockets are registered with the same reactor.
+  Task<Expected<AsyncSocket>> async_accept();
+  Task<Expected<IpEndPoint>> async_connect(IpEndPoint remoteEndPoint);
+  // Like Socket::recv/send, may transfer fewer bytes than requested; a
+  // received size of 0 means the peer has closed the connection.
+  Task<Expected<std::size_t>> async_recv(std::span<std::byte> buffer);
+  Task<Expected<std::size_t>> async_send(std::span<const std::byte> buffer);
+
+  // Unregisters and closes the socket. Pending operations are resumed and
+  // fail.
+  int close() noexcept;
+
+private:
+  struct State;
+  std::shared_ptr<State> state_;
+
+  explicit AsyncSocket(std::shared_ptr<State> state) noexcept;
+};
+
+// Runs the reactor until the task has completed and returns its result.
+template <typename T>
+T sync_wait(Reactor& reactor, Task<T> task)
+{
+  bool done = false;
+  std::optional<T> result;
+  [](Task<T> awaited, bool& completed, std::optional<T>& value) -> Task<>
+  {
+    value.emplace(co_await std::move(awaited));
+    completed = true;
+  }(std::move(task), done, result).detach();
+
+  while (!done)
+  {
+    jvs::consume_error(reactor.run_once().take_error());
+  }
+
+  return std::move(*result);
+}
+
+inline void sync_wait(Reactor& reactor, Task<> task)
+{
+  bool done = false;
+  [](Task<> awaited, bool& completed) -> Task<>
+  {
+    co_await std::move(awaited);
+    completed = true;
+  }(std::move(task), done).detach();
+
+  while (!done)
+  {
+    jvs::consume_error(reactor.run_once().take_error());
+  }
+}
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_ASYNC_SOCKET_H_
@@ -0,0 +1,78 @@
+///
+/// @file buffered_reader.h
+///
+/// Contains the declarations for jvs::net::BufferedReader.
+///
+
+#if !defined(JVS_NETLIB_BUFFERED_READER_H_)
+#define JVS_NETLIB_BUFFERED_READER_H_
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "error.h"
+#include "socket.h"
+
+namespace jvs::net
+{
+
+///
+/// @class BufferedReader
+///
+/// Reads from a socket into a reusable buffer with a single recv call per
+/// refill and hands out views of the buffered data. Consumed space at the
+/// front of the buffer is reclaimed before the buffer is grown, so steady
+/// state reads don't allocate.
+///
+/// Views returned by the read functions stay valid until the next call that
+/// reads from the socket or consumes data.
+///
+class BufferedReader final
+{
+public:
+  static constexpr std::size_t DefaultCapacity = 16 * 1024;
+  // Upper limit on buffered data when searching for a delimiter.
+  static constexpr std::size_t DefaultMaxSize = 1024 * 1024;
+
+  explicit BufferedReader(Socket& s);
+  BufferedReader(Socket& s, std::size_t capacity, std::size_t maxSize);
+
+  // Data received but neither consumed nor returned by a read function.
+  std::span<const std::byte> data() const noexcept;
+  std::string_view view() const noexcept;
+  std::size_t size() const noexcept;
+  std::size_t capacity() const noexcept;
+
+  // Performs one recv call into the free space of the buffer, making room
+  // first if necessary. Returns the number of bytes received; zero means the
+  // peer closed the connection.
+  Expected<std::size_t> fill() noexcept;
+
+  void consume(std::size_t length) noexcept;
+
+  // Returns everything buffered, receiving first if nothing is. Returns an
+  // empty value once the connection has been closed.
+  Expected<std::optional<std::string_view>> read_some() noexcept;
+
+  // Returns the data up to (not including) the next `delimiter`, receiving as
+  // much as needed. Fails with EMsgSize if no delimiter is found within the
+  // maximum size, and returns an empty value if the connection is closed
+  // before one arrives.
+  Expected<std::optional<std::string_view>> read_until(char delimiter) noexcept;
+
+private:
+  Socket* socket_;
+  std::vector<std::byte> buffer_;
+  std::size_t begin_{0};
+  std::size_t end_{0};
+  // Data handed out by the previous read call, consumed on the next one.
+  std::size_t returned_{0};
+  std::size_t max_size_;
+};
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_BUFFERED_READER_H_
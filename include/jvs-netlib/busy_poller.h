@@ -0,0 +1,90 @@
+///
+/// @file busy_poller.h
+///
+/// Contains the declarations for jvs::net::BusyPoller.
+///
+
+#if !defined(JVS_NETLIB_BUSY_POLLER_H_)
+#define JVS_NETLIB_BUSY_POLLER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "error.h"
+#include "socket.h"
+
+namespace jvs::net
+{
+
+///
+/// @class BusyPoller
+///
+/// Spin-polling alternative to Reactor for latency-critical sockets: a
+/// dedicated thread, optionally pinned to a CPU, invokes the handler of every
+/// registered socket in a loop without ever sleeping. Handlers do
+/// non-blocking receives and return false to have their socket removed.
+///
+/// Sockets are set up for busy polling when added: with SO_BUSY_POLL, each
+/// non-blocking receive polls the device queue once itself instead of only
+/// looking at the socket's queue, and with SO_PREFER_BUSY_POLL the kernel
+/// defers interrupt-driven processing of the queue to these polls. The
+/// thread uses up its CPU whether or not there is traffic.
+///
+class BusyPoller final
+{
+public:
+  using Handler = std::function<bool(Socket& s)>;
+
+  struct Options
+  {
+    // CPU to pin the polling thread to; negative for no pinning.
+    int cpu{-1};
+    // SO_BUSY_POLL time for the sockets; zero leaves the option alone.
+    std::chrono::microseconds busy_poll{50};
+    // SO_PREFER_BUSY_POLL; needs CAP_NET_ADMIN.
+    bool prefer_busy_poll{false};
+    // SO_BUSY_POLL_BUDGET, the packets processed per poll; zero leaves the
+    // kernel default. Raising it needs CAP_NET_ADMIN.
+    int busy_poll_budget{0};
+  };
+
+  BusyPoller(BusyPoller&&);
+  BusyPoller& operator=(BusyPoller&&);
+  // Stops the polling thread; sockets are left open.
+  ~BusyPoller();
+
+  static Expected<BusyPoller> create() noexcept;
+  static Expected<BusyPoller> create(Options options) noexcept;
+
+  // Puts the socket in non-blocking mode, applies the busy poll options and
+  // starts invoking `handler` with it. The socket must outlive its
+  // registration. May be called from any thread.
+  Error add(Socket& s, Handler handler) noexcept;
+
+  // Stops invoking the socket's handler; when called from another thread,
+  // waits for a running invocation to return. Safe to call from inside any
+  // handler.
+  Error remove(const Socket& s) noexcept;
+
+  // Number of registered sockets.
+  std::size_t size() const noexcept;
+
+  // Number of passes over the registered sockets so far.
+  std::uint64_t sweeps() const noexcept;
+
+  // Stops the polling thread; the destructor does the same.
+  void stop() noexcept;
+
+private:
+  class BusyPollerImpl;
+  std::unique_ptr<BusyPollerImpl> impl_;
+
+  BusyPoller(BusyPollerImpl* impl);
+};
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_BUSY_POLLER_H_
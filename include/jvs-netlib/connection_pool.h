@@ -0,0 +1,108 @@
+///
+/// @file connection_pool.h
+///
+/// Contains the declarations for jvs::net::ConnectionPool.
+///
+
+#if !defined(JVS_NETLIB_CONNECTION_POOL_H_)
+#define JVS_NETLIB_CONNECTION_POOL_H_
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include "dialer.h"
+#include "error.h"
+#include "socket.h"
+#include "transport_end_point.h"
+
+namespace jvs::net
+{
+
+///
+/// @class ConnectionPool
+///
+/// Keeps idle connected sockets per remote end point so that clients which
+/// reconnect often can reuse them. Sockets are leased out by acquire() and
+/// handed back with release() (to be reused) or discard() (to be closed).
+/// Thread-safe.
+///
+class ConnectionPool final
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Options
+  {
+    // Idle sockets kept in total and per end point.
+    std::size_t max_idle{64};
+    std::size_t max_idle_per_host{8};
+    // Leased and idle sockets per end point; 0 for no limit.
+    std::size_t max_per_host{0};
+    // Idle sockets older than this are closed rather than reused.
+    std::chrono::milliseconds idle_timeout{std::chrono::seconds(60)};
+    // Used when a new TCP connection has to be established.
+    ConnectOptions connect{};
+  };
+
+  ConnectionPool() noexcept;
+  explicit ConnectionPool(Options options) noexcept;
+  ConnectionPool(const ConnectionPool&) = delete;
+  ConnectionPool& operator=(const ConnectionPool&) = delete;
+  ~ConnectionPool();
+
+  const Options& options() const noexcept;
+
+  // Leases a connected socket: the most recently released healthy idle one,
+  // or a new connection. Idle sockets which have been closed by the peer, have
+  // unread data or have timed out are closed on the way. Fails with EAgain
+  // when the end point's max_per_host limit is reached.
+  Expected<Socket> acquire(const TransportEndPoint& remote) noexcept;
+  Expected<Socket> acquire(const IpEndPoint& remote) noexcept;
+
+  // Returns a leased socket to the pool, closing it if the idle limits are
+  // reached.
+  void release(const TransportEndPoint& remote, Socket&& socket) noexcept;
+  void release(const IpEndPoint& remote, Socket&& socket) noexcept;
+
+  // Closes a leased socket which must not be reused (e.g. after an error).
+  void discard(const TransportEndPoint& remote, Socket&& socket) noexcept;
+  void discard(const IpEndPoint& remote, Socket&& socket) noexcept;
+
+  // Closes idle sockets which have timed out, returning how many were closed.
+  std::size_t prune() noexcept;
+
+  // Closes all idle sockets.
+  void clear() noexcept;
+
+  std::size_t idle_count() const noexcept;
+  std::size_t idle_count(const TransportEndPoint& remote) const noexcept;
+
+private:
+  struct Idle
+  {
+    Socket socket;
+    Clock::time_point since;
+  };
+
+  struct Host
+  {
+    // Most recently released last.
+    std::deque<Idle> idle{};
+    // Leased and idle sockets.
+    std::size_t open{0};
+  };
+
+  Options options_;
+  mutable std::mutex mutex_{};
+  std::unordered_map<TransportEndPoint, Host> hosts_{};
+  std::size_t idle_count_{0};
+
+  void release_lease(const TransportEndPoint& remote) noexcept;
+};
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_CONNECTION_POOL_H_
@@ -0,0 +1,50 @@
+///
+/// @file dialer.h
+///
+/// Contains the declarations for jvs::net::connect_any, a Happy Eyeballs
+/// (RFC 8305) TCP connection dialer.
+///
+
+#if !defined(JVS_NETLIB_DIALER_H_)
+#define JVS_NETLIB_DIALER_H_
+
+#include <chrono>
+#include <span>
+#include <vector>
+
+#include "error.h"
+#include "ip_end_point.h"
+#include "socket.h"
+
+namespace jvs::net
+{
+
+struct ConnectOptions
+{
+  // Time given to a pending attempt before the next candidate is tried in
+  // parallel (the RFC 8305 "Connection Attempt Delay").
+  std::chrono::milliseconds attempt_delay{250};
+  // Limit for the whole operation; negative to wait until every attempt has
+  // succeeded or failed.
+  std::chrono::milliseconds timeout{-1};
+  // Blocking mode of the returned socket.
+  bool nonblocking{false};
+};
+
+// Reorders the end points so that address families alternate, starting with
+// the family of the first one; the order within each family is kept.
+std::vector<IpEndPoint> interleave_families(std::span<const IpEndPoint> endPoints);
+
+// Establishes a TCP connection to the first of the end points which accepts
+// one. Candidates are tried in interleave_families order with staggered
+// non-blocking connects: a new attempt starts whenever the previous one has
+// been pending for the attempt delay or has failed, and the first connection
+// to complete wins while the others are closed. Fails with the error of the
+// last failed attempt, or ETimedOut if the timeout expires first.
+Expected<Socket> connect_any(std::span<const IpEndPoint> endPoints,
+  const ConnectOptions& options) noexcept;
+Expected<Socket> connect_any(std::span<const IpEndPoint> endPoints) noexcept;
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_DIALER_H_
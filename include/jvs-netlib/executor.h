@@ -0,0 +1,86 @@
+///
+/// @file executor.h
+///
+/// Contains the declarations for jvs::net::Executor.
+///
+
+#if !defined(JVS_NETLIB_EXECUTOR_H_)
+#define JVS_NETLIB_EXECUTOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "error.h"
+
+namespace jvs::net
+{
+
+///
+/// @class Executor
+///
+/// Fixed pool of worker threads running posted functions, such as
+/// connection handlers and completion callbacks. Each worker owns a
+/// Chase-Lev deque: functions posted from a worker go on its own deque and
+/// are run newest first, while idle workers steal the oldest ones from the
+/// others. Functions posted from any other thread (for instance a Reactor
+/// handler) go through a shared queue.
+///
+/// Functions must not throw. They may block, but a blocked function holds
+/// on to its worker.
+///
+class Executor final
+{
+public:
+  using Function = std::function<void()>;
+
+  struct Options
+  {
+    // Number of worker threads; 0 for one per hardware thread.
+    std::size_t threads{0};
+  };
+
+  struct Stats
+  {
+    // Functions posted but not yet started.
+    std::size_t queued;
+    // Functions started.
+    std::uint64_t executed;
+    // Functions a worker took from another worker's deque.
+    std::uint64_t steals;
+  };
+
+  Executor(Executor&&);
+  Executor& operator=(Executor&&);
+  // Waits for all posted functions, including those they post, to finish.
+  ~Executor();
+
+  static Expected<Executor> create() noexcept;
+  static Expected<Executor> create(Options options) noexcept;
+
+  // Queues `function` to run on one of the workers. May be called from any
+  // thread, including the workers.
+  void post(Function function);
+
+  // Number of worker threads.
+  std::size_t size() const noexcept;
+
+  // Number of functions on the deque of the given worker.
+  std::size_t queue_depth(std::size_t worker) const noexcept;
+
+  Stats stats() const noexcept;
+
+  // Whether the calling thread is one of this executor's workers.
+  bool running_in_this_thread() const noexcept;
+
+private:
+  class ExecutorImpl;
+  std::unique_ptr<ExecutorImpl> impl_;
+
+  Executor(ExecutorImpl* impl);
+};
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_EXECUTOR_H_
@@ -0,0 +1,132 @@
+///
+/// @file io_buffer.h
+///
+/// Contains the declarations for jvs::net::IoBuffer and
+/// jvs::net::SegmentPool.
+///
+
+#if !defined(JVS_NETLIB_IO_BUFFER_H_)
+#define JVS_NETLIB_IO_BUFFER_H_
+
+#include <cstddef>
+#include <deque>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "error.h"
+#include "socket.h"
+
+namespace jvs::net
+{
+
+///
+/// @class SegmentPool
+///
+/// Free list of fixed-size memory segments shared by IoBuffer objects. A pool
+/// isn't thread-safe; every buffer using it must live on the same thread.
+///
+class SegmentPool final
+{
+public:
+  static constexpr std::size_t DefaultSegmentSize = 4096;
+  // Number of free segments kept for reuse; further released segments are
+  // returned to the heap.
+  static constexpr std::size_t DefaultMaxCached = 256;
+
+  SegmentPool();
+  SegmentPool(std::size_t segmentSize, std::size_t maxCached);
+  SegmentPool(const SegmentPool&) = delete;
+  SegmentPool& operator=(const SegmentPool&) = delete;
+  ~SegmentPool();
+
+  // Pool used by buffers which aren't given one explicitly; one per thread.
+  static SegmentPool& local();
+
+  std::size_t segment_size() const noexcept;
+  // Number of free segments currently cached.
+  std::size_t cached() const noexcept;
+
+  std::byte* acquire();
+  void release(std::byte* segment) noexcept;
+
+private:
+  std::size_t segment_size_;
+  std::size_t max_cached_;
+  std::vector<std::byte*> free_{};
+};
+
+///
+/// @class IoBuffer
+///
+/// Byte queue stored as a chain of pool-backed segments, so that it never
+/// reallocates or moves data while growing. Space is reserved with prepare(),
+/// filled by the caller (e.g. through Socket::recvv) and published with
+/// commit(); published data is read through data() (e.g. with Socket::sendv)
+/// and dropped with consume(). Segments are handed back to the pool as soon
+/// as they've been consumed, and the total size can be capped to bound
+/// per-connection memory.
+///
+class IoBuffer final
+{
+public:
+  static constexpr std::size_t Unlimited = std::numeric_limits<std::size_t>::max();
+
+  IoBuffer();
+  explicit IoBuffer(std::size_t maxSize);
+  IoBuffer(SegmentPool& pool, std::size_t maxSize);
+  IoBuffer(IoBuffer&&) noexcept;
+  IoBuffer& operator=(IoBuffer&&) noexcept;
+  ~IoBuffer();
+
+  // Number of committed bytes not yet consumed.
+  std::size_t size() const noexcept;
+  bool empty() const noexcept;
+  std::size_t max_size() const noexcept;
+
+  // Reserves writable space after the committed data and returns it as
+  // consecutive spans. The space is limited by max_size(), so fewer than
+  // `length` bytes (possibly none) may be returned. Invalidated by the next
+  // call to prepare, commit or consume.
+  std::span<const std::span<std::byte>> prepare(std::size_t length);
+
+  // Makes `length` bytes of the prepared space part of the data.
+  void commit(std::size_t length) noexcept;
+
+  // Committed data as consecutive spans. Invalidated by the next call to
+  // prepare, commit or consume.
+  std::span<const std::span<const std::byte>> data();
+
+  void consume(std::size_t length) noexcept;
+  void clear() noexcept;
+
+  // Copies `bytes` into the buffer, returning the number of bytes which fit.
+  std::size_t append(std::span<const std::byte> bytes);
+
+private:
+  SegmentPool* pool_;
+  std::deque<std::byte*> segments_{};
+  // Offset of the first committed byte within segments_.front().
+  std::size_t offset_{0};
+  std::size_t size_{0};
+  std::size_t max_size_;
+  std::vector<std::span<std::byte>> prepared_{};
+  std::vector<std::span<const std::byte>> readable_{};
+
+  void release_segments() noexcept;
+  void trim_back() noexcept;
+};
+
+// Receives up to `maxLength` bytes into the buffer with a single scatter read,
+// committing whatever was received. Returns zero when the peer closed the
+// connection; fails with ENoBufs if the buffer is already at its maximum
+// size.
+Expected<std::size_t> recv(Socket& s, IoBuffer& buffer, std::size_t maxLength);
+
+// Sends as much of the buffer as a single gather write accepts, consuming
+// what was sent.
+Expected<std::size_t> send(Socket& s, IoBuffer& buffer);
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_IO_BUFFER_H_
@@ -0,0 +1,122 @@
+///
+/// @file io_uring_context.h
+///
+/// Contains the declarations for jvs::net::IoUringContext.
+///
+
+#if !defined(JVS_NETLIB_IO_URING_CONTEXT_H_)
+#define JVS_NETLIB_IO_URING_CONTEXT_H_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+
+#include "error.h"
+#include "ip_end_point.h"
+#include "socket.h"
+
+namespace jvs::net
+{
+
+///
+/// @class IoUringContext
+///
+/// Completion-based socket I/O on top of Linux io_uring. Operations are
+/// queued as submission queue entries and handed to the kernel in batches by
+/// run_once(), which also dispatches the handlers of completed operations, so
+/// the number of system calls doesn't grow with the number of operations.
+///
+/// Multishot accept and receive keep a single submission armed for any number
+/// of completions. On kernels which lack multishot support the context
+/// transparently re-arms single-shot operations instead. create() returns an
+/// UnsupportedError if the kernel can't provide io_uring at all (too old, or
+/// disabled by policy), in which case callers should fall back to Reactor.
+///
+/// Buffers and sockets passed to an operation must stay alive until its
+/// handler has run (sockets may be moved). Operations still pending when the
+/// context is destroyed are cancelled without invoking their handlers.
+///
+class IoUringContext final
+{
+public:
+  // Result of recv/send (bytes transferred) and connect/close (always 0).
+  using Handler = std::function<void(Expected<std::size_t>)>;
+  using AcceptHandler = std::function<void(Expected<Socket>)>;
+  // Multishot receive: a view of the provided buffer the data was placed in,
+  // which is handed back to the kernel once the handler returns. An empty view
+  // means the peer closed the connection.
+  using BufferHandler = std::function<void(Expected<std::span<const std::byte>>)>;
+
+  static constexpr unsigned DefaultEntries = 256;
+
+  IoUringContext(IoUringContext&&);
+  IoUringContext& operator=(IoUringContext&&);
+  ~IoUringContext();
+
+  static Expected<IoUringContext> create(unsigned entries) noexcept;
+  static Expected<IoUringContext> create() noexcept;
+
+  // Number of queued or in-flight operations.
+  std::size_t pending() const noexcept;
+
+  // Registers buffers with the kernel for recv_fixed/send_fixed, saving the
+  // page pinning and mapping otherwise done on every operation. Replaces any
+  // previous registration.
+  Error register_buffers(std::span<const std::span<std::byte>> buffers) noexcept;
+
+  // Hands `storage` to the kernel as a pool of `bufferSize`-byte buffers for
+  // recv_multishot to pick from.
+  Error provide_buffers(std::span<std::byte> storage, std::size_t bufferSize) noexcept;
+
+  Error accept(Socket& listener, AcceptHandler handler) noexcept;
+  // Invokes the handler for every accepted connection until an error occurs.
+  Error accept_multishot(Socket& listener, AcceptHandler handler) noexcept;
+
+  Error connect(Socket& s, const IpEndPoint& remoteEp, Handler handler) noexcept;
+
+  Error recv(Socket& s, std::span<std::byte> buffer, Handler handler) noexcept;
+  // `buffer` must lie within the registered buffer at `bufferIndex`.
+  Error recv_fixed(
+    Socket& s, std::size_t bufferIndex, std::span<std::byte> buffer, Handler handler) noexcept;
+  // Invokes the handler for every chunk received into a provided buffer until
+  // the peer closes the connection or an error occurs. If the pool runs out,
+  // the receive resumes once handled buffers have been handed back.
+  Error recv_multishot(Socket& s, BufferHandler handler) noexcept;
+
+  Error send(Socket& s, std::span<const std::byte> buffer, Handler handler) noexcept;
+  // `buffer` must lie within the registered buffer at `bufferIndex`.
+  Error send_fixed(Socket& s, std::size_t bufferIndex, std::span<const std::byte> buffer,
+    Handler handler) noexcept;
+
+  // Cancels every pending operation on the socket, including multishot ones.
+  // Their handlers are invoked with an ECANCELED error (or with the result,
+  // if the operation completed first); the socket stays open.
+  Error cancel(Socket& s) noexcept;
+
+  // Closes the socket asynchronously. Pending operations on the socket are
+  // cancelled first, as by cancel(); without that, multishot operations would
+  // keep the socket open. The close is only submitted once the cancel request
+  // itself has completed, not once every cancelled operation has: one already
+  // executing in the kernel's worker threads can't be cancelled and may still
+  // complete after the close, with its handler invoked as usual. The Socket
+  // object is released immediately and may be reused or destroyed.
+  Error close(Socket& s, Handler handler) noexcept;
+
+  // Submits queued operations and waits up to `timeout` (forever if negative)
+  // for at least one completion, then dispatches every available completion.
+  // Returns the number of handlers invoked.
+  Expected<std::size_t> run_once(std::chrono::milliseconds timeout) noexcept;
+  Expected<std::size_t> run_once() noexcept;
+
+private:
+  class IoUringContextImpl;
+  std::unique_ptr<IoUringContextImpl> impl_;
+
+  IoUringContext(IoUringContextImpl* impl);
+};
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_IO_URING_CONTEXT_H_
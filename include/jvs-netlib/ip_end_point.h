@@ -44,6 +44,9 @@ private:
 
 std::string to_string(const IpEndPoint& ep) noexcept;
 
+bool operator==(const IpEndPoint& a, const IpEndPoint& b) noexcept;
+bool operator!=(const IpEndPoint& a, const IpEndPoint& b) noexcept;
+
 } // namespace jvs::net
 
 namespace jvs
@@ -59,4 +62,18 @@ struct ConvertCast<net::IpEndPoint, std::string>
 
 
 
+// std namepace injection for std::hash<jvs::net::IpEndPoint>
+namespace std
+{
+
+template <>
+struct hash<jvs::net::IpEndPoint>
+{
+  std::size_t operator()(const jvs::net::IpEndPoint& ep) const noexcept;
+};
+
+} // namespace std
+
+
+
 #endif // !JVS_NETLIB_IP_END_POINT_H_
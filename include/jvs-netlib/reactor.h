@@ -0,0 +1,93 @@
+///
+/// @file reactor.h
+///
+/// Contains the declarations for jvs::net::Reactor.
+///
+
+#if !defined(JVS_NETLIB_REACTOR_H_)
+#define JVS_NETLIB_REACTOR_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+#include "error.h"
+#include "socket.h"
+
+namespace jvs::net
+{
+
+///
+/// @class Reactor
+///
+/// Single-threaded, edge-triggered readiness event loop (epoll). Descriptors
+/// are registered together with a handler which is invoked from run_once()
+/// whenever the descriptor becomes ready for any of the requested events.
+///
+/// Because notifications are edge-triggered, handlers are expected to drain
+/// the socket (recv/send/accept until a NonBlockingStatus error is returned)
+/// before returning; otherwise no further notification is delivered until new
+/// data arrives. Registered sockets should be in non-blocking mode.
+///
+class Reactor final
+{
+public:
+  using EventMask = std::uint32_t;
+  using Handler = std::function<void(EventMask)>;
+
+  // Interest/readiness flags.
+  static constexpr EventMask Readable = 1u << 0;
+  static constexpr EventMask Writable = 1u << 1;
+  // Readiness-only flags; always reported, never need to be requested.
+  static constexpr EventMask Closed = 1u << 2;
+  static constexpr EventMask Failed = 1u << 3;
+
+  Reactor(Reactor&&);
+  Reactor& operator=(Reactor&&);
+  ~Reactor();
+
+  static Expected<Reactor> create() noexcept;
+
+  // Number of currently registered descriptors.
+  std::size_t size() const noexcept;
+
+  Error add(std::intptr_t descriptor, EventMask interest, Handler handler) noexcept;
+  Error add(const Socket& s, EventMask interest, Handler handler) noexcept;
+
+  Error modify(std::intptr_t descriptor, EventMask interest) noexcept;
+  Error modify(const Socket& s, EventMask interest) noexcept;
+
+  // Unregisters the descriptor. Safe to call from inside any handler,
+  // including the handler being removed. Must be called before the
+  // descriptor is closed.
+  Error remove(std::intptr_t descriptor) noexcept;
+  Error remove(const Socket& s) noexcept;
+
+  // Waits up to `timeout` (forever if negative) for readiness and dispatches
+  // handlers. Returns the number of handlers invoked.
+  Expected<std::size_t> run_once(std::chrono::milliseconds timeout) noexcept;
+  Expected<std::size_t> run_once() noexcept;
+
+  // Dispatches events until stop() is called or an error occurs.
+  Error run() noexcept;
+
+  // Causes run() to return after the current dispatch. May be called from any
+  // thread.
+  void stop() noexcept;
+
+  // Interrupts a blocked run_once() without stopping run(). May be called from
+  // any thread.
+  void wake() noexcept;
+
+private:
+  class ReactorImpl;
+  std::unique_ptr<ReactorImpl> impl_;
+
+  Reactor(ReactorImpl* impl);
+};
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_REACTOR_H_
@@ -0,0 +1,89 @@
+///
+/// @file resolver.h
+///
+/// Contains the declarations for jvs::net::Resolver.
+///
+
+#if !defined(JVS_NETLIB_RESOLVER_H_)
+#define JVS_NETLIB_RESOLVER_H_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "error.h"
+#include "ip_address.h"
+#include "ip_end_point.h"
+#include "network_integers.h"
+
+namespace jvs::net
+{
+
+///
+/// @class Resolver
+///
+/// Non-blocking DNS stub resolver. A and AAAA queries are sent over UDP to the
+/// configured name servers from a background thread. Answers (including
+/// negative ones) are cached for their TTL, and concurrent lookups of the same
+/// name share a single query.
+///
+/// Lookups which can be answered immediately (numeric addresses, "localhost"
+/// and cached names) invoke their handler from resolve() itself. All other
+/// handlers are invoked from the resolver's thread and shouldn't block it.
+///
+class Resolver final
+{
+public:
+  using Handler = std::function<void(Expected<std::vector<IpEndPoint>>)>;
+
+  struct Options
+  {
+    // Name servers, tried in turn. When empty, the servers listed in
+    // /etc/resolv.conf are used (or 127.0.0.1 if none are listed).
+    std::vector<IpEndPoint> servers{};
+    // Time to wait for an answer before asking the next server.
+    std::chrono::milliseconds timeout{std::chrono::seconds(2)};
+    // Number of times each server is asked before a lookup fails.
+    int attempts{2};
+    // Upper limit on how long answers are cached; zero disables caching.
+    std::chrono::seconds max_ttl{std::chrono::hours(1)};
+    // How long the absence of a name (or of its addresses) is cached.
+    std::chrono::seconds negative_ttl{std::chrono::seconds(30)};
+    std::size_t max_cache_entries{4096};
+  };
+
+  Resolver(Resolver&&);
+  Resolver& operator=(Resolver&&);
+  // Stops the resolver's thread. Lookups still in progress fail with
+  // ECANCELED.
+  ~Resolver();
+
+  static Expected<Resolver> create() noexcept;
+  static Expected<Resolver> create(Options options) noexcept;
+
+  // Resolves `host` and hands its addresses, combined with `port`, to the
+  // handler; IPv6 addresses come first. Restricting `family` to IPv4 or IPv6
+  // only queries the corresponding record type. Failures are reported as
+  // AddressInfoError: EAI_NONAME if the name has no addresses, EAI_AGAIN if no
+  // server answered and EAI_FAIL if the answers couldn't be used.
+  void resolve(std::string_view host, NetworkU16 port, Handler handler);
+  void resolve(std::string_view host, NetworkU16 port, IpAddress::Family family,
+    Handler handler);
+
+  // Number of cached answers, counting A and AAAA answers separately.
+  std::size_t cached() const noexcept;
+  void clear_cache() noexcept;
+
+private:
+  class ResolverImpl;
+  std::unique_ptr<ResolverImpl> impl_;
+
+  Resolver(ResolverImpl* impl);
+};
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_RESOLVER_H_
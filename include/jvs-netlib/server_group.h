@@ -0,0 +1,87 @@
+///
+/// @file server_group.h
+///
+/// Contains the declarations for jvs::net::ServerGroup.
+///
+
+#if !defined(JVS_NETLIB_SERVER_GROUP_H_)
+#define JVS_NETLIB_SERVER_GROUP_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include "error.h"
+#include "ip_end_point.h"
+#include "reactor.h"
+#include "socket.h"
+
+namespace jvs::net
+{
+
+///
+/// @class ServerGroup
+///
+/// Multi-threaded TCP server. Each worker thread owns a listening socket
+/// bound to the same end point with SO_REUSEPORT, so that the kernel shards
+/// incoming connections among the workers, and a Reactor serving the
+/// listener and the connections it accepted. Connections never move between
+/// threads.
+///
+/// Accepted connections are non-blocking and registered for Readable and
+/// Writable events. Whenever one becomes ready, the worker's copy of the
+/// handler is invoked on that worker's thread; it must drain the socket (see
+/// Reactor) and returns false to have the connection closed.
+///
+class ServerGroup final
+{
+public:
+  using Handler = std::function<bool(Socket& connection, Reactor::EventMask events)>;
+
+  struct Options
+  {
+    // Number of worker threads; 0 for one per hardware thread.
+    std::size_t threads{0};
+    int backlog{128};
+    // Pins worker i to the i-th CPU the process may run on (modulo their
+    // number), or to CPU i with cpu_steering.
+    bool pin_threads{true};
+    // Attaches a classic BPF program (SO_ATTACH_REUSEPORT_CBPF) handing each
+    // connection received on CPU n to worker n (modulo the number of
+    // workers), instead of sharding by hash. Only useful together with
+    // pin_threads and one worker per CPU numbered 0 to threads - 1; workers
+    // whose CPU isn't available to the process aren't pinned.
+    bool cpu_steering{false};
+  };
+
+  ServerGroup(ServerGroup&&);
+  ServerGroup& operator=(ServerGroup&&);
+  // Stops the workers and closes all sockets.
+  ~ServerGroup();
+
+  static Expected<ServerGroup> create(const IpEndPoint& localEndPoint, Handler handler) noexcept;
+  static Expected<ServerGroup> create(const IpEndPoint& localEndPoint, Handler handler,
+    Options options) noexcept;
+
+  // Bound end point, with the port assigned if 0 was requested.
+  const IpEndPoint& local() const noexcept;
+
+  // Number of worker threads.
+  std::size_t size() const noexcept;
+
+  // Number of open connections across all workers.
+  std::size_t connections() const noexcept;
+
+  // Stops the workers and closes all sockets; the destructor does the same.
+  void stop() noexcept;
+
+private:
+  class ServerGroupImpl;
+  std::unique_ptr<ServerGroupImpl> impl_;
+
+  ServerGroup(ServerGroupImpl* impl);
+};
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_SERVER_GROUP_H_
@@ -5,12 +5,15 @@
 #if !defined(JVS_NETLIB_SOCKET_H_)
 #define JVS_NETLIB_SOCKET_H_
 
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <ostream>
+#include <span>
 #include <string>
+#include <type_traits>
 #include <utility>
 
 #include "error.h"
@@ -21,6 +24,18 @@
 namespace jvs::net
 {
 
+class IoUringContext;
+
+// Socket option descriptor, such as those in socket_options.h.
+template <typename T>
+concept SocketOption = requires
+{
+  { T::level } -> std::convertible_to<int>;
+  { T::name } -> std::convertible_to<int>;
+  typename T::value_type;
+  typename T::native_type;
+} && std::is_trivially_copyable_v<typename T::native_type>;
+
 ///
 /// @class Socket
 ///
@@ -36,10 +51,104 @@ public:
     Raw
   };
 
+  ///
+  /// @struct RecvSlot
+  ///
+  /// One datagram of a recv_batch call. `buffer` is supplied by the caller;
+  /// `length` and `remote` are filled in with the size and sender of the
+  /// received datagram.
+  ///
+  struct RecvSlot
+  {
+    std::span<std::byte> buffer{};
+    std::size_t length{0};
+    IpEndPoint remote{};
+  };
+
+  ///
+  /// @struct SendSlot
+  ///
+  /// One datagram of a send_batch call. `buffer` and `remote` are supplied by
+  /// the caller (an unspecified `remote` sends to the connected peer);
+  /// `length` is filled in with the number of bytes sent.
+  ///
+  struct SendSlot
+  {
+    std::span<const std::byte> buffer{};
+    std::size_t length{0};
+    IpEndPoint remote{};
+  };
+
+  ///
+  /// @struct SegmentedDatagram
+  ///
+  /// Result of recvfrom_segmented. With UDP generic receive offload enabled,
+  /// `data` may hold several datagrams from the same sender coalesced by the
+  /// kernel; each is `segment_size` bytes long except possibly the last.
+  ///
+  struct SegmentedDatagram
+  {
+    std::span<std::byte> data{};
+    std::size_t segment_size{0};
+    IpEndPoint remote{};
+
+    std::size_t segment_count() const noexcept
+    {
+      return segment_size ? (data.size() + segment_size - 1) / segment_size : 0;
+    }
+
+    std::span<std::byte> segment(std::size_t index) const noexcept
+    {
+      std::size_t offset = index * segment_size;
+      std::size_t remaining = data.size() - offset;
+      return data.subspan(offset, remaining < segment_size ? remaining : segment_size);
+    }
+  };
+
+  ///
+  /// @struct ZeroCopySend
+  ///
+  /// Result of send_zerocopy: the number of bytes sent and the ID under which
+  /// the release of the buffer will be reported by recv_zerocopy_completion.
+  ///
+  struct ZeroCopySend
+  {
+    std::size_t length{0};
+    std::uint32_t id{0};
+  };
+
+  ///
+  /// @struct ZeroCopyCompletion
+  ///
+  /// The zero-copy sends with IDs `first` through `last` (inclusive, possibly
+  /// wrapping around) no longer reference their buffers. `copied` is set when
+  /// the kernel had to copy the data after all (as it does over loopback),
+  /// which means zero-copy sends gain nothing on this path.
+  ///
+  struct ZeroCopyCompletion
+  {
+    std::uint32_t first{0};
+    std::uint32_t last{0};
+    bool copied{false};
+
+    bool contains(std::uint32_t id) const noexcept
+    {
+      return static_cast<std::uint32_t>(id - first) <= static_cast<std::uint32_t>(last - first);
+    }
+  };
+
   Socket(Socket&&);
   ~Socket();
 
   Socket(net::IpAddress::Family addressFamily, Transport transport);
+  // If the socket can't be put in non-blocking mode, it is closed, so that
+  // descriptor() is negative as when it couldn't be created.
+  Socket(net::IpAddress::Family addressFamily, Transport transport, bool nonBlocking);
+
+  // Takes ownership of an open IPv4 or IPv6 socket created elsewhere, e.g.
+  // one received from another process with UnixSocket::recv_fds. The
+  // transport, end points and non-blocking mode are queried from the socket.
+  static Expected<Socket> adopt(std::intptr_t descriptor) noexcept;
 
   // Bound/listening endpoint.
   IpEndPoint local() const noexcept;
@@ -47,7 +156,43 @@ public:
   const std::optional<IpEndPoint>& remote() const noexcept;
   // Handle/context/file descriptor of the native socket resource.
   std::intptr_t descriptor() const noexcept;
+  // Whether socket operations return a NonBlockingStatus error instead of
+  // waiting.
+  bool is_nonblocking() const noexcept;
+
+  Error set_nonblocking(bool nonBlocking) noexcept;
 
+  // Typed setsockopt/getsockopt, e.g. `set_option<sockopt::TcpNoDelay>(true)`.
+  template <SocketOption Option>
+  Error set_option(typename Option::value_type value) noexcept
+  {
+    auto native = static_cast<typename Option::native_type>(value);
+    return set_option(Option::level, Option::name, &native, sizeof(native));
+  }
+
+  template <SocketOption Option>
+  Expected<typename Option::value_type> get_option() noexcept
+  {
+    typename Option::native_type native{};
+    if (auto e = get_option(Option::level, Option::name, &native, sizeof(native)).take_error())
+    {
+      return std::move(e);
+    }
+
+    return static_cast<typename Option::value_type>(native);
+  }
+
+  // Untyped setsockopt/getsockopt for options without a descriptor. get_option
+  // returns the length of the value written to `value`.
+  Error set_option(int level, int name, const void* value, std::size_t length) noexcept;
+  Expected<std::size_t> get_option(int level, int name, void* value, std::size_t length) noexcept;
+
+  // Allows several sockets to bind the same end point (SO_REUSEPORT), with
+  // incoming connections or datagrams spread among them by the kernel. Must
+  // be set before bind on every socket of the group.
+  Error set_reuse_port(bool enabled) noexcept;
+
+  // Accepted sockets inherit the non-blocking mode of the listening socket.
   Expected<Socket> accept() noexcept;
 
   // Number of bytes available for reading from the socket.
@@ -64,6 +209,14 @@ public:
   Expected<IpEndPoint> connect(IpEndPoint remoteEndPoint) noexcept;
   Expected<IpEndPoint> connect(IpAddress remoteAddress, NetworkU16 remotePort) noexcept;
 
+  // Status of a pending non-blocking connect as reported by SO_ERROR (which
+  // is cleared by the call). Success only means that no error has occurred
+  // yet; use finish_connect() to determine if the connection is established.
+  Error connect_result() noexcept;
+  // Completes a non-blocking connect once the socket reports writability.
+  // Returns a NonBlockingStatus error if the connection is still in progress.
+  Expected<IpEndPoint> finish_connect() noexcept;
+
   Expected<IpEndPoint> listen() noexcept;
   Expected<IpEndPoint> listen(int backlog) noexcept;
 
@@ -73,6 +226,11 @@ public:
     void* buffer, std::size_t length, int flags) noexcept;
   Expected<std::pair<std::size_t, IpEndPoint>> recvfrom(void* buffer, std::size_t length) noexcept;
 
+  // Scatter read (recvmsg) into the given buffers, filled in order. At most
+  // MaxIoBuffers buffers are used per call.
+  Expected<std::size_t> recvv(std::span<const std::span<std::byte>> buffers, int flags) noexcept;
+  Expected<std::size_t> recvv(std::span<const std::span<std::byte>> buffers) noexcept;
+
   Expected<std::size_t> send(const void* buffer, std::size_t length, int flags) noexcept;
   Expected<std::size_t> send(const void* buffer, std::size_t length) noexcept;
   Expected<std::size_t> sendto(
@@ -80,15 +238,109 @@ public:
   Expected<std::size_t> sendto(
     const void* buffer, std::size_t length, const IpEndPoint& remoteEp) noexcept;
 
+  // Gather write (sendmsg) of the given buffers in a single call. At most
+  // MaxIoBuffers buffers are used per call; like send(), fewer bytes than
+  // requested may be sent.
+  Expected<std::size_t> sendv(
+    std::span<const std::span<const std::byte>> buffers, int flags) noexcept;
+  Expected<std::size_t> sendv(std::span<const std::span<const std::byte>> buffers) noexcept;
+
+  // Receives up to MaxBatchDatagrams datagrams with a single system call
+  // (recvmmsg where available), returning the number of slots filled. Waits
+  // for the first datagram only (MSG_WAITFORONE) on blocking sockets. Sender
+  // end points are only converted when `fillRemote` is set.
+  Expected<std::size_t> recv_batch(std::span<RecvSlot> slots, int flags, bool fillRemote) noexcept;
+  Expected<std::size_t> recv_batch(std::span<RecvSlot> slots, bool fillRemote) noexcept;
+  Expected<std::size_t> recv_batch(std::span<RecvSlot> slots) noexcept;
+
+  // Sends up to MaxBatchDatagrams datagrams with a single system call
+  // (sendmmsg where available), returning the number of datagrams sent.
+  Expected<std::size_t> send_batch(std::span<SendSlot> slots, int flags) noexcept;
+  Expected<std::size_t> send_batch(std::span<SendSlot> slots) noexcept;
+
+  // UDP generic segmentation offload: sends `length` bytes as consecutive
+  // datagrams of `segmentSize` bytes (the last may be shorter) with a single
+  // sendmsg call carrying a UDP_SEGMENT control message. The kernel limits
+  // the total to one maximum-sized datagram (64KiB) and 64 segments. An
+  // unspecified `remoteEp` sends to the connected peer. On Linux, kernels or
+  // devices without UDP GSO support make the call fail (typically with EINVAL
+  // or EIO) and nothing is sent; on other platforms the segments are sent one
+  // sendto call at a time instead. A segment size of 0 or above 65535 fails
+  // with EMsgSize.
+  Expected<std::size_t> sendto_segmented(const void* buffer, std::size_t length,
+    std::size_t segmentSize, int flags, const IpEndPoint& remoteEp) noexcept;
+  Expected<std::size_t> sendto_segmented(const void* buffer, std::size_t length,
+    std::size_t segmentSize, const IpEndPoint& remoteEp) noexcept;
+
+  // Enables or disables UDP generic receive offload (UDP_GRO), allowing
+  // recvfrom_segmented to return several coalesced datagrams per call.
+  Error set_udp_gro(bool enabled) noexcept;
+
+  // Receives a (possibly GRO-coalesced) datagram into `buffer`, reporting the
+  // segment size from the UDP_GRO control message. Without coalescing, the
+  // whole datagram is a single segment.
+  Expected<SegmentedDatagram> recvfrom_segmented(
+    void* buffer, std::size_t length, int flags) noexcept;
+  Expected<SegmentedDatagram> recvfrom_segmented(void* buffer, std::size_t length) noexcept;
+
+  // Enables or disables zero-copy transmission (SO_ZEROCOPY) for
+  // send_zerocopy.
+  Error set_zerocopy(bool enabled) noexcept;
+
+  // Sends from `buffer` without copying it into the kernel (MSG_ZEROCOPY),
+  // enabling SO_ZEROCOPY first if necessary. The buffer must not be modified
+  // or freed until recv_zerocopy_completion has reported the returned ID.
+  // `length` must not be zero (EINVAL). Only worthwhile for large payloads;
+  // small sends are cheaper to copy.
+  Expected<ZeroCopySend> send_zerocopy(const void* buffer, std::size_t length, int flags) noexcept;
+  Expected<ZeroCopySend> send_zerocopy(const void* buffer, std::size_t length) noexcept;
+
+  // Reads the next buffer-release notification from the socket's error
+  // queue, returning a NonBlockingStatus error if none is pending. Never
+  // waits; pending notifications make the socket report an error condition
+  // (Reactor::Failed, POLLERR), or the queue can simply be polled after
+  // sending.
+  Expected<ZeroCopyCompletion> recv_zerocopy_completion() noexcept;
+
+  // Sends up to `count` bytes of the file `fd`, starting at `offset`,
+  // directly from the page cache (sendfile) without passing through a user
+  // buffer. Like send(), fewer bytes than requested may be sent; the file
+  // position of `fd` isn't changed.
+  Expected<std::size_t> send_file(int fd, std::int64_t offset, std::size_t count) noexcept;
+
+  // Moves up to `count` bytes from the pipe `pipeFd` to the socket (splice),
+  // for relaying data between descriptors without copying it through user
+  // space.
+  Expected<std::size_t> splice_from(int pipeFd, std::size_t count) noexcept;
+
+  // Maximum number of buffers passed to the system by recvv/sendv.
+  static constexpr std::size_t MaxIoBuffers = 64;
+  // Maximum number of datagrams handled by recv_batch/send_batch per call.
+  static constexpr std::size_t MaxBatchDatagrams = 64;
+
 private:
+  friend class IoUringContext;
+
   class SocketImpl;
   std::unique_ptr<SocketImpl> impl_;
 
   Socket(SocketImpl* impl);
 };
 
+// Maximum number of bytes returned by a single read() call.
+inline constexpr std::size_t ReadChunkSize = 16 * 1024;
+
+// Receives whatever is available (up to ReadChunkSize bytes) with a single
+// recv call. Returns an empty value once the connection has been closed. See
+// BufferedReader for reading without allocating.
 Expected<std::optional<std::string>> read(Socket& s);
 Error write(Socket& s, std::string_view data);
+// Sends all of the given buffers, continuing after partial writes.
+Error write_all(Socket& s, std::span<const std::span<const std::byte>> buffers);
+// Sends `count` bytes of the file `fd` starting at `offset`, continuing after
+// partial writes. Fails with a StringError if the file ends first, after
+// sending what it holds.
+Error write_file(Socket& s, int fd, std::int64_t offset, std::size_t count);
 
 /// Socket stream-insertion operator
 //Socket& operator<<(Socket& s, const std::string& data);
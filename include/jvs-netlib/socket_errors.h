@@ -15,6 +15,14 @@
 namespace jvs::net
 {
 
+///
+/// @class SocketError
+///
+/// Error carrying a native socket error code. Unless an explicit message is
+/// given, the system description of the code is only looked up when the error
+/// is logged, so errors which are merely inspected (error_is_a, code) and then
+/// consumed never format a string.
+///
 class SocketError : public ErrorInfo<SocketError>
 {
   int code_;
@@ -30,6 +38,11 @@ public:
   virtual bool is_fatal() const override;
   int code() const noexcept;
   virtual void log(std::ostream& os) const override;
+
+protected:
+  // System description of code(); used by log() when no explicit message was
+  // given.
+  virtual std::string describe() const;
 };
 
 struct SocketErrorNonFatal : ErrorInfo<SocketErrorNonFatal, SocketError>
@@ -45,13 +58,27 @@ struct AddressInfoError : ErrorInfo<AddressInfoError, SocketError>
 {
   static char ID;
   AddressInfoError(int code);
+
+protected:
+  std::string describe() const override;
 };
 
+///
+/// @struct NonBlockingStatus
+///
+/// Returned whenever an operation on a non-blocking socket can't complete
+/// immediately (EAGAIN/EWOULDBLOCK/EINPROGRESS). This is the most common
+/// result of draining a non-blocking socket, so the payload memory is recycled
+/// through a per-thread cache instead of the global heap.
+///
 struct NonBlockingStatus final
   : ErrorInfo<NonBlockingStatus, SocketErrorNonFatal>
 {
   static char ID;
-  using Base::Base;  
+  using Base::Base;
+
+  static void* operator new(std::size_t size);
+  static void operator delete(void* p) noexcept;
 };
 
 struct UnsupportedError final : ErrorInfo<UnsupportedError, SocketError>
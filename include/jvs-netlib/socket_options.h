@@ -0,0 +1,94 @@
+///
+/// @file socket_options.h
+///
+/// Contains the socket option descriptors for Socket::set_option and
+/// Socket::get_option.
+///
+
+#if !defined(JVS_NETLIB_SOCKET_OPTIONS_H_)
+#define JVS_NETLIB_SOCKET_OPTIONS_H_
+
+#include "native_sockets.h"
+
+#if !defined(_WIN32)
+#include <netinet/tcp.h>
+#endif
+
+namespace jvs::net::sockopt
+{
+
+///
+/// @struct BasicSocketOption
+///
+/// Describes a socket option: the level and name passed to
+/// setsockopt/getsockopt, the type used by callers and the type exchanged with
+/// the system, which values are converted to and from with static_cast.
+///
+template <int Level, int Name, typename Value, typename Native = int>
+struct BasicSocketOption
+{
+  static constexpr int level = Level;
+  static constexpr int name = Name;
+  using value_type = Value;
+  using native_type = Native;
+};
+
+// Disables Nagle's algorithm.
+using TcpNoDelay = BasicSocketOption<IPPROTO_TCP, TCP_NODELAY, bool>;
+
+// Kernel buffer sizes in bytes. Linux doubles the requested size to account
+// for bookkeeping and reports the doubled value.
+using ReceiveBufferSize = BasicSocketOption<SOL_SOCKET, SO_RCVBUF, int>;
+using SendBufferSize = BasicSocketOption<SOL_SOCKET, SO_SNDBUF, int>;
+
+using ReuseAddress = BasicSocketOption<SOL_SOCKET, SO_REUSEADDR, bool>;
+
+using KeepAlive = BasicSocketOption<SOL_SOCKET, SO_KEEPALIVE, bool>;
+
+// Type of service/DSCP byte of outgoing IPv4 packets.
+using TypeOfService = BasicSocketOption<IPPROTO_IP, IP_TOS, int>;
+
+using Ipv6Only = BasicSocketOption<IPPROTO_IPV6, IPV6_V6ONLY, bool>;
+
+#if defined(SO_REUSEPORT)
+using ReusePort = BasicSocketOption<SOL_SOCKET, SO_REUSEPORT, bool>;
+#endif
+
+#if defined(TCP_FASTOPEN)
+// On a listener, the length of the queue of pending TCP Fast Open requests
+// (Linux) or whether they are accepted at all (Windows).
+using TcpFastOpen = BasicSocketOption<IPPROTO_TCP, TCP_FASTOPEN, int>;
+#endif
+
+#if defined(__linux__)
+// Sends ACKs immediately instead of delaying them. Not sticky: the kernel
+// may fall back to delayed ACKs, so it's typically set again after reads.
+using TcpQuickAck = BasicSocketOption<IPPROTO_TCP, TCP_QUICKACK, bool>;
+
+#if defined(SO_BUSY_POLL)
+// Time in microseconds to busy poll the device queue on blocking receives
+// (non-blocking receives poll it once).
+using BusyPoll = BasicSocketOption<SOL_SOCKET, SO_BUSY_POLL, int>;
+#endif
+
+#if defined(SO_PREFER_BUSY_POLL)
+// Defers interrupt-driven processing of the device queue to busy polls.
+// Enabling it needs CAP_NET_ADMIN.
+using PreferBusyPoll = BasicSocketOption<SOL_SOCKET, SO_PREFER_BUSY_POLL, bool>;
+#endif
+
+#if defined(SO_BUSY_POLL_BUDGET)
+// Maximum number of packets processed per busy poll. Raising it needs
+// CAP_NET_ADMIN.
+using BusyPollBudget = BasicSocketOption<SOL_SOCKET, SO_BUSY_POLL_BUDGET, int>;
+#endif
+
+#if defined(SO_INCOMING_CPU)
+// CPU which processed the socket's last incoming packet (-1 if none yet).
+using IncomingCpu = BasicSocketOption<SOL_SOCKET, SO_INCOMING_CPU, int>;
+#endif
+#endif
+
+} // namespace jvs::net::sockopt
+
+#endif // !JVS_NETLIB_SOCKET_OPTIONS_H_
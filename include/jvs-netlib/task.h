@@ -0,0 +1,232 @@
+///
+/// @file task.h
+///
+/// Contains the declarations for jvs::net::Task, a lazily started C++20
+/// coroutine type.
+///
+
+#if !defined(JVS_NETLIB_TASK_H_)
+#define JVS_NETLIB_TASK_H_
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace jvs::net
+{
+
+template <typename T = void>
+class Task;
+
+namespace detail
+{
+
+struct TaskPromiseBase
+{
+  // Resumed when the task completes; nothing for detached tasks.
+  std::coroutine_handle<> continuation{std::noop_coroutine()};
+  std::exception_ptr exception{};
+  bool detached{false};
+
+  struct FinalAwaiter
+  {
+    bool await_ready() const noexcept
+    {
+      return false;
+    }
+
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> coroutine) noexcept
+    {
+      auto& promise = coroutine.promise();
+      if (!promise.detached)
+      {
+        return promise.continuation;
+      }
+
+      // Like a detached std::thread, nobody is left to receive the exception.
+      if (promise.exception)
+      {
+        std::terminate();
+      }
+
+      coroutine.destroy();
+      return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+  };
+
+  std::suspend_always initial_suspend() const noexcept
+  {
+    return {};
+  }
+
+  FinalAwaiter final_suspend() const noexcept
+  {
+    return {};
+  }
+
+  void unhandled_exception() noexcept
+  {
+    exception = std::current_exception();
+  }
+};
+
+template <typename T>
+struct TaskPromise final : TaskPromiseBase
+{
+  std::optional<T> value{};
+
+  Task<T> get_return_object() noexcept;
+
+  template <typename U>
+  void return_value(U&& result)
+  {
+    value.emplace(std::forward<U>(result));
+  }
+
+  T take_result()
+  {
+    if (exception)
+    {
+      std::rethrow_exception(exception);
+    }
+
+    return std::move(*value);
+  }
+};
+
+template <>
+struct TaskPromise<void> final : TaskPromiseBase
+{
+  Task<void> get_return_object() noexcept;
+
+  void return_void() const noexcept
+  {
+  }
+
+  void take_result() const
+  {
+    if (exception)
+    {
+      std::rethrow_exception(exception);
+    }
+  }
+};
+
+} // namespace detail
+
+///
+/// @class Task
+///
+/// Coroutine producing a T. A task doesn't run until it is awaited (co_await
+/// runs it to completion, resuming the awaiting coroutine afterwards) or
+/// detached (it then runs until its first suspension straight away and frees
+/// itself when it completes).
+///
+/// Tasks have no scheduler of their own: they resume on whichever thread
+/// completes the operation they are waiting for, such as the thread running
+/// the Reactor of an AsyncSocket.
+///
+template <typename T>
+class [[nodiscard]] Task final
+{
+public:
+  using promise_type = detail::TaskPromise<T>;
+
+  Task(Task&& other) noexcept
+    : coroutine_(std::exchange(other.coroutine_, {}))
+  {
+  }
+
+  Task& operator=(Task&& other) noexcept
+  {
+    if (this != &other)
+    {
+      destroy();
+      coroutine_ = std::exchange(other.coroutine_, {});
+    }
+
+    return *this;
+  }
+
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+
+  ~Task()
+  {
+    destroy();
+  }
+
+  auto operator co_await() && noexcept
+  {
+    struct Awaiter
+    {
+      std::coroutine_handle<promise_type> coroutine;
+
+      bool await_ready() const noexcept
+      {
+        return false;
+      }
+
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+      {
+        coroutine.promise().continuation = awaiting;
+        return coroutine;
+      }
+
+      T await_resume()
+      {
+        return coroutine.promise().take_result();
+      }
+    };
+
+    return Awaiter{coroutine_};
+  }
+
+  // Starts the task without waiting for it; its result is discarded. The
+  // program is terminated if it throws.
+  void detach() &&
+  {
+    auto coroutine = std::exchange(coroutine_, {});
+    coroutine.promise().detached = true;
+    coroutine.resume();
+  }
+
+private:
+  friend promise_type;
+
+  std::coroutine_handle<promise_type> coroutine_;
+
+  explicit Task(std::coroutine_handle<promise_type> coroutine) noexcept
+    : coroutine_(coroutine)
+  {
+  }
+
+  void destroy() noexcept
+  {
+    if (coroutine_)
+    {
+      coroutine_.destroy();
+    }
+  }
+};
+
+template <typename T>
+Task<T> detail::TaskPromise<T>::get_return_object() noexcept
+{
+  return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+inline Task<void> detail::TaskPromise<void>::get_return_object() noexcept
+{
+  return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_TASK_H_
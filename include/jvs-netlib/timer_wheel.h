@@ -0,0 +1,136 @@
+///
+/// @file timer_wheel.h
+///
+/// Contains the declarations for jvs::net::TimerWheel.
+///
+
+#if !defined(JVS_NETLIB_TIMER_WHEEL_H_)
+#define JVS_NETLIB_TIMER_WHEEL_H_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace jvs::net
+{
+
+///
+/// @class TimerWheel
+///
+/// Hierarchical timing wheel for large numbers of deadlines such as connect,
+/// idle and write stall timeouts. Time is divided into ticks of a fixed
+/// resolution; levels of 64 slots each cover 64 times the span of the level
+/// below, and timers move down a level whenever the wheel reaches the start
+/// of their slot. Arming and cancelling are O(1) and don't allocate: timers
+/// are intrusive and owned by the caller.
+///
+/// Timers never fire early, and late by at most one tick. Not thread-safe;
+/// meant to be driven by the thread running an event loop:
+///
+///   reactor.run_once(wheel.timeout(Clock::now()));
+///   wheel.advance(Clock::now());
+///
+class TimerWheel final
+{
+  // Node of a circular doubly-linked list; slots are the list heads.
+  struct Link
+  {
+    Link* prev{nullptr};
+    Link* next{nullptr};
+  };
+
+public:
+  using Clock = std::chrono::steady_clock;
+
+  ///
+  /// @class Timer
+  ///
+  /// A deadline and the callback to invoke when it passes. Timers can't be
+  /// moved while armed, and are cancelled when destroyed.
+  ///
+  class Timer final : Link
+  {
+  public:
+    using Callback = std::function<void()>;
+
+    Timer() = default;
+    explicit Timer(Callback callback);
+    Timer(const Timer&) = delete;
+    Timer& operator=(const Timer&) = delete;
+    ~Timer();
+
+    // Only allowed while the timer isn't armed.
+    void set_callback(Callback callback);
+
+    bool armed() const noexcept;
+
+    // Time from which the timer may fire, rounded up to a whole tick.
+    Clock::time_point deadline() const noexcept;
+
+  private:
+    friend class TimerWheel;
+
+    TimerWheel* wheel_{nullptr};
+    std::uint64_t expiry_{0};
+    std::uint16_t slot_{0};
+    Callback callback_{};
+  };
+
+  explicit TimerWheel(Clock::duration resolution = std::chrono::milliseconds(1),
+    Clock::time_point start = Clock::now()) noexcept;
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+  // Disarms the remaining timers without invoking them.
+  ~TimerWheel();
+
+  // Arms (or re-arms) the timer to fire once `deadline` has passed. Deadlines
+  // in the past fire on the next tick.
+  void arm(Timer& timer, Clock::time_point deadline) noexcept;
+  // Arms the timer relative to the wheel's current time.
+  void arm(Timer& timer, Clock::duration delay) noexcept;
+
+  void cancel(Timer& timer) noexcept;
+
+  // Moves the wheel forward to `now`, invoking the callbacks of the timers
+  // which have expired in deadline order (by tick). Callbacks may arm and
+  // cancel any timer. Returns the number of callbacks invoked.
+  std::size_t advance(Clock::time_point now);
+
+  // Time from `now` until the wheel next needs to advance, rounded up to a
+  // millisecond, as a Reactor::run_once timeout: negative when no timer is
+  // armed.
+  std::chrono::milliseconds timeout(Clock::time_point now) const noexcept;
+
+  // Time the wheel has been advanced to.
+  Clock::time_point now() const noexcept;
+
+  Clock::duration resolution() const noexcept;
+
+  // Number of armed timers.
+  std::size_t size() const noexcept;
+
+private:
+  static constexpr unsigned SlotBits = 6;
+  static constexpr std::size_t SlotCount = std::size_t{1} << SlotBits;
+  // Enough levels for every 64-bit tick.
+  static constexpr std::size_t LevelCount = (64 + SlotBits - 1) / SlotBits;
+
+  Clock::duration resolution_;
+  Clock::time_point start_;
+  std::uint64_t current_{0};
+  std::size_t size_{0};
+  std::array<std::uint64_t, LevelCount> occupied_{};
+  std::array<Link, LevelCount * SlotCount> slots_{};
+
+  void insert(Timer& timer) noexcept;
+  void unlink(Timer& timer) noexcept;
+  void take(std::size_t slot, Link& list) noexcept;
+  std::uint64_t next_event() const noexcept;
+  std::uint64_t to_tick(Clock::time_point t, bool roundUp) const noexcept;
+};
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_TIMER_WHEEL_H_
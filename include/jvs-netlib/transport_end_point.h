@@ -56,6 +56,9 @@ private:
 
 std::string to_string(const TransportEndPoint& ep) noexcept;
 
+bool operator==(const TransportEndPoint& a, const TransportEndPoint& b) noexcept;
+bool operator!=(const TransportEndPoint& a, const TransportEndPoint& b) noexcept;
+
 } // namespace jvs::net
 
 namespace jvs
@@ -71,4 +74,18 @@ struct ConvertCast<net::TransportEndPoint, std::string>
 
 
 
+// std namepace injection for std::hash<jvs::net::TransportEndPoint>
+namespace std
+{
+
+template <>
+struct hash<jvs::net::TransportEndPoint>
+{
+  std::size_t operator()(const jvs::net::TransportEndPoint& ep) const noexcept;
+};
+
+} // namespace std
+
+
+
 #endif // !JVS_NETLIB_TRANSPORT_ENDPOINT_H_
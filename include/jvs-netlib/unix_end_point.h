@@ -0,0 +1,62 @@
+///
+/// @file unix_end_point.h
+///
+/// Contains the declarations for jvs::net::UnixEndPoint.
+///
+
+#if !defined(JVS_NETLIB_UNIX_END_POINT_H_)
+#define JVS_NETLIB_UNIX_END_POINT_H_
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "error.h"
+
+namespace jvs::net
+{
+
+///
+/// @class UnixEndPoint
+///
+/// Address of a Unix domain socket: a filesystem path, a name in the Linux
+/// abstract namespace (which needs no file and disappears with the last
+/// socket bound to it), or unnamed, as for unbound sockets and socket pairs.
+///
+class UnixEndPoint final
+{
+public:
+  // Longest path or abstract name that fits in a sockaddr_un.
+  static const std::size_t MaxNameLength;
+
+  // Unnamed end point.
+  UnixEndPoint() = default;
+
+  static Expected<UnixEndPoint> path(std::string_view path) noexcept;
+  // Only supported on Linux.
+  static Expected<UnixEndPoint> abstract(std::string_view name) noexcept;
+  // "@name" for an abstract name, anything else is a path.
+  static Expected<UnixEndPoint> parse(std::string_view unixEndPointString) noexcept;
+
+  bool is_unnamed() const noexcept;
+  bool is_abstract() const noexcept;
+
+  // Path or abstract name (without the leading NUL); empty if unnamed.
+  const std::string& name() const noexcept;
+
+private:
+  std::string name_{};
+  bool abstract_{false};
+
+  UnixEndPoint(std::string name, bool abstract) noexcept;
+};
+
+// The path, "@name" for abstract names, or an empty string if unnamed.
+std::string to_string(const UnixEndPoint& ep);
+
+bool operator==(const UnixEndPoint& a, const UnixEndPoint& b) noexcept;
+bool operator!=(const UnixEndPoint& a, const UnixEndPoint& b) noexcept;
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_UNIX_END_POINT_H_
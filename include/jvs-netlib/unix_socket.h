@@ -0,0 +1,121 @@
+///
+/// @file unix_socket.h
+///
+/// Contains the declarations for jvs::net::UnixSocket.
+///
+
+#if !defined(JVS_NETLIB_UNIX_SOCKET_H_)
+#define JVS_NETLIB_UNIX_SOCKET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "error.h"
+#include "unix_end_point.h"
+
+namespace jvs::net
+{
+
+///
+/// @class UnixSocket
+///
+/// Unix domain (AF_UNIX) socket for traffic between processes on the same
+/// host, which bypasses the TCP/IP stack, and for passing open descriptors
+/// between processes (SCM_RIGHTS). Like Socket, the native socket is only
+/// closed by close().
+///
+class UnixSocket final
+{
+public:
+  enum class Transport
+  {
+    // Byte stream, like TCP.
+    Stream,
+    // Connection-oriented and reliable, preserving message boundaries.
+    SeqPacket
+  };
+
+  ///
+  /// @struct ReceivedFds
+  ///
+  /// Result of recv_fds: the number of data bytes and of descriptors
+  /// received. `truncated` is set when more descriptors were sent than there
+  /// was room for; the kernel closes the excess ones.
+  ///
+  struct ReceivedFds
+  {
+    std::size_t length{0};
+    std::size_t fd_count{0};
+    bool truncated{false};
+  };
+
+  // Maximum number of descriptors per send_fds call (SCM_MAX_FD on Linux).
+  static constexpr std::size_t MaxFds = 253;
+
+  explicit UnixSocket(Transport transport);
+  UnixSocket(Transport transport, bool nonBlocking);
+  UnixSocket(UnixSocket&& other) noexcept;
+  UnixSocket& operator=(UnixSocket&& other) noexcept;
+  ~UnixSocket();
+
+  // Pair of connected, unnamed sockets (socketpair).
+  static Expected<std::pair<UnixSocket, UnixSocket>> pair(Transport transport) noexcept;
+  static Expected<std::pair<UnixSocket, UnixSocket>> pair(
+    Transport transport, bool nonBlocking) noexcept;
+
+  Transport transport() const noexcept;
+  // File descriptor of the native socket; negative if it couldn't be created
+  // or was closed.
+  std::intptr_t descriptor() const noexcept;
+  bool is_nonblocking() const noexcept;
+
+  Error set_nonblocking(bool nonBlocking) noexcept;
+
+  Expected<UnixEndPoint> local() const noexcept;
+  Expected<UnixEndPoint> remote() const noexcept;
+
+  // Binding to a path creates the socket file, which isn't removed on
+  // close(). An unnamed end point binds to a unique abstract name (Linux).
+  Expected<UnixEndPoint> bind(const UnixEndPoint& localEndPoint) noexcept;
+
+  Expected<UnixEndPoint> listen() noexcept;
+  Expected<UnixEndPoint> listen(int backlog) noexcept;
+
+  // Accepted sockets inherit the non-blocking mode of the listening socket.
+  Expected<UnixSocket> accept() noexcept;
+
+  Expected<UnixEndPoint> connect(const UnixEndPoint& remoteEndPoint) noexcept;
+
+  Expected<std::size_t> recv(void* buffer, std::size_t length, int flags) noexcept;
+  Expected<std::size_t> recv(void* buffer, std::size_t length) noexcept;
+
+  Expected<std::size_t> send(const void* buffer, std::size_t length, int flags) noexcept;
+  Expected<std::size_t> send(const void* buffer, std::size_t length) noexcept;
+
+  // Sends `length` bytes (at least one) together with duplicates of the
+  // descriptors `fds`, which the caller may close afterwards. The
+  // descriptors arrive with the first byte of the data.
+  Expected<std::size_t> send_fds(const void* buffer, std::size_t length,
+    std::span<const int> fds) noexcept;
+
+  // Receives data and up to `fds.size()` descriptors, which are written to
+  // the start of `fds` and are owned by the caller. Received descriptors are
+  // close-on-exec where supported. A descriptor of a TCP or UDP socket can
+  // be wrapped with Socket::adopt.
+  Expected<ReceivedFds> recv_fds(void* buffer, std::size_t length, std::span<int> fds) noexcept;
+
+  int close() noexcept;
+
+private:
+  int descriptor_{-1};
+  Transport transport_;
+  bool nonblocking_{false};
+
+  UnixSocket(int descriptor, Transport transport, bool nonBlocking) noexcept;
+};
+
+} // namespace jvs::net
+
+#endif // !JVS_NETLIB_UNIX_SOCKET_H_
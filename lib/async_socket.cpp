@@ -0,0 +1,265 @@
+///
+/// @file async_socket.cpp
+///
+/// Contains the implementation of jvs::net::AsyncSocket.
+///
+
+#include <jvs-netlib/async_socket.h>
+
+#include <coroutine>
+#include <new>
+#include <utility>
+
+#include <jvs-netlib/socket_errors.h>
+
+using namespace jvs;
+using namespace jvs::net;
+
+struct AsyncSocket::State
+{
+  Reactor* reactor;
+  Socket socket;
+  bool registered{false};
+  // Coroutines waiting for readiness.
+  std::coroutine_handle<> reader{};
+  std::coroutine_handle<> writer{};
+
+  State(Reactor& r, Socket&& s) noexcept
+    : reactor(&r), socket(std::move(s))
+  {
+  }
+
+  // Suspends the awaiting coroutine until `waiter` is resumed.
+  struct ReadyAwaiter
+  {
+    std::coroutine_handle<>& waiter;
+
+    bool await_ready() const noexcept
+    {
+      return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> coroutine) noexcept
+    {
+      waiter = coroutine;
+    }
+
+    void await_resume() const noexcept
+    {
+    }
+  };
+
+  ReadyAwaiter readable() noexcept
+  {
+    return {reader};
+  }
+
+  ReadyAwaiter writable() noexcept
+  {
+    return {writer};
+  }
+
+  void resume(Reactor::EventMask events) noexcept
+  {
+    constexpr Reactor::EventMask Broken = Reactor::Closed | Reactor::Failed;
+    if ((events & (Reactor::Readable | Broken)) != 0 && reader)
+    {
+      std::exchange(reader, {}).resume();
+    }
+
+    if ((events & (Reactor::Writable | Broken)) != 0 && writer)
+    {
+      std::exchange(writer, {}).resume();
+    }
+  }
+
+  void unregister() noexcept
+  {
+    if (registered)
+    {
+      jvs::consume_error(reactor->remove(socket));
+      registered = false;
+    }
+  }
+};
+
+namespace
+{
+
+// Whether a failed operation should be retried once the socket is ready.
+template <typename T>
+bool would_block(Expected<T>& result) noexcept
+{
+  if (result || !result.template error_is_a<NonBlockingStatus>())
+  {
+    return false;
+  }
+
+  jvs::consume_error(result.take_error());
+  return true;
+}
+
+} // namespace
+
+AsyncSocket::AsyncSocket(std::shared_ptr<State> state) noexcept
+  : state_(std::move(state))
+{
+}
+
+AsyncSocket::AsyncSocket(AsyncSocket&&) noexcept = default;
+
+AsyncSocket& AsyncSocket::operator=(AsyncSocket&& other) noexcept
+{
+  if (this != &other)
+  {
+    if (state_)
+    {
+      state_->unregister();
+    }
+
+    state_ = std::move(other.state_);
+  }
+
+  return *this;
+}
+
+AsyncSocket::~AsyncSocket()
+{
+  if (state_)
+  {
+    state_->unregister();
+  }
+}
+
+Expected<AsyncSocket> AsyncSocket::create(Reactor& reactor, Socket&& socket) noexcept
+{
+  if (!socket.is_nonblocking())
+  {
+    if (auto e = socket.set_nonblocking(true))
+    {
+      return std::move(e);
+    }
+  }
+
+  std::shared_ptr<State> state;
+  try
+  {
+    state = std::make_shared<State>(reactor, std::move(socket));
+  }
+  catch (const std::bad_alloc&)
+  {
+    return make_error<SocketError>(errcodes::ENoBufs);
+  }
+
+  // Registered once for both directions, edge-triggered, so that waiting
+  // costs no epoll_ctl calls. The handler keeps the state alive while it
+  // resumes coroutines, which may close the socket.
+  auto e = reactor.add(state->socket, Reactor::Readable | Reactor::Writable,
+    [state](Reactor::EventMask events)
+    {
+      auto keepAlive = state;
+      keepAlive->resume(events);
+    });
+  if (e)
+  {
+    return std::move(e);
+  }
+
+  state->registered = true;
+  return AsyncSocket(std::move(state));
+}
+
+Socket& AsyncSocket::socket() noexcept
+{
+  return state_->socket;
+}
+
+Reactor& AsyncSocket::reactor() noexcept
+{
+  return *state_->reactor;
+}
+
+// The operations hold on to the state rather than the AsyncSocket, which may
+// be moved while they are suspended.
+
+Task<Expected<AsyncSocket>> AsyncSocket::async_accept()
+{
+  return [](std::shared_ptr<State> state) -> Task<Expected<AsyncSocket>>
+  {
+    for (;;)
+    {
+      auto accepted = state->socket.accept();
+      if (!would_block(accepted))
+      {
+        if (!accepted)
+        {
+          co_return accepted.take_error();
+        }
+
+        co_return create(*state->reactor, std::move(*accepted));
+      }
+
+      co_await state->readable();
+    }
+  }(state_);
+}
+
+Task<Expected<IpEndPoint>> AsyncSocket::async_connect(IpEndPoint remoteEndPoint)
+{
+  return [](std::shared_ptr<State> state, IpEndPoint remote) -> Task<Expected<IpEndPoint>>
+  {
+    auto connected = state->socket.connect(remote);
+    while (would_block(connected))
+    {
+      co_await state->writable();
+      connected = state->socket.finish_connect();
+    }
+
+    co_return std::move(connected);
+  }(state_, remoteEndPoint);
+}
+
+Task<Expected<std::size_t>> AsyncSocket::async_recv(std::span<std::byte> buffer)
+{
+  return [](std::shared_ptr<State> state, std::span<std::byte> data) -> Task<Expected<std::size_t>>
+  {
+    for (;;)
+    {
+      auto received = state->socket.recv(data.data(), data.size());
+      if (!would_block(received))
+      {
+        co_return std::move(received);
+      }
+
+      co_await state->readable();
+    }
+  }(state_, buffer);
+}
+
+Task<Expected<std::size_t>> AsyncSocket::async_send(std::span<const std::byte> buffer)
+{
+  return [](std::shared_ptr<State> state, std::span<const std::byte> data)
+    -> Task<Expected<std::size_t>>
+  {
+    for (;;)
+    {
+      auto sent = state->socket.send(data.data(), data.size());
+      if (!would_block(sent))
+      {
+        co_return std::move(sent);
+      }
+
+      co_await state->writable();
+    }
+  }(state_, buffer);
+}
+
+int AsyncSocket::close() noexcept
+{
+  auto state = state_;
+  state->unregister();
+  int result = state->socket.close();
+  // Let pending operations fail on the closed socket.
+  state->resume(Reactor::Failed);
+  return result;
+}
@@ -0,0 +1,110 @@
+///
+/// @file block_cache.h
+///
+/// Per-thread free list of fixed-size memory blocks, used to back
+/// class-specific operator new/delete for objects which are created and
+/// destroyed at a high rate.
+///
+
+#if !defined(JVS_NETLIB_BLOCK_CACHE_H_)
+#define JVS_NETLIB_BLOCK_CACHE_H_
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+
+namespace jvs
+{
+
+///
+/// @class BlockCache
+///
+/// Blocks are handed out from (and returned to) a cache owned by the calling
+/// thread, so no synchronization is needed. A block freed on a thread other
+/// than the one which allocated it simply migrates to the freeing thread's
+/// cache. At most MaxCachedBlocks blocks are retained per thread; anything
+/// beyond that is returned to the global heap.
+///
+template <std::size_t BlockSize, std::size_t MaxCachedBlocks = 64>
+class BlockCache final
+{
+public:
+  static_assert(BlockSize > 0);
+
+  static void* allocate(std::size_t size)
+  {
+    assert(size <= BlockSize && "Allocation doesn't fit in a cached block");
+    auto& cache = thread_cache();
+    if (auto* block = cache.head)
+    {
+      cache.head = block->next;
+      --cache.count;
+      return block;
+    }
+
+    return ::operator new(Size);
+  }
+
+  static void deallocate(void* p) noexcept
+  {
+    if (!p)
+    {
+      return;
+    }
+
+    auto& cache = thread_cache();
+    if (cache.count >= MaxCachedBlocks)
+    {
+      ::operator delete(p);
+      return;
+    }
+
+    auto* block = static_cast<FreeBlock*>(p);
+    block->next = cache.head;
+    cache.head = block;
+    ++cache.count;
+  }
+
+  // Number of blocks currently cached by the calling thread.
+  static std::size_t cached() noexcept
+  {
+    return thread_cache().count;
+  }
+
+private:
+  struct FreeBlock
+  {
+    FreeBlock* next;
+  };
+
+  static constexpr std::size_t Size =
+    (BlockSize < sizeof(FreeBlock)) ? sizeof(FreeBlock) : BlockSize;
+
+  struct Cache
+  {
+    FreeBlock* head{nullptr};
+    std::size_t count{0};
+
+    ~Cache()
+    {
+      while (head)
+      {
+        auto* next = head->next;
+        ::operator delete(head);
+        head = next;
+      }
+
+      count = 0;
+    }
+  };
+
+  static Cache& thread_cache() noexcept
+  {
+    thread_local Cache cache{};
+    return cache;
+  }
+};
+
+} // namespace jvs
+
+#endif // !JVS_NETLIB_BLOCK_CACHE_H_
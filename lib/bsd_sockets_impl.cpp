@@ -1,14 +1,40 @@
 #include "bsd_sockets_impl.h"
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <cstring>
+#include <limits>
 
+#include <fcntl.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include "native_sockets.h"
 
+#if defined(__linux__)
+#include <netinet/udp.h>
+#if !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
+#if !defined(UDP_GRO)
+#define UDP_GRO 104
+#endif
+#include <linux/errqueue.h>
+#include <sys/sendfile.h>
+#if !defined(SO_ZEROCOPY)
+#define SO_ZEROCOPY 60
+#endif
+#if !defined(MSG_ZEROCOPY)
+#define MSG_ZEROCOPY 0x4000000
+#endif
+#endif
+
 #include <jvs-netlib/socket.h>
 #include <jvs-netlib/socket_errors.h>
+#include <jvs-netlib/socket_options.h>
 
 #include "socket_impl.h"
+#include "socket_types.h"
 #include "utils.h"
 
 using namespace jvs::net;
@@ -16,6 +42,25 @@ using namespace jvs::net::errcodes;
 using Family = IpAddress::Family;
 using Transport = Socket::Transport;
 
+namespace
+{
+
+template <typename ByteT>
+std::size_t fill_io_vectors(std::array<iovec, Socket::MaxIoBuffers>& vectors,
+  std::span<const std::span<ByteT>> buffers) noexcept
+{
+  std::size_t count = std::min(buffers.size(), vectors.size());
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    vectors[i].iov_base = const_cast<std::byte*>(buffers[i].data());
+    vectors[i].iov_len = buffers[i].size();
+  }
+
+  return count;
+}
+
+} // namespace
+
 Socket::SocketImpl::SocketImpl() = default;
 
 Socket::SocketImpl::SocketImpl(SocketContext ctx)
@@ -23,6 +68,12 @@ Socket::SocketImpl::SocketImpl(SocketContext ctx)
 {
 }
 
+Socket::SocketImpl::SocketImpl(SocketContext ctx, const SocketInfo& listenerInfo)
+  : socket_info_(ctx, listenerInfo),
+  local_pending_(listenerInfo.has_wildcard_address())
+{
+}
+
 Socket::SocketImpl::SocketImpl(Family addressFamily, Transport transport)
 {
   if (auto si = create_socket(addressFamily, transport))
@@ -37,10 +88,16 @@ Socket::SocketImpl::SocketImpl(Family addressFamily, Transport transport)
 
 Socket::SocketImpl::~SocketImpl() = default;
 
-const std::optional<IpEndPoint>& Socket::SocketImpl::local_endpoint()
-  const noexcept
+SocketContext Socket::SocketImpl::release() noexcept
 {
-  return local_endpoint_;
+  auto ctx = socket_info_.context();
+  socket_info_.reset();
+  remote_endpoint_.reset();
+  local_pending_ = false;
+  nonblocking_ = false;
+  zerocopy_ = false;
+  next_zerocopy_id_ = 0;
+  return ctx;
 }
 
 const std::optional<IpEndPoint>& Socket::SocketImpl::remote_endpoint()
@@ -64,6 +121,23 @@ std::string jvs::net::get_addrinfo_error_message(int ecode) noexcept
   return gai_strerror(ecode);
 }
 
+int jvs::net::set_socket_nonblocking(SocketContext s, bool nonBlocking) noexcept
+{
+  int flags = ::fcntl(s, F_GETFL, 0);
+  if (is_error_result(flags))
+  {
+    return flags;
+  }
+
+  int newFlags = nonBlocking ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+  if (newFlags == flags)
+  {
+    return 0;
+  }
+
+  return ::fcntl(s, F_SETFL, newFlags);
+}
+
 // BSD API-specific Socket member implementations
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -89,9 +163,362 @@ jvs::Expected<std::size_t> Socket::available() noexcept
 // function.
 int Socket::close() noexcept
 {
-  int closeResult = ::close(impl_->socket_info_.context());
-  impl_->socket_info_.reset();
-  impl_->local_endpoint_.reset();
-  impl_->remote_endpoint_.reset();
-  return closeResult;
+  return ::close(impl_->release());
+}
+
+jvs::Expected<std::size_t> Socket::recvv(
+  std::span<const std::span<std::byte>> buffers, int flags) noexcept
+{
+  std::array<iovec, MaxIoBuffers> vectors;
+  msghdr message{};
+  message.msg_iov = vectors.data();
+  message.msg_iovlen = fill_io_vectors(vectors, buffers);
+  auto receivedSize =
+    static_cast<std::size_t>(::recvmsg(impl_->socket_info_.context(), &message, flags));
+  if (is_error_result(receivedSize))
+  {
+    return jvs::net::create_socket_error(impl_->socket_info_.context());
+  }
+
+  return receivedSize;
+}
+
+jvs::Expected<std::size_t> Socket::sendv(
+  std::span<const std::span<const std::byte>> buffers, int flags) noexcept
+{
+  std::array<iovec, MaxIoBuffers> vectors;
+  msghdr message{};
+  message.msg_iov = vectors.data();
+  message.msg_iovlen = fill_io_vectors(vectors, buffers);
+  auto sentSize =
+    static_cast<std::size_t>(::sendmsg(impl_->socket_info_.context(), &message, flags));
+  if (is_error_result(sentSize))
+  {
+    return jvs::net::create_socket_error(impl_->socket_info_.context());
+  }
+
+  return sentSize;
+}
+
+jvs::Error Socket::set_reuse_port(bool enabled) noexcept
+{
+  return set_option<sockopt::ReusePort>(enabled);
+}
+
+#if defined(__linux__)
+
+jvs::Expected<std::size_t> Socket::recv_batch(
+  std::span<RecvSlot> slots, int flags, bool fillRemote) noexcept
+{
+  std::size_t count = std::min(slots.size(), MaxBatchDatagrams);
+  std::array<mmsghdr, MaxBatchDatagrams> messages;
+  std::array<iovec, MaxBatchDatagrams> vectors;
+  std::array<sockaddr_storage, MaxBatchDatagrams> addresses;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    vectors[i].iov_base = slots[i].buffer.data();
+    vectors[i].iov_len = slots[i].buffer.size();
+    messages[i] = {};
+    messages[i].msg_hdr.msg_iov = &vectors[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+    if (fillRemote)
+    {
+      messages[i].msg_hdr.msg_name = &addresses[i];
+      messages[i].msg_hdr.msg_namelen = static_cast<socklen_t>(sizeof(addresses[i]));
+    }
+  }
+
+  int receivedCount = ::recvmmsg(impl_->socket_info_.context(), messages.data(),
+    static_cast<unsigned int>(count), flags | MSG_WAITFORONE, /*timeout*/ nullptr);
+  if (is_error_result(receivedCount))
+  {
+    return jvs::net::create_socket_error(impl_->socket_info_.context());
+  }
+
+  for (int i = 0; i < receivedCount; ++i)
+  {
+    slots[i].length = messages[i].msg_len;
+    slots[i].remote = IpEndPoint {};
+    if (fillRemote && messages[i].msg_hdr.msg_namelen != 0)
+    {
+      if (auto remoteEndpoint = jvs::convert_to<IpEndPoint>(addresses[i]))
+      {
+        slots[i].remote = *remoteEndpoint;
+        impl_->remote_endpoint_ = *remoteEndpoint;
+      }
+      else
+      {
+        jvs::consume_error(remoteEndpoint.take_error());
+      }
+    }
+  }
+
+  return static_cast<std::size_t>(receivedCount);
+}
+
+jvs::Expected<std::size_t> Socket::send_batch(std::span<SendSlot> slots, int flags) noexcept
+{
+  std::size_t count = std::min(slots.size(), MaxBatchDatagrams);
+  std::array<mmsghdr, MaxBatchDatagrams> messages;
+  std::array<iovec, MaxBatchDatagrams> vectors;
+  std::array<sockaddr_storage, MaxBatchDatagrams> addresses;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    vectors[i].iov_base = const_cast<std::byte*>(slots[i].buffer.data());
+    vectors[i].iov_len = slots[i].buffer.size();
+    messages[i] = {};
+    messages[i].msg_hdr.msg_iov = &vectors[i];
+    messages[i].msg_hdr.msg_iovlen = 1;
+    // Unspecified destinations go to the connected peer.
+    if (slots[i].remote.address().family() != Family::Unspecified)
+    {
+      addresses[i] = jvs::convert_to<sockaddr>(slots[i].remote);
+      messages[i].msg_hdr.msg_name = &addresses[i];
+      messages[i].msg_hdr.msg_namelen = get_address_length(slots[i].remote);
+    }
+  }
+
+  int sentCount = ::sendmmsg(impl_->socket_info_.context(), messages.data(),
+    static_cast<unsigned int>(count), flags);
+  if (is_error_result(sentCount))
+  {
+    return jvs::net::create_socket_error(impl_->socket_info_.context());
+  }
+
+  for (int i = 0; i < sentCount; ++i)
+  {
+    slots[i].length = messages[i].msg_len;
+  }
+
+  return static_cast<std::size_t>(sentCount);
 }
+
+jvs::Expected<std::size_t> Socket::sendto_segmented(const void* buffer, std::size_t length,
+  std::size_t segmentSize, int flags, const IpEndPoint& remoteEp) noexcept
+{
+  // UDP_SEGMENT takes a 16-bit size, where 0 would disable segmentation.
+  if (segmentSize == 0 || segmentSize > std::numeric_limits<std::uint16_t>::max())
+  {
+    return jvs::net::create_socket_error(errcodes::EMsgSize);
+  }
+
+  iovec vector{const_cast<void*>(buffer), length};
+  msghdr message{};
+  message.msg_iov = &vector;
+  message.msg_iovlen = 1;
+
+  sockaddr_storage remoteInfo;
+  if (remoteEp.address().family() != Family::Unspecified)
+  {
+    remoteInfo = jvs::convert_to<sockaddr>(remoteEp);
+    message.msg_name = &remoteInfo;
+    message.msg_namelen = get_address_length(remoteEp);
+  }
+
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(std::uint16_t))]{};
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  cmsghdr* header = CMSG_FIRSTHDR(&message);
+  header->cmsg_level = SOL_UDP;
+  header->cmsg_type = UDP_SEGMENT;
+  header->cmsg_len = CMSG_LEN(sizeof(std::uint16_t));
+  auto segmentSize16 = static_cast<std::uint16_t>(segmentSize);
+  std::memcpy(CMSG_DATA(header), &segmentSize16, sizeof(segmentSize16));
+
+  auto sentSize =
+    static_cast<std::size_t>(::sendmsg(impl_->socket_info_.context(), &message, flags));
+  if (is_error_result(sentSize))
+  {
+    return jvs::net::create_socket_error(impl_->socket_info_.context());
+  }
+
+  return sentSize;
+}
+
+jvs::Error Socket::set_udp_gro(bool enabled) noexcept
+{
+  int value = enabled ? 1 : 0;
+  if (is_error_result(::setsockopt(
+    impl_->socket_info_.context(), SOL_UDP, UDP_GRO, &value, sizeof(value))))
+  {
+    return jvs::net::create_socket_error(get_last_error());
+  }
+
+  return jvs::Error::success();
+}
+
+jvs::Expected<Socket::SegmentedDatagram> Socket::recvfrom_segmented(
+  void* buffer, std::size_t length, int flags) noexcept
+{
+  iovec vector{buffer, length};
+  sockaddr_storage remoteInfo{};
+  msghdr message{};
+  message.msg_name = &remoteInfo;
+  message.msg_namelen = static_cast<socklen_t>(sizeof(remoteInfo));
+  message.msg_iov = &vector;
+  message.msg_iovlen = 1;
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))]{};
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+
+  auto receivedSize =
+    static_cast<std::size_t>(::recvmsg(impl_->socket_info_.context(), &message, flags));
+  if (is_error_result(receivedSize))
+  {
+    return jvs::net::create_socket_error(impl_->socket_info_.context());
+  }
+
+  SegmentedDatagram datagram{};
+  datagram.data = std::span(static_cast<std::byte*>(buffer), std::min(receivedSize, length));
+  datagram.segment_size = datagram.data.size();
+  for (cmsghdr* header = CMSG_FIRSTHDR(&message); header;
+    header = CMSG_NXTHDR(&message, header))
+  {
+    if (header->cmsg_level == SOL_UDP && header->cmsg_type == UDP_GRO)
+    {
+      int segmentSize = 0;
+      std::memcpy(&segmentSize, CMSG_DATA(header), sizeof(segmentSize));
+      if (segmentSize > 0)
+      {
+        datagram.segment_size = static_cast<std::size_t>(segmentSize);
+      }
+    }
+  }
+
+  if (message.msg_namelen != 0)
+  {
+    auto remoteEndpoint = jvs::convert_to<IpEndPoint>(remoteInfo);
+    if (!remoteEndpoint)
+    {
+      return remoteEndpoint.take_error();
+    }
+
+    impl_->remote_endpoint_ = *remoteEndpoint;
+    datagram.remote = *remoteEndpoint;
+  }
+
+  return datagram;
+}
+
+jvs::Error Socket::set_zerocopy(bool enabled) noexcept
+{
+  int value = enabled ? 1 : 0;
+  if (is_error_result(::setsockopt(
+    impl_->socket_info_.context(), SOL_SOCKET, SO_ZEROCOPY, &value, sizeof(value))))
+  {
+    int ecode = get_last_error();
+    // Kernels before 4.14 don't know the option at all.
+    if (ecode == ENoProtoOpt)
+    {
+      return jvs::make_error<UnsupportedError>(ecode);
+    }
+
+    return jvs::net::create_socket_error(ecode);
+  }
+
+  impl_->zerocopy_ = enabled;
+  return jvs::Error::success();
+}
+
+jvs::Expected<Socket::ZeroCopySend> Socket::send_zerocopy(
+  const void* buffer, std::size_t length, int flags) noexcept
+{
+  // The kernel doesn't number empty sends, so one would throw every later ID
+  // off by one.
+  if (length == 0)
+  {
+    return jvs::net::create_socket_error(EINVAL);
+  }
+
+  if (!impl_->zerocopy_)
+  {
+    if (auto e = set_zerocopy(true))
+    {
+      return std::move(e);
+    }
+  }
+
+  auto sentSize = static_cast<std::size_t>(
+    ::send(impl_->socket_info_.context(), buffer, length, flags | MSG_ZEROCOPY));
+  if (is_error_result(sentSize))
+  {
+    return jvs::net::create_socket_error(impl_->socket_info_.context());
+  }
+
+  // The kernel only numbers calls which succeeded.
+  return ZeroCopySend{sentSize, impl_->next_zerocopy_id_++};
+}
+
+jvs::Expected<Socket::ZeroCopyCompletion> Socket::recv_zerocopy_completion() noexcept
+{
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_in6))]{};
+  msghdr message{};
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  // Reading the error queue never blocks.
+  if (is_error_result(::recvmsg(impl_->socket_info_.context(), &message, MSG_ERRQUEUE)))
+  {
+    return jvs::net::create_socket_error(get_last_error());
+  }
+
+  for (cmsghdr* header = CMSG_FIRSTHDR(&message); header;
+    header = CMSG_NXTHDR(&message, header))
+  {
+    bool isRecvErr = (header->cmsg_level == SOL_IP && header->cmsg_type == IP_RECVERR) ||
+      (header->cmsg_level == SOL_IPV6 && header->cmsg_type == IPV6_RECVERR);
+    if (!isRecvErr)
+    {
+      continue;
+    }
+
+    sock_extended_err ee;
+    std::memcpy(&ee, CMSG_DATA(header), sizeof(ee));
+    if (ee.ee_origin != SO_EE_ORIGIN_ZEROCOPY)
+    {
+      // Some other queued error (e.g. ICMP); hand it to the caller.
+      return jvs::net::create_socket_error(static_cast<int>(ee.ee_errno));
+    }
+
+    ZeroCopyCompletion completion{};
+    completion.first = ee.ee_info;
+    completion.last = ee.ee_data;
+    completion.copied = (ee.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0;
+    return completion;
+  }
+
+  return jvs::net::create_socket_error(EAgain);
+}
+
+jvs::Expected<std::size_t> Socket::send_file(
+  int fd, std::int64_t offset, std::size_t count) noexcept
+{
+  off_t fileOffset = static_cast<off_t>(offset);
+  auto sentSize =
+    static_cast<std::size_t>(::sendfile(impl_->socket_info_.context(), fd, &fileOffset, count));
+  if (is_error_result(sentSize))
+  {
+    return jvs::net::create_socket_error(impl_->socket_info_.context());
+  }
+
+  return sentSize;
+}
+
+jvs::Expected<std::size_t> Socket::splice_from(int pipeFd, std::size_t count) noexcept
+{
+  unsigned flags = SPLICE_F_MOVE;
+  if (impl_->nonblocking_)
+  {
+    flags |= SPLICE_F_NONBLOCK;
+  }
+
+  auto splicedSize = static_cast<std::size_t>(
+    ::splice(pipeFd, nullptr, impl_->socket_info_.context(), nullptr, count, flags));
+  if (is_error_result(splicedSize))
+  {
+    return jvs::net::create_socket_error(impl_->socket_info_.context());
+  }
+
+  return splicedSize;
+}
+
+#endif // __linux__
@@ -8,6 +8,8 @@
 #if !defined(JVS_NETLIB_BSD_SOCKETS_IMPL_H_)
 #define JVS_NETLIB_BSD_SOCKETS_IMPL_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 
 #include <jvs-netlib/ip_end_point.h>
@@ -23,21 +25,40 @@ class Socket::SocketImpl final
 public:
   SocketImpl();
   SocketImpl(SocketContext ctx);
+  // Implementation of a socket accepted from a listener with the given info.
+  // Nothing is queried from the native socket.
+  SocketImpl(SocketContext ctx, const SocketInfo& listenerInfo);
   SocketImpl(IpAddress::Family addressFamily, Socket::Transport transport);  
   ~SocketImpl();
 
-  const std::optional<IpEndPoint>& local_endpoint() const noexcept;
+  // Allocated from a per-thread cache; see socket.cpp.
+  static void* operator new(std::size_t size);
+  static void operator delete(void* p) noexcept;
+
+  // The local end point is kept in socket_info_ rather than duplicated here,
+  // and is only queried from the native socket on first use after the
+  // kernel may have assigned it (connect, accept from a wildcard listener).
+  IpEndPoint local_endpoint() noexcept;
   const std::optional<IpEndPoint>& remote_endpoint() const noexcept;
 
   bool update_local_endpoint() noexcept;
   bool update_remote_endpoint() noexcept;
 
+  // Resets the implementation to the closed state without closing the native
+  // socket, which is returned.
+  SocketContext release() noexcept;
+
 private:
   friend class Socket;
+  friend class IoUringContext;
 
   SocketInfo socket_info_{};
-  std::optional<IpEndPoint> local_endpoint_{};
   std::optional<IpEndPoint> remote_endpoint_{};
+  bool local_pending_{false};
+  bool nonblocking_{false};
+  bool zerocopy_{false};
+  // ID the kernel will assign to the next successful zero-copy send.
+  std::uint32_t next_zerocopy_id_{0};
 };
 
 } // namespace jvs::net
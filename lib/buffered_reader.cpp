@@ -0,0 +1,142 @@
+///
+/// @file buffered_reader.cpp
+///
+/// Contains the implementation of jvs::net::BufferedReader.
+///
+
+#include <jvs-netlib/buffered_reader.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <jvs-netlib/socket_errors.h>
+
+#include "socket_impl.h"
+
+using namespace jvs;
+using namespace jvs::net;
+
+BufferedReader::BufferedReader(Socket& s)
+  : BufferedReader(s, DefaultCapacity, DefaultMaxSize)
+{
+}
+
+BufferedReader::BufferedReader(Socket& s, std::size_t capacity, std::size_t maxSize)
+  : socket_(&s),
+  buffer_(std::max<std::size_t>(capacity, 1)),
+  max_size_(maxSize)
+{
+}
+
+std::span<const std::byte> BufferedReader::data() const noexcept
+{
+  return std::span<const std::byte>(buffer_.data() + begin_ + returned_, size());
+}
+
+std::string_view BufferedReader::view() const noexcept
+{
+  return std::string_view(
+    reinterpret_cast<const char*>(buffer_.data() + begin_ + returned_), size());
+}
+
+std::size_t BufferedReader::size() const noexcept
+{
+  return end_ - begin_ - returned_;
+}
+
+std::size_t BufferedReader::capacity() const noexcept
+{
+  return buffer_.size();
+}
+
+void BufferedReader::consume(std::size_t length) noexcept
+{
+  begin_ += returned_ + std::min(length, size());
+  returned_ = 0;
+  if (begin_ == end_)
+  {
+    begin_ = end_ = 0;
+  }
+}
+
+Expected<std::size_t> BufferedReader::fill() noexcept
+{
+  consume(0);
+  if (end_ == buffer_.size())
+  {
+    if (begin_ > 0)
+    {
+      // Reclaim the consumed space instead of growing.
+      std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+      end_ -= begin_;
+      begin_ = 0;
+    }
+    else
+    {
+      buffer_.resize(buffer_.size() * 2);
+    }
+  }
+
+  auto received = socket_->recv(buffer_.data() + end_, buffer_.size() - end_);
+  if (received)
+  {
+    end_ += *received;
+  }
+
+  return received;
+}
+
+Expected<std::optional<std::string_view>> BufferedReader::read_some() noexcept
+{
+  consume(0);
+  if (size() == 0)
+  {
+    auto received = fill();
+    if (auto e = received.take_error())
+    {
+      return std::move(e);
+    }
+
+    if (*received == 0)
+    {
+      return std::nullopt;
+    }
+  }
+
+  auto buffered = view();
+  returned_ = buffered.size();
+  return buffered;
+}
+
+Expected<std::optional<std::string_view>> BufferedReader::read_until(char delimiter) noexcept
+{
+  consume(0);
+  std::size_t scanned = 0;
+  for (;;)
+  {
+    auto buffered = view();
+    auto position = buffered.find(delimiter, scanned);
+    if (position != std::string_view::npos)
+    {
+      returned_ = position + 1;
+      return buffered.substr(0, position);
+    }
+
+    scanned = buffered.size();
+    if (scanned >= max_size_)
+    {
+      return create_socket_error(errcodes::EMsgSize);
+    }
+
+    auto received = fill();
+    if (auto e = received.take_error())
+    {
+      return std::move(e);
+    }
+
+    if (*received == 0)
+    {
+      return std::nullopt;
+    }
+  }
+}
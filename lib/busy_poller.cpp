@@ -0,0 +1,360 @@
+///
+/// @file busy_poller.cpp
+///
+/// Contains the implementation of jvs::net::BusyPoller.
+///
+
+#include <jvs-netlib/busy_poller.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <jvs-netlib/socket_errors.h>
+#include <jvs-netlib/socket_options.h>
+
+#include "socket_impl.h"
+
+using namespace jvs;
+using namespace jvs::net;
+
+namespace
+{
+
+// Lets a sibling hyperthread run while the poller spins.
+inline void cpu_relax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+Error apply_busy_poll_options(Socket& s, const BusyPoller::Options& options) noexcept
+{
+  if (options.busy_poll.count() > 0)
+  {
+#if defined(SO_BUSY_POLL)
+    if (auto e = s.set_option<sockopt::BusyPoll>(static_cast<int>(options.busy_poll.count())))
+    {
+      return e;
+    }
+#else
+    return create_socket_error(errcodes::EOpNotSupp);
+#endif
+  }
+
+  if (options.prefer_busy_poll)
+  {
+#if defined(SO_PREFER_BUSY_POLL)
+    if (auto e = s.set_option<sockopt::PreferBusyPoll>(true))
+    {
+      return e;
+    }
+#else
+    return create_socket_error(errcodes::EOpNotSupp);
+#endif
+  }
+
+  if (options.busy_poll_budget > 0)
+  {
+#if defined(SO_BUSY_POLL_BUDGET)
+    if (auto e = s.set_option<sockopt::BusyPollBudget>(options.busy_poll_budget))
+    {
+      return e;
+    }
+#else
+    return create_socket_error(errcodes::EOpNotSupp);
+#endif
+  }
+
+  return Error::success();
+}
+
+} // namespace
+
+class BusyPoller::BusyPollerImpl final
+{
+public:
+  struct Registration
+  {
+    Socket* socket;
+    Handler handler;
+    // Set by remove(), so that the rest of a sweep skips the registration.
+    std::atomic<bool> removed{false};
+
+    Registration(Socket& s, Handler h) : socket(&s), handler(std::move(h))
+    {
+    }
+  };
+
+  explicit BusyPollerImpl(const Options& options) : options_(options)
+  {
+  }
+
+  ~BusyPollerImpl()
+  {
+    stop();
+  }
+
+  Error start()
+  {
+    if (options_.cpu >= CPU_SETSIZE)
+    {
+      return create_socket_error(EINVAL);
+    }
+
+    try
+    {
+      thread_ = std::thread([this] { run(); });
+    }
+    catch (const std::system_error& e)
+    {
+      return make_error<SocketError>(e.code().value());
+    }
+
+    if (options_.cpu >= 0)
+    {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(options_.cpu, &set);
+      int result = ::pthread_setaffinity_np(thread_.native_handle(), sizeof(set), &set);
+      if (result != 0)
+      {
+        return create_socket_error(result);
+      }
+    }
+
+    return Error::success();
+  }
+
+  Error add(Socket& s, Handler handler)
+  {
+    if (s.descriptor() < 0)
+    {
+      return create_socket_error(EBADF);
+    }
+
+    if (!s.is_nonblocking())
+    {
+      if (auto e = s.set_nonblocking(true))
+      {
+        return e;
+      }
+    }
+
+    if (auto e = apply_busy_poll_options(s, options_))
+    {
+      return e;
+    }
+
+    {
+      std::lock_guard lock(mutex_);
+      if (find(s.descriptor()) != registrations_.end())
+      {
+        return create_socket_error(EEXIST);
+      }
+
+      registrations_.push_back(std::make_shared<Registration>(s, std::move(handler)));
+      version_.fetch_add(1, std::memory_order_release);
+    }
+
+    return Error::success();
+  }
+
+  Error remove(std::intptr_t descriptor) noexcept
+  {
+    std::uint64_t version = 0;
+    {
+      std::lock_guard lock(mutex_);
+      auto registration = find(descriptor);
+      if (registration == registrations_.end())
+      {
+        return create_socket_error(ENOENT);
+      }
+
+      (*registration)->removed.store(true, std::memory_order_relaxed);
+      registrations_.erase(registration);
+      version = version_.fetch_add(1, std::memory_order_release) + 1;
+    }
+
+    // The poller picks up changes between sweeps, so once it has seen this
+    // one, no invocation of the handler is running or will start.
+    if (thread_.joinable() && std::this_thread::get_id() != thread_.get_id())
+    {
+      while (seen_version_.load(std::memory_order_acquire) < version &&
+        !stopped_.load(std::memory_order_acquire))
+      {
+        std::this_thread::yield();
+      }
+    }
+
+    return Error::success();
+  }
+
+  std::size_t size() const noexcept
+  {
+    std::lock_guard lock(mutex_);
+    return registrations_.size();
+  }
+
+  std::uint64_t sweeps() const noexcept
+  {
+    return sweeps_.load(std::memory_order_relaxed);
+  }
+
+  void stop() noexcept
+  {
+    stop_requested_.store(true, std::memory_order_release);
+    if (thread_.joinable() && std::this_thread::get_id() != thread_.get_id())
+    {
+      thread_.join();
+    }
+  }
+
+private:
+  Options options_;
+  mutable std::mutex mutex_{};
+  // Guarded by mutex_; the poller works on a copy.
+  std::vector<std::shared_ptr<Registration>> registrations_{};
+  // Bumped on every change to registrations_, and acknowledged by the poller
+  // when it has copied them.
+  std::atomic<std::uint64_t> version_{0};
+  std::atomic<std::uint64_t> seen_version_{0};
+  std::atomic<std::uint64_t> sweeps_{0};
+  std::atomic<bool> stop_requested_{false};
+  std::atomic<bool> stopped_{false};
+  std::thread thread_{};
+
+  std::vector<std::shared_ptr<Registration>>::iterator find(std::intptr_t descriptor) noexcept
+  {
+    return std::find_if(registrations_.begin(), registrations_.end(),
+      [descriptor](auto& r) { return r->socket->descriptor() == descriptor; });
+  }
+
+  // Drops the registration; only called on the poller thread, so no handler
+  // invocation is running concurrently.
+  void erase(const std::shared_ptr<Registration>& registration) noexcept
+  {
+    std::lock_guard lock(mutex_);
+    auto found = std::find(registrations_.begin(), registrations_.end(), registration);
+    if (found != registrations_.end())
+    {
+      registration->removed.store(true, std::memory_order_relaxed);
+      registrations_.erase(found);
+      version_.fetch_add(1, std::memory_order_release);
+    }
+  }
+
+  void run() noexcept
+  {
+    std::vector<std::shared_ptr<Registration>> sweep;
+    std::uint64_t seen = 0;
+    while (!stop_requested_.load(std::memory_order_acquire))
+    {
+      auto version = version_.load(std::memory_order_acquire);
+      if (version != seen)
+      {
+        {
+          std::lock_guard lock(mutex_);
+          sweep = registrations_;
+          version = version_.load(std::memory_order_relaxed);
+        }
+
+        seen = version;
+        seen_version_.store(version, std::memory_order_release);
+      }
+
+      for (auto& registration : sweep)
+      {
+        if (!registration->removed.load(std::memory_order_relaxed) &&
+          !registration->handler(*registration->socket))
+        {
+          // Not looked up by descriptor: the handler may have closed the
+          // socket before returning.
+          erase(registration);
+        }
+      }
+
+      sweeps_.fetch_add(1, std::memory_order_relaxed);
+      cpu_relax();
+    }
+
+    stopped_.store(true, std::memory_order_release);
+  }
+};
+
+BusyPoller::BusyPoller(BusyPoller&&) = default;
+
+BusyPoller& BusyPoller::operator=(BusyPoller&&) = default;
+
+BusyPoller::BusyPoller(BusyPollerImpl* impl) : impl_(impl)
+{
+}
+
+BusyPoller::~BusyPoller() = default;
+
+Expected<BusyPoller> BusyPoller::create() noexcept
+{
+  return create(Options{});
+}
+
+Expected<BusyPoller> BusyPoller::create(Options options) noexcept
+{
+  try
+  {
+    BusyPoller poller(new BusyPollerImpl(options));
+    if (auto e = poller.impl_->start())
+    {
+      return std::move(e);
+    }
+
+    return poller;
+  }
+  catch (const std::bad_alloc&)
+  {
+    return make_error<SocketError>(errcodes::ENoBufs);
+  }
+}
+
+Error BusyPoller::add(Socket& s, Handler handler) noexcept
+{
+  try
+  {
+    return impl_->add(s, std::move(handler));
+  }
+  catch (const std::bad_alloc&)
+  {
+    return make_error<SocketError>(errcodes::ENoBufs);
+  }
+}
+
+Error BusyPoller::remove(const Socket& s) noexcept
+{
+  return impl_->remove(s.descriptor());
+}
+
+std::size_t BusyPoller::size() const noexcept
+{
+  return impl_->size();
+}
+
+std::uint64_t BusyPoller::sweeps() const noexcept
+{
+  return impl_->sweeps();
+}
+
+void BusyPoller::stop() noexcept
+{
+  impl_->stop();
+}
@@ -0,0 +1,265 @@
+///
+/// @file connection_pool.cpp
+///
+/// Contains the implementation of jvs::net::ConnectionPool.
+///
+
+#include <jvs-netlib/connection_pool.h>
+
+#include <iterator>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "native_sockets.h"
+
+#if !defined(_WIN32)
+#include <poll.h>
+#endif
+
+#include <jvs-netlib/socket_errors.h>
+
+#include "socket_impl.h"
+
+using namespace jvs;
+using namespace jvs::net;
+
+namespace
+{
+
+// An idle connection is healthy if nothing can be read from it: readable means
+// the peer has closed it, it has failed, or there is stray data which would be
+// mistaken for the next response.
+bool is_healthy(Socket& socket) noexcept
+{
+  pollfd fd{static_cast<decltype(pollfd::fd)>(socket.descriptor()), POLLIN, 0};
+#if defined(_WIN32)
+  int ready = ::WSAPoll(&fd, 1, 0);
+#else
+  int ready = ::poll(&fd, 1, 0);
+#endif
+  return ready == 0;
+}
+
+void close_all(std::vector<Socket>& sockets) noexcept
+{
+  for (auto& s : sockets)
+  {
+    s.close();
+  }
+}
+
+} // namespace
+
+ConnectionPool::ConnectionPool() noexcept
+  : ConnectionPool(Options{})
+{
+}
+
+ConnectionPool::ConnectionPool(Options options) noexcept
+  : options_(std::move(options))
+{
+}
+
+ConnectionPool::~ConnectionPool()
+{
+  clear();
+}
+
+const ConnectionPool::Options& ConnectionPool::options() const noexcept
+{
+  return options_;
+}
+
+Expected<Socket> ConnectionPool::acquire(const TransportEndPoint& remote) noexcept
+{
+  for (;;)
+  {
+    std::vector<Socket> expired;
+    std::optional<Socket> candidate;
+    bool limited = false;
+    {
+      std::lock_guard lock(mutex_);
+      auto& host = hosts_[remote];
+      auto oldest = Clock::now() - options_.idle_timeout;
+      while (!host.idle.empty() && host.idle.front().since <= oldest)
+      {
+        expired.push_back(std::move(host.idle.front().socket));
+        host.idle.pop_front();
+        --host.open;
+        --idle_count_;
+      }
+
+      if (!host.idle.empty())
+      {
+        candidate.emplace(std::move(host.idle.back().socket));
+        host.idle.pop_back();
+        --idle_count_;
+      }
+      else if (options_.max_per_host != 0 && host.open >= options_.max_per_host)
+      {
+        limited = true;
+      }
+      else
+      {
+        // Reserve the slot for the new connection.
+        ++host.open;
+      }
+    }
+
+    close_all(expired);
+    if (limited)
+    {
+      return create_socket_error(errcodes::EAgain);
+    }
+
+    if (!candidate)
+    {
+      break;
+    }
+
+    // Checked outside the lock; another idle socket is tried if this one has
+    // gone bad.
+    if (is_healthy(*candidate))
+    {
+      return std::move(*candidate);
+    }
+
+    discard(remote, std::move(*candidate));
+  }
+
+  if (remote.transport() == Socket::Transport::Tcp)
+  {
+    auto connected = connect_any(std::span(&remote.ip_end_point(), 1), options_.connect);
+    if (!connected)
+    {
+      release_lease(remote);
+    }
+
+    return connected;
+  }
+
+  Socket socket(remote.address().family(), remote.transport());
+  auto connected = socket.connect(remote.ip_end_point());
+  Error e = connected
+    ? socket.set_nonblocking(options_.connect.nonblocking)
+    : connected.take_error();
+  if (e)
+  {
+    socket.close();
+    release_lease(remote);
+    return std::move(e);
+  }
+
+  return std::move(socket);
+}
+
+Expected<Socket> ConnectionPool::acquire(const IpEndPoint& remote) noexcept
+{
+  return acquire(TransportEndPoint(remote, Socket::Transport::Tcp));
+}
+
+void ConnectionPool::release(const TransportEndPoint& remote, Socket&& socket) noexcept
+{
+  {
+    std::lock_guard lock(mutex_);
+    auto host = hosts_.find(remote);
+    if (host != hosts_.end() && host->second.idle.size() < options_.max_idle_per_host &&
+      idle_count_ < options_.max_idle)
+    {
+      host->second.idle.push_back(Idle{std::move(socket), Clock::now()});
+      ++idle_count_;
+      return;
+    }
+  }
+
+  discard(remote, std::move(socket));
+}
+
+void ConnectionPool::release(const IpEndPoint& remote, Socket&& socket) noexcept
+{
+  release(TransportEndPoint(remote, Socket::Transport::Tcp), std::move(socket));
+}
+
+void ConnectionPool::discard(const TransportEndPoint& remote, Socket&& socket) noexcept
+{
+  Socket(std::move(socket)).close();
+  release_lease(remote);
+}
+
+void ConnectionPool::discard(const IpEndPoint& remote, Socket&& socket) noexcept
+{
+  discard(TransportEndPoint(remote, Socket::Transport::Tcp), std::move(socket));
+}
+
+std::size_t ConnectionPool::prune() noexcept
+{
+  std::vector<Socket> expired;
+  {
+    std::lock_guard lock(mutex_);
+    auto oldest = Clock::now() - options_.idle_timeout;
+    for (auto host = hosts_.begin(); host != hosts_.end();)
+    {
+      auto& idle = host->second.idle;
+      while (!idle.empty() && idle.front().since <= oldest)
+      {
+        expired.push_back(std::move(idle.front().socket));
+        idle.pop_front();
+        --host->second.open;
+        --idle_count_;
+      }
+
+      host = (host->second.open == 0) ? hosts_.erase(host) : std::next(host);
+    }
+  }
+
+  close_all(expired);
+  return expired.size();
+}
+
+void ConnectionPool::clear() noexcept
+{
+  std::vector<Socket> idle;
+  {
+    std::lock_guard lock(mutex_);
+    for (auto host = hosts_.begin(); host != hosts_.end();)
+    {
+      for (auto& entry : host->second.idle)
+      {
+        idle.push_back(std::move(entry.socket));
+      }
+
+      host->second.open -= host->second.idle.size();
+      host->second.idle.clear();
+      host = (host->second.open == 0) ? hosts_.erase(host) : std::next(host);
+    }
+
+    idle_count_ = 0;
+  }
+
+  close_all(idle);
+}
+
+std::size_t ConnectionPool::idle_count() const noexcept
+{
+  std::lock_guard lock(mutex_);
+  return idle_count_;
+}
+
+std::size_t ConnectionPool::idle_count(const TransportEndPoint& remote) const noexcept
+{
+  std::lock_guard lock(mutex_);
+  auto host = hosts_.find(remote);
+  return (host == hosts_.end()) ? 0 : host->second.idle.size();
+}
+
+void ConnectionPool::release_lease(const TransportEndPoint& remote) noexcept
+{
+  std::lock_guard lock(mutex_);
+  auto host = hosts_.find(remote);
+  if (host != hosts_.end() && host->second.open != 0 && --host->second.open == 0)
+  {
+    hosts_.erase(host);
+  }
+}
@@ -0,0 +1,226 @@
+///
+/// @file dialer.cpp
+///
+/// Contains the implementation of jvs::net::connect_any.
+///
+
+#include <jvs-netlib/dialer.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "native_sockets.h"
+
+#if !defined(_WIN32)
+#include <poll.h>
+#endif
+
+#include <jvs-netlib/socket_errors.h>
+
+#include "socket_impl.h"
+
+using namespace jvs;
+using namespace jvs::net;
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+
+int poll_sockets(std::vector<pollfd>& fds, int timeoutMs) noexcept
+{
+#if defined(_WIN32)
+  return ::WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), timeoutMs);
+#else
+  return ::poll(fds.data(), static_cast<nfds_t>(fds.size()), timeoutMs);
+#endif
+}
+
+} // namespace
+
+std::vector<IpEndPoint> jvs::net::interleave_families(std::span<const IpEndPoint> endPoints)
+{
+  std::vector<IpEndPoint> result;
+  result.reserve(endPoints.size());
+  if (endPoints.empty())
+  {
+    return result;
+  }
+
+  auto firstFamily = endPoints.front().address().family();
+  std::vector<IpEndPoint> preferred;
+  std::vector<IpEndPoint> other;
+  for (auto& ep : endPoints)
+  {
+    (ep.address().family() == firstFamily ? preferred : other).push_back(ep);
+  }
+
+  for (std::size_t i = 0; i < std::max(preferred.size(), other.size()); ++i)
+  {
+    if (i < preferred.size())
+    {
+      result.push_back(preferred[i]);
+    }
+
+    if (i < other.size())
+    {
+      result.push_back(other[i]);
+    }
+  }
+
+  return result;
+}
+
+Expected<Socket> jvs::net::connect_any(std::span<const IpEndPoint> endPoints,
+  const ConnectOptions& options) noexcept
+{
+  if (endPoints.empty())
+  {
+    return create_socket_error(errcodes::EDestAddrReq);
+  }
+
+  auto candidates = interleave_families(endPoints);
+  auto now = Clock::now();
+  auto deadline = (options.timeout.count() < 0) ? Clock::time_point::max() : now + options.timeout;
+  auto nextStart = now;
+  std::size_t next = 0;
+  std::vector<Socket> pending;
+  std::vector<pollfd> fds;
+  std::optional<Socket> winner;
+  Error lastError = Error::success();
+  auto fail = [&](Socket& attempt, Error e)
+  {
+    attempt.close();
+    jvs::consume_error(std::move(lastError));
+    lastError = std::move(e);
+    // A failure lets the next candidate start straight away.
+    nextStart = Clock::now();
+  };
+
+  while (!winner)
+  {
+    now = Clock::now();
+    if (now >= deadline)
+    {
+      jvs::consume_error(std::move(lastError));
+      lastError = create_socket_error(errcodes::ETimedOut);
+      break;
+    }
+
+    if (next < candidates.size() && (pending.empty() || now >= nextStart))
+    {
+      auto& ep = candidates[next];
+      ++next;
+      Socket attempt(ep.address().family(), Socket::Transport::Tcp, /*nonBlocking*/ true);
+      if (attempt.descriptor() < 0)
+      {
+        fail(attempt, create_socket_error(errcodes::EAFNoSupport));
+        continue;
+      }
+
+      auto connected = attempt.connect(ep);
+      if (connected)
+      {
+        winner.emplace(std::move(attempt));
+        break;
+      }
+
+      if (connected.error_is_a<NonBlockingStatus>())
+      {
+        jvs::consume_error(connected.take_error());
+        pending.push_back(std::move(attempt));
+        nextStart = now + options.attempt_delay;
+      }
+      else
+      {
+        fail(attempt, connected.take_error());
+      }
+
+      continue;
+    }
+
+    if (pending.empty())
+    {
+      break;
+    }
+
+    auto wakeAt = (next < candidates.size()) ? std::min(nextStart, deadline) : deadline;
+    int timeoutMs = -1;
+    if (wakeAt != Clock::time_point::max())
+    {
+      timeoutMs = static_cast<int>(std::max<std::int64_t>(
+        std::chrono::ceil<std::chrono::milliseconds>(wakeAt - now).count(), 0));
+    }
+
+    fds.clear();
+    for (auto& attempt : pending)
+    {
+      fds.push_back(pollfd{static_cast<decltype(pollfd::fd)>(attempt.descriptor()), POLLOUT, 0});
+    }
+
+    if (poll_sockets(fds, timeoutMs) < 0)
+    {
+      jvs::consume_error(std::move(lastError));
+      lastError = create_socket_error(get_last_error());
+      break;
+    }
+
+    // Completed attempts are settled in candidate order, so that the
+    // preferred one wins if several complete at once.
+    std::vector<Socket> stillPending;
+    for (std::size_t i = 0; i < pending.size(); ++i)
+    {
+      if (winner || fds[i].revents == 0)
+      {
+        stillPending.push_back(std::move(pending[i]));
+        continue;
+      }
+
+      auto finished = pending[i].finish_connect();
+      if (finished)
+      {
+        winner.emplace(std::move(pending[i]));
+      }
+      else if (finished.error_is_a<NonBlockingStatus>())
+      {
+        jvs::consume_error(finished.take_error());
+        stillPending.push_back(std::move(pending[i]));
+      }
+      else
+      {
+        fail(pending[i], finished.take_error());
+      }
+    }
+
+    pending = std::move(stillPending);
+  }
+
+  for (auto& attempt : pending)
+  {
+    attempt.close();
+  }
+
+  if (!winner)
+  {
+    return std::move(lastError);
+  }
+
+  jvs::consume_error(std::move(lastError));
+  if (!options.nonblocking)
+  {
+    if (auto e = winner->set_nonblocking(false))
+    {
+      winner->close();
+      return std::move(e);
+    }
+  }
+
+  return std::move(*winner);
+}
+
+Expected<Socket> jvs::net::connect_any(std::span<const IpEndPoint> endPoints) noexcept
+{
+  return connect_any(endPoints, ConnectOptions{});
+}
@@ -0,0 +1,359 @@
+///
+/// @file epoll_reactor.cpp
+///
+/// Contains the epoll-based implementation of jvs::net::Reactor.
+///
+
+#include <jvs-netlib/reactor.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <jvs-netlib/socket_errors.h>
+
+#include "socket_impl.h"
+
+using namespace jvs;
+using namespace jvs::net;
+
+namespace
+{
+
+// Maximum number of events collected by a single epoll_wait call.
+inline constexpr int MaxEventsPerWait = 256;
+
+// epoll user data value identifying the wake-up eventfd.
+inline constexpr std::uint64_t WakeToken = ~static_cast<std::uint64_t>(0);
+
+std::uint32_t to_epoll_events(Reactor::EventMask interest) noexcept
+{
+  std::uint32_t events = EPOLLET | EPOLLRDHUP;
+  if (interest & Reactor::Readable)
+  {
+    events |= EPOLLIN;
+  }
+
+  if (interest & Reactor::Writable)
+  {
+    events |= EPOLLOUT;
+  }
+
+  return events;
+}
+
+Reactor::EventMask from_epoll_events(std::uint32_t events) noexcept
+{
+  Reactor::EventMask result = 0;
+  if (events & (EPOLLIN | EPOLLPRI))
+  {
+    result |= Reactor::Readable;
+  }
+
+  if (events & EPOLLOUT)
+  {
+    result |= Reactor::Writable;
+  }
+
+  if (events & (EPOLLHUP | EPOLLRDHUP))
+  {
+    result |= Reactor::Closed;
+  }
+
+  if (events & EPOLLERR)
+  {
+    result |= Reactor::Failed;
+  }
+
+  return result;
+}
+
+// The descriptor is packed into the low half of the epoll user data and a
+// registration generation into the high half, so that events queued for a
+// descriptor which was removed (and possibly re-added) during the same
+// dispatch pass can be recognized as stale.
+std::uint64_t make_token(int fd, std::uint32_t generation) noexcept
+{
+  return (static_cast<std::uint64_t>(generation) << 32) | static_cast<std::uint32_t>(fd);
+}
+
+int token_descriptor(std::uint64_t token) noexcept
+{
+  return static_cast<int>(token & 0xffffffffu);
+}
+
+std::uint32_t token_generation(std::uint64_t token) noexcept
+{
+  return static_cast<std::uint32_t>(token >> 32);
+}
+
+} // namespace
+
+class Reactor::ReactorImpl final
+{
+public:
+  struct Registration
+  {
+    Handler handler;
+    EventMask interest{0};
+    std::uint32_t generation{0};
+  };
+
+  ReactorImpl(int epollFd, int wakeFd) : epoll_fd_(epollFd), wake_fd_(wakeFd)
+  {
+  }
+
+  ~ReactorImpl()
+  {
+    ::close(wake_fd_);
+    ::close(epoll_fd_);
+  }
+
+  Registration* find(int fd) const noexcept
+  {
+    if (fd < 0 || static_cast<std::size_t>(fd) >= registrations_.size())
+    {
+      return nullptr;
+    }
+
+    return registrations_[fd].get();
+  }
+
+  int epoll_fd_;
+  int wake_fd_;
+  std::vector<std::unique_ptr<Registration>> registrations_{};
+  // Registrations removed while dispatching; destroyed after the pass so that
+  // a handler can safely remove itself.
+  std::vector<std::unique_ptr<Registration>> retired_{};
+  std::size_t count_{0};
+  std::uint32_t next_generation_{0};
+  bool dispatching_{false};
+  std::atomic<bool> stop_requested_{false};
+};
+
+Reactor::Reactor(Reactor&&) = default;
+
+Reactor& Reactor::operator=(Reactor&&) = default;
+
+Reactor::Reactor(ReactorImpl* impl) : impl_(impl)
+{
+}
+
+Reactor::~Reactor() = default;
+
+Expected<Reactor> Reactor::create() noexcept
+{
+  int epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+  if (is_error_result(epollFd))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  int wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (is_error_result(wakeFd))
+  {
+    int ecode = get_last_error();
+    ::close(epollFd);
+    return create_socket_error(ecode);
+  }
+
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.u64 = WakeToken;
+  if (is_error_result(::epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &ev)))
+  {
+    int ecode = get_last_error();
+    ::close(wakeFd);
+    ::close(epollFd);
+    return create_socket_error(ecode);
+  }
+
+  return Reactor(new ReactorImpl(epollFd, wakeFd));
+}
+
+std::size_t Reactor::size() const noexcept
+{
+  return impl_->count_;
+}
+
+Error Reactor::add(std::intptr_t descriptor, EventMask interest, Handler handler) noexcept
+{
+  int fd = static_cast<int>(descriptor);
+  if (fd < 0)
+  {
+    return create_socket_error(EBADF);
+  }
+
+  if (impl_->find(fd))
+  {
+    return create_socket_error(EEXIST);
+  }
+
+  auto generation = ++impl_->next_generation_;
+  epoll_event ev{};
+  ev.events = to_epoll_events(interest);
+  ev.data.u64 = make_token(fd, generation);
+  if (is_error_result(::epoll_ctl(impl_->epoll_fd_, EPOLL_CTL_ADD, fd, &ev)))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  if (static_cast<std::size_t>(fd) >= impl_->registrations_.size())
+  {
+    impl_->registrations_.resize(static_cast<std::size_t>(fd) + 1);
+  }
+
+  impl_->registrations_[fd].reset(
+    new ReactorImpl::Registration {std::move(handler), interest, generation});
+  ++impl_->count_;
+  return Error::success();
+}
+
+Error Reactor::add(const Socket& s, EventMask interest, Handler handler) noexcept
+{
+  return add(s.descriptor(), interest, std::move(handler));
+}
+
+Error Reactor::modify(std::intptr_t descriptor, EventMask interest) noexcept
+{
+  int fd = static_cast<int>(descriptor);
+  auto* registration = impl_->find(fd);
+  if (!registration)
+  {
+    return create_socket_error(ENOENT);
+  }
+
+  epoll_event ev{};
+  ev.events = to_epoll_events(interest);
+  ev.data.u64 = make_token(fd, registration->generation);
+  if (is_error_result(::epoll_ctl(impl_->epoll_fd_, EPOLL_CTL_MOD, fd, &ev)))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  registration->interest = interest;
+  return Error::success();
+}
+
+Error Reactor::modify(const Socket& s, EventMask interest) noexcept
+{
+  return modify(s.descriptor(), interest);
+}
+
+Error Reactor::remove(std::intptr_t descriptor) noexcept
+{
+  int fd = static_cast<int>(descriptor);
+  if (!impl_->find(fd))
+  {
+    return create_socket_error(ENOENT);
+  }
+
+  // The descriptor may already have been closed, in which case the kernel has
+  // dropped it from the interest list on its own.
+  int result = ::epoll_ctl(impl_->epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  int ecode = is_error_result(result) ? get_last_error() : 0;
+
+  if (impl_->dispatching_)
+  {
+    impl_->retired_.push_back(std::move(impl_->registrations_[fd]));
+  }
+  else
+  {
+    impl_->registrations_[fd].reset();
+  }
+
+  --impl_->count_;
+  if (ecode != 0 && ecode != EBADF)
+  {
+    return create_socket_error(ecode);
+  }
+
+  return Error::success();
+}
+
+Error Reactor::remove(const Socket& s) noexcept
+{
+  return remove(s.descriptor());
+}
+
+Expected<std::size_t> Reactor::run_once(std::chrono::milliseconds timeout) noexcept
+{
+  std::array<epoll_event, MaxEventsPerWait> events;
+  int waitMs = (timeout.count() < 0) ? -1 : static_cast<int>(timeout.count());
+  int eventCount = 0;
+  while (is_error_result(eventCount =
+    ::epoll_wait(impl_->epoll_fd_, events.data(), MaxEventsPerWait, waitMs)))
+  {
+    if (get_last_error() != EINTR)
+    {
+      return create_socket_error(get_last_error());
+    }
+  }
+
+  std::size_t dispatched = 0;
+  impl_->dispatching_ = true;
+  for (int i = 0; i < eventCount; ++i)
+  {
+    std::uint64_t token = events[i].data.u64;
+    if (token == WakeToken)
+    {
+      std::uint64_t counter;
+      while (::read(impl_->wake_fd_, &counter, sizeof(counter)) > 0)
+      {
+      }
+
+      continue;
+    }
+
+    auto* registration = impl_->find(token_descriptor(token));
+    if (!registration || registration->generation != token_generation(token))
+    {
+      // Removed (or replaced) by an earlier handler in this pass.
+      continue;
+    }
+
+    registration->handler(from_epoll_events(events[i].events));
+    ++dispatched;
+  }
+
+  impl_->dispatching_ = false;
+  impl_->retired_.clear();
+  return dispatched;
+}
+
+Expected<std::size_t> Reactor::run_once() noexcept
+{
+  return run_once(std::chrono::milliseconds(-1));
+}
+
+Error Reactor::run() noexcept
+{
+  while (!impl_->stop_requested_.exchange(false, std::memory_order_acq_rel))
+  {
+    auto dispatched = run_once();
+    if (!dispatched)
+    {
+      return dispatched.take_error();
+    }
+  }
+
+  return Error::success();
+}
+
+void Reactor::stop() noexcept
+{
+  impl_->stop_requested_.store(true, std::memory_order_release);
+  wake();
+}
+
+void Reactor::wake() noexcept
+{
+  std::uint64_t one = 1;
+  [[maybe_unused]] auto written = ::write(impl_->wake_fd_, &one, sizeof(one));
+}
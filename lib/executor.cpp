@@ -0,0 +1,440 @@
+///
+/// @file executor.cpp
+///
+/// Contains the implementation of jvs::net::Executor, worker threads with
+/// Chase-Lev work-stealing deques.
+///
+
+#include <jvs-netlib/executor.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <jvs-netlib/socket_errors.h>
+
+using namespace jvs;
+using namespace jvs::net;
+
+namespace
+{
+
+using Function = Executor::Function;
+
+// Executor and worker index of the calling thread, if it is a worker.
+thread_local const void* currentExecutor = nullptr;
+thread_local std::size_t currentWorker = 0;
+
+///
+/// Chase-Lev deque of posted functions, with the memory orderings of Lê et
+/// al., "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP
+/// 2013). The owning worker pushes and pops at the bottom; any thread may
+/// steal from the top. The ring grows as needed; replaced rings are kept
+/// until the deque is destroyed, as a thief may still be reading one.
+///
+class WorkStealingDeque final
+{
+public:
+  WorkStealingDeque()
+  {
+    rings_.push_back(std::make_unique<Ring>(InitialCapacity));
+    ring_.store(rings_.back().get(), std::memory_order_relaxed);
+  }
+
+  // Owner only.
+  void push(Function* function)
+  {
+    auto bottom = bottom_.load(std::memory_order_relaxed);
+    auto top = top_.load(std::memory_order_acquire);
+    auto ring = ring_.load(std::memory_order_relaxed);
+    if (bottom - top >= static_cast<std::int64_t>(ring->capacity()))
+    {
+      ring = grow(*ring, top, bottom);
+    }
+
+    ring->store(bottom, function);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  // Owner only. Takes the newest function.
+  Function* pop() noexcept
+  {
+    auto bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    auto ring = ring_.load(std::memory_order_relaxed);
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = top_.load(std::memory_order_relaxed);
+    if (top > bottom)
+    {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    auto function = ring->load(bottom);
+    if (top == bottom)
+    {
+      // The last function: thieves may be racing for it.
+      if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+        std::memory_order_relaxed))
+      {
+        function = nullptr;
+      }
+
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    return function;
+  }
+
+  // Any thread. Takes the oldest function; nullptr when the deque is empty or
+  // another thread won the race for it.
+  Function* steal() noexcept
+  {
+    auto top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom)
+    {
+      return nullptr;
+    }
+
+    auto function = ring_.load(std::memory_order_acquire)->load(top);
+    if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+      std::memory_order_relaxed))
+    {
+      return nullptr;
+    }
+
+    return function;
+  }
+
+  std::size_t size() const noexcept
+  {
+    auto bottom = bottom_.load(std::memory_order_relaxed);
+    auto top = top_.load(std::memory_order_relaxed);
+    return (bottom > top) ? static_cast<std::size_t>(bottom - top) : 0;
+  }
+
+private:
+  static constexpr std::size_t InitialCapacity = 256;
+
+  class Ring final
+  {
+  public:
+    explicit Ring(std::size_t capacity)
+      : mask_(capacity - 1), slots_(new std::atomic<Function*>[capacity])
+    {
+    }
+
+    std::size_t capacity() const noexcept
+    {
+      return mask_ + 1;
+    }
+
+    Function* load(std::int64_t index) const noexcept
+    {
+      return slots_[static_cast<std::size_t>(index) & mask_].load(std::memory_order_relaxed);
+    }
+
+    void store(std::int64_t index, Function* function) noexcept
+    {
+      slots_[static_cast<std::size_t>(index) & mask_].store(function, std::memory_order_relaxed);
+    }
+
+  private:
+    std::size_t mask_;
+    std::unique_ptr<std::atomic<Function*>[]> slots_;
+  };
+
+  // Separate cache lines, as thieves only write top_.
+  alignas(64) std::atomic<std::int64_t> top_{0};
+  alignas(64) std::atomic<std::int64_t> bottom_{0};
+  std::atomic<Ring*> ring_{nullptr};
+  std::vector<std::unique_ptr<Ring>> rings_{};
+
+  Ring* grow(const Ring& ring, std::int64_t top, std::int64_t bottom)
+  {
+    rings_.push_back(std::make_unique<Ring>(ring.capacity() * 2));
+    auto grown = rings_.back().get();
+    for (auto i = top; i < bottom; ++i)
+    {
+      grown->store(i, ring.load(i));
+    }
+
+    ring_.store(grown, std::memory_order_release);
+    return grown;
+  }
+};
+
+} // namespace
+
+class Executor::ExecutorImpl final
+{
+public:
+  // Aligned so that the counters of neighbouring workers don't share a
+  // cache line.
+  struct alignas(64) Worker
+  {
+    WorkStealingDeque deque{};
+    std::atomic<std::uint64_t> executed{0};
+    std::atomic<std::uint64_t> steals{0};
+    std::thread thread{};
+  };
+
+  ~ExecutorImpl()
+  {
+    stop();
+  }
+
+  // Creates all workers before starting any, as they steal from each other.
+  Error start(std::size_t threads)
+  {
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+      workers_.push_back(std::make_unique<Worker>());
+    }
+
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+      try
+      {
+        workers_[i]->thread = std::thread([this, i] { run(i); });
+      }
+      catch (const std::system_error& e)
+      {
+        return make_error<SocketError>(e.code().value());
+      }
+    }
+
+    return Error::success();
+  }
+
+  void post(Function function)
+  {
+    auto posted = std::make_unique<Function>(std::move(function));
+    // Counted before it is queued, so that a worker taking it can't make the
+    // count wrap.
+    pending_.fetch_add(1);
+    if (currentExecutor == this)
+    {
+      try
+      {
+        workers_[currentWorker]->deque.push(posted.get());
+      }
+      catch (...)
+      {
+        pending_.fetch_sub(1);
+        throw;
+      }
+
+      posted.release();
+      if (sleepers_.load() != 0)
+      {
+        std::lock_guard lock(mutex_);
+        wakeup_.notify_one();
+      }
+
+      return;
+    }
+
+    std::lock_guard lock(mutex_);
+    try
+    {
+      injected_.push_back(posted.get());
+    }
+    catch (...)
+    {
+      pending_.fetch_sub(1);
+      throw;
+    }
+
+    posted.release();
+    wakeup_.notify_one();
+  }
+
+  std::size_t size() const noexcept
+  {
+    return workers_.size();
+  }
+
+  std::size_t queue_depth(std::size_t worker) const noexcept
+  {
+    return (worker < workers_.size()) ? workers_[worker]->deque.size() : 0;
+  }
+
+  Stats stats() const noexcept
+  {
+    Stats stats{pending_.load(std::memory_order_relaxed), 0, 0};
+    for (auto& worker : workers_)
+    {
+      stats.executed += worker->executed.load(std::memory_order_relaxed);
+      stats.steals += worker->steals.load(std::memory_order_relaxed);
+    }
+
+    return stats;
+  }
+
+  void stop() noexcept
+  {
+    {
+      std::lock_guard lock(mutex_);
+      stopping_ = true;
+    }
+
+    wakeup_.notify_all();
+    for (auto& worker : workers_)
+    {
+      if (worker->thread.joinable())
+      {
+        worker->thread.join();
+      }
+    }
+  }
+
+private:
+  std::vector<std::unique_ptr<Worker>> workers_{};
+  // Functions posted but not yet taken by a worker.
+  std::atomic<std::size_t> pending_{0};
+  std::atomic<std::size_t> sleepers_{0};
+  std::mutex mutex_{};
+  std::condition_variable wakeup_{};
+  // Guarded by mutex_.
+  std::deque<Function*> injected_{};
+  bool stopping_{false};
+
+  // Own deque first, then the shared queue, then the other workers' deques.
+  Function* take(std::size_t index) noexcept
+  {
+    auto& self = *workers_[index];
+    if (auto function = self.deque.pop())
+    {
+      return function;
+    }
+
+    {
+      std::lock_guard lock(mutex_);
+      if (!injected_.empty())
+      {
+        auto function = injected_.front();
+        injected_.pop_front();
+        return function;
+      }
+    }
+
+    for (std::size_t i = 1; i < workers_.size(); ++i)
+    {
+      if (auto function = workers_[(index + i) % workers_.size()]->deque.steal())
+      {
+        self.steals.fetch_add(1, std::memory_order_relaxed);
+        return function;
+      }
+    }
+
+    return nullptr;
+  }
+
+  void run(std::size_t index) noexcept
+  {
+    currentExecutor = this;
+    currentWorker = index;
+    auto& self = *workers_[index];
+    for (;;)
+    {
+      if (auto function = take(index))
+      {
+        pending_.fetch_sub(1);
+        self.executed.fetch_add(1, std::memory_order_relaxed);
+        std::unique_ptr<Function> owned(function);
+        (*owned)();
+        continue;
+      }
+
+      // Sleepers are counted before pending_ is checked, and post() counts
+      // pending_ before checking for sleepers, so a wakeup can't be lost.
+      std::unique_lock lock(mutex_);
+      if (stopping_ && pending_.load() == 0)
+      {
+        break;
+      }
+
+      sleepers_.fetch_add(1);
+      wakeup_.wait(lock, [this] { return pending_.load() != 0 || stopping_; });
+      sleepers_.fetch_sub(1);
+    }
+
+    currentExecutor = nullptr;
+  }
+};
+
+Executor::Executor(Executor&&) = default;
+
+Executor& Executor::operator=(Executor&&) = default;
+
+Executor::Executor(ExecutorImpl* impl) : impl_(impl)
+{
+}
+
+Executor::~Executor() = default;
+
+Expected<Executor> Executor::create() noexcept
+{
+  return create(Options{});
+}
+
+Expected<Executor> Executor::create(Options options) noexcept
+{
+  try
+  {
+    auto threads = options.threads;
+    if (threads == 0)
+    {
+      threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    Executor executor(new ExecutorImpl());
+    if (auto e = executor.impl_->start(threads))
+    {
+      return std::move(e);
+    }
+
+    return executor;
+  }
+  catch (const std::bad_alloc&)
+  {
+    return make_error<SocketError>(errcodes::ENoBufs);
+  }
+}
+
+void Executor::post(Function function)
+{
+  impl_->post(std::move(function));
+}
+
+std::size_t Executor::size() const noexcept
+{
+  return impl_->size();
+}
+
+std::size_t Executor::queue_depth(std::size_t worker) const noexcept
+{
+  return impl_->queue_depth(worker);
+}
+
+Executor::Stats Executor::stats() const noexcept
+{
+  return impl_->stats();
+}
+
+bool Executor::running_in_this_thread() const noexcept
+{
+  return currentExecutor == impl_.get();
+}
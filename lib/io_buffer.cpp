@@ -0,0 +1,305 @@
+///
+/// @file io_buffer.cpp
+///
+/// Contains the implementations of jvs::net::IoBuffer and
+/// jvs::net::SegmentPool.
+///
+
+#include <jvs-netlib/io_buffer.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <jvs-netlib/socket_errors.h>
+
+#include "socket_impl.h"
+
+using namespace jvs;
+using namespace jvs::net;
+
+// SegmentPool
+////////////////////////////////////////////////////////////////////////////////
+
+SegmentPool::SegmentPool() : SegmentPool(DefaultSegmentSize, DefaultMaxCached)
+{
+}
+
+SegmentPool::SegmentPool(std::size_t segmentSize, std::size_t maxCached)
+  : segment_size_(std::max<std::size_t>(segmentSize, 1)),
+  max_cached_(maxCached)
+{
+}
+
+SegmentPool::~SegmentPool()
+{
+  for (auto* segment : free_)
+  {
+    delete[] segment;
+  }
+}
+
+SegmentPool& SegmentPool::local()
+{
+  thread_local SegmentPool pool;
+  return pool;
+}
+
+std::size_t SegmentPool::segment_size() const noexcept
+{
+  return segment_size_;
+}
+
+std::size_t SegmentPool::cached() const noexcept
+{
+  return free_.size();
+}
+
+std::byte* SegmentPool::acquire()
+{
+  if (free_.empty())
+  {
+    return new std::byte[segment_size_];
+  }
+
+  auto* segment = free_.back();
+  free_.pop_back();
+  return segment;
+}
+
+void SegmentPool::release(std::byte* segment) noexcept
+{
+  if (free_.size() >= max_cached_)
+  {
+    delete[] segment;
+    return;
+  }
+
+  // push_back only allocates while the cache is warming up.
+  try
+  {
+    free_.push_back(segment);
+  }
+  catch (...)
+  {
+    delete[] segment;
+  }
+}
+
+// IoBuffer
+////////////////////////////////////////////////////////////////////////////////
+
+IoBuffer::IoBuffer() : IoBuffer(SegmentPool::local(), Unlimited)
+{
+}
+
+IoBuffer::IoBuffer(std::size_t maxSize) : IoBuffer(SegmentPool::local(), maxSize)
+{
+}
+
+IoBuffer::IoBuffer(SegmentPool& pool, std::size_t maxSize) : pool_(&pool), max_size_(maxSize)
+{
+}
+
+IoBuffer::IoBuffer(IoBuffer&& other) noexcept
+  : pool_(other.pool_),
+  segments_(std::move(other.segments_)),
+  offset_(std::exchange(other.offset_, 0)),
+  size_(std::exchange(other.size_, 0)),
+  max_size_(other.max_size_)
+{
+  other.segments_.clear();
+}
+
+IoBuffer& IoBuffer::operator=(IoBuffer&& other) noexcept
+{
+  if (this != &other)
+  {
+    release_segments();
+    pool_ = other.pool_;
+    segments_ = std::move(other.segments_);
+    other.segments_.clear();
+    offset_ = std::exchange(other.offset_, 0);
+    size_ = std::exchange(other.size_, 0);
+    max_size_ = other.max_size_;
+    prepared_.clear();
+    readable_.clear();
+  }
+
+  return *this;
+}
+
+IoBuffer::~IoBuffer()
+{
+  release_segments();
+}
+
+std::size_t IoBuffer::size() const noexcept
+{
+  return size_;
+}
+
+bool IoBuffer::empty() const noexcept
+{
+  return size_ == 0;
+}
+
+std::size_t IoBuffer::max_size() const noexcept
+{
+  return max_size_;
+}
+
+std::span<const std::span<std::byte>> IoBuffer::prepare(std::size_t length)
+{
+  prepared_.clear();
+  length = std::min(length, max_size_ - size_);
+  if (length == 0)
+  {
+    return {};
+  }
+
+  std::size_t segmentSize = pool_->segment_size();
+  std::size_t position = offset_ + size_;
+  std::size_t end = position + length;
+  while (segments_.size() * segmentSize < end)
+  {
+    segments_.push_back(pool_->acquire());
+  }
+
+  while (position < end)
+  {
+    std::size_t within = position % segmentSize;
+    std::size_t count = std::min(segmentSize - within, end - position);
+    prepared_.emplace_back(segments_[position / segmentSize] + within, count);
+    position += count;
+  }
+
+  return prepared_;
+}
+
+void IoBuffer::commit(std::size_t length) noexcept
+{
+  std::size_t preparedSize = 0;
+  for (auto& span : prepared_)
+  {
+    preparedSize += span.size();
+  }
+
+  size_ += std::min(length, preparedSize);
+  prepared_.clear();
+  trim_back();
+}
+
+std::span<const std::span<const std::byte>> IoBuffer::data()
+{
+  readable_.clear();
+  std::size_t segmentSize = pool_->segment_size();
+  std::size_t position = offset_;
+  std::size_t end = offset_ + size_;
+  while (position < end)
+  {
+    std::size_t within = position % segmentSize;
+    std::size_t count = std::min(segmentSize - within, end - position);
+    readable_.emplace_back(segments_[position / segmentSize] + within, count);
+    position += count;
+  }
+
+  return readable_;
+}
+
+void IoBuffer::consume(std::size_t length) noexcept
+{
+  length = std::min(length, size_);
+  offset_ += length;
+  size_ -= length;
+  std::size_t segmentSize = pool_->segment_size();
+  while (offset_ >= segmentSize && !segments_.empty())
+  {
+    pool_->release(segments_.front());
+    segments_.pop_front();
+    offset_ -= segmentSize;
+  }
+
+  if (size_ == 0)
+  {
+    offset_ = 0;
+  }
+
+  prepared_.clear();
+  trim_back();
+}
+
+void IoBuffer::clear() noexcept
+{
+  consume(size_);
+}
+
+std::size_t IoBuffer::append(std::span<const std::byte> bytes)
+{
+  std::size_t copied = 0;
+  for (auto& span : prepare(bytes.size()))
+  {
+    std::memcpy(span.data(), bytes.data() + copied, span.size());
+    copied += span.size();
+  }
+
+  commit(copied);
+  return copied;
+}
+
+void IoBuffer::release_segments() noexcept
+{
+  for (auto* segment : segments_)
+  {
+    pool_->release(segment);
+  }
+
+  segments_.clear();
+  offset_ = 0;
+  size_ = 0;
+}
+
+// Returns segments past the end of the data (left over from prepare) to the
+// pool.
+void IoBuffer::trim_back() noexcept
+{
+  std::size_t segmentSize = pool_->segment_size();
+  std::size_t needed = (offset_ + size_ + segmentSize - 1) / segmentSize;
+  while (segments_.size() > needed)
+  {
+    pool_->release(segments_.back());
+    segments_.pop_back();
+  }
+}
+
+// Socket integration
+////////////////////////////////////////////////////////////////////////////////
+
+Expected<std::size_t> jvs::net::recv(Socket& s, IoBuffer& buffer, std::size_t maxLength)
+{
+  auto spans = buffer.prepare(maxLength);
+  if (spans.empty() && maxLength != 0)
+  {
+    return create_socket_error(errcodes::ENoBufs);
+  }
+
+  auto received = s.recvv(spans);
+  buffer.commit(received ? *received : 0);
+  return received;
+}
+
+Expected<std::size_t> jvs::net::send(Socket& s, IoBuffer& buffer)
+{
+  if (buffer.empty())
+  {
+    return 0;
+  }
+
+  auto sent = s.sendv(buffer.data());
+  if (sent)
+  {
+    buffer.consume(*sent);
+  }
+
+  return sent;
+}
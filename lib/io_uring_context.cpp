@@ -0,0 +1,999 @@
+///
+/// @file io_uring_context.cpp
+///
+/// Contains the io_uring-based implementation of jvs::net::IoUringContext.
+/// The ring is driven through the raw system calls so that no liburing
+/// dependency is required.
+///
+
+#include <jvs-netlib/io_uring_context.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <jvs-netlib/convert_cast.h>
+#include <jvs-netlib/socket_errors.h>
+
+#include "bsd_sockets_impl.h"
+#include "native_sockets.h"
+#include "socket_impl.h"
+#include "socket_types.h"
+
+#if !defined(IORING_ACCEPT_MULTISHOT)
+#define IORING_ACCEPT_MULTISHOT (1U << 0)
+#endif
+#if !defined(IORING_RECV_MULTISHOT)
+#define IORING_RECV_MULTISHOT (1U << 1)
+#endif
+#if !defined(IORING_ASYNC_CANCEL_ALL)
+#define IORING_ASYNC_CANCEL_ALL (1U << 0)
+#endif
+#if !defined(IORING_ASYNC_CANCEL_FD)
+#define IORING_ASYNC_CANCEL_FD (1U << 1)
+#endif
+#if !defined(IORING_FEAT_EXT_ARG)
+#define IORING_FEAT_EXT_ARG (1U << 8)
+#endif
+#if !defined(IORING_ENTER_EXT_ARG)
+#define IORING_ENTER_EXT_ARG (1U << 3)
+#endif
+
+using namespace jvs;
+using namespace jvs::net;
+
+namespace
+{
+
+// user_data of operations whose completions aren't reported to the caller
+// (buffer replenishment and wait timeouts).
+inline constexpr std::uint64_t InternalToken = 0;
+
+// Operations whose availability implies multishot accept and cancellation by
+// descriptor (5.19), and multishot receive (6.0), respectively. The probe interface has no way of
+// reporting per-operation flags, so these serve as version markers.
+inline constexpr unsigned MultishotAcceptMarkerOp = 45; // IORING_OP_SOCKET
+inline constexpr unsigned MultishotRecvMarkerOp = 47;   // IORING_OP_SEND_ZC
+
+// Upper bound on the operation codes checked by the probe.
+inline constexpr unsigned ProbeOpCount = 64;
+
+// Buffer IDs are 16 bits wide.
+inline constexpr std::size_t MaxProvidedBuffers = 1u << 16;
+
+int ring_setup(unsigned entries, io_uring_params* params) noexcept
+{
+  return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ring_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags,
+  const void* arg, std::size_t argSize) noexcept
+{
+  return static_cast<int>(
+    ::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize));
+}
+
+int ring_register(int fd, unsigned opcode, const void* arg, unsigned argCount) noexcept
+{
+  return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, argCount));
+}
+
+template <typename T>
+T* ring_field(void* base, std::uint32_t offset) noexcept
+{
+  return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+unsigned load_acquire(unsigned* p) noexcept
+{
+  return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire);
+}
+
+void store_release(unsigned* p, unsigned value) noexcept
+{
+  std::atomic_ref<unsigned>(*p).store(value, std::memory_order_release);
+}
+
+Error unsupported_error(int ecode) noexcept
+{
+  return jvs::make_error<UnsupportedError>(ecode);
+}
+
+} // namespace
+
+class IoUringContext::IoUringContextImpl final
+{
+public:
+  enum class OpKind
+  {
+    Accept,
+    Connect,
+    Transfer,
+    BufferRecv,
+    Close
+  };
+
+  struct Operation
+  {
+    OpKind kind;
+    // Submission template; re-submitted as-is to re-arm repeating operations.
+    io_uring_sqe sqe{};
+    Handler handler{};
+    AcceptHandler accept_handler{};
+    BufferHandler buffer_handler{};
+    // Connect target, whose remote end point becomes `address` once the
+    // connection completes.
+    Socket::SocketImpl* socket{nullptr};
+    // Connect target address, or the peer address filled in by the kernel for
+    // an accept.
+    sockaddr_storage address{};
+    socklen_t address_length{0};
+    // Accepted sockets inherit the listener's address and transports.
+    SocketInfo listener_info{};
+    // Keeps delivering completions: either a multishot submission or its
+    // single-shot emulation, which is re-armed after every completion.
+    bool repeating{false};
+    // Set by cancel(); a repeating operation isn't re-armed once cancelled.
+    bool cancelled{false};
+    bool accept_nonblocking{false};
+    // Provided buffer pool used by BufferRecv.
+    std::byte* pool_base{nullptr};
+    std::size_t pool_buffer_size{0};
+  };
+
+  IoUringContextImpl(int ringFd, const io_uring_params& params) : ring_fd_(ringFd)
+  {
+    features_ = params.features;
+  }
+
+  ~IoUringContextImpl()
+  {
+    // Closing the ring cancels everything still in flight.
+    if (sqes_)
+    {
+      ::munmap(sqes_, sqes_size_);
+    }
+
+    if (cq_ring_ && cq_ring_ != sq_ring_)
+    {
+      ::munmap(cq_ring_, cq_ring_size_);
+    }
+
+    if (sq_ring_)
+    {
+      ::munmap(sq_ring_, sq_ring_size_);
+    }
+
+    ::close(ring_fd_);
+  }
+
+  Error map_rings(const io_uring_params& params) noexcept
+  {
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap)
+    {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+
+    sq_ring_ = map_region(sq_ring_size_, IORING_OFF_SQ_RING);
+    if (!sq_ring_)
+    {
+      return create_socket_error(get_last_error());
+    }
+
+    cq_ring_ = singleMap ? sq_ring_ : map_region(cq_ring_size_, IORING_OFF_CQ_RING);
+    if (!cq_ring_)
+    {
+      return create_socket_error(get_last_error());
+    }
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(map_region(sqes_size_, IORING_OFF_SQES));
+    if (!sqes_)
+    {
+      return create_socket_error(get_last_error());
+    }
+
+    sq_head_ = ring_field<unsigned>(sq_ring_, params.sq_off.head);
+    sq_tail_ = ring_field<unsigned>(sq_ring_, params.sq_off.tail);
+    sq_mask_ = *ring_field<unsigned>(sq_ring_, params.sq_off.ring_mask);
+    sq_entries_ = params.sq_entries;
+    sq_array_ = ring_field<unsigned>(sq_ring_, params.sq_off.array);
+    cq_head_ = ring_field<unsigned>(cq_ring_, params.cq_off.head);
+    cq_tail_ = ring_field<unsigned>(cq_ring_, params.cq_off.tail);
+    cq_mask_ = *ring_field<unsigned>(cq_ring_, params.cq_off.ring_mask);
+    cqes_ = ring_field<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+    local_sq_tail_ = *sq_tail_;
+    return Error::success();
+  }
+
+  // Checks for the operations the context depends on and records the
+  // optional ones.
+  Error probe() noexcept
+  {
+    std::vector<std::byte> storage(
+      sizeof(io_uring_probe) + ProbeOpCount * sizeof(io_uring_probe_op));
+    auto* probe = reinterpret_cast<io_uring_probe*>(storage.data());
+    if (is_error_result(ring_register(ring_fd_, IORING_REGISTER_PROBE, probe, ProbeOpCount)))
+    {
+      return unsupported_error(get_last_error());
+    }
+
+    auto supported = [&](unsigned op)
+    {
+      return op <= probe->last_op && op < ProbeOpCount &&
+        (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    };
+
+    for (unsigned op : {IORING_OP_ACCEPT, IORING_OP_CONNECT, IORING_OP_RECV,
+           IORING_OP_SEND, IORING_OP_CLOSE, IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED,
+           IORING_OP_ASYNC_CANCEL})
+    {
+      if (!supported(op))
+      {
+        return unsupported_error(ENOSYS);
+      }
+    }
+
+    provided_buffers_ = supported(IORING_OP_PROVIDE_BUFFERS);
+    multishot_accept_ = supported(MultishotAcceptMarkerOp);
+    cancel_by_fd_ = supported(MultishotAcceptMarkerOp);
+    multishot_recv_ = supported(MultishotRecvMarkerOp);
+    return Error::success();
+  }
+
+  // Pushes any queued submissions to the kernel without waiting.
+  Error flush() noexcept
+  {
+    while (queued_ > 0)
+    {
+      int submitted = ring_enter(ring_fd_, queued_, 0, 0, nullptr, 0);
+      if (is_error_result(submitted))
+      {
+        if (get_last_error() == EINTR)
+        {
+          continue;
+        }
+
+        return create_socket_error(get_last_error());
+      }
+
+      queued_ -= std::min(queued_, static_cast<unsigned>(submitted));
+    }
+
+    return Error::success();
+  }
+
+  io_uring_sqe* next_sqe() noexcept
+  {
+    if (local_sq_tail_ - load_acquire(sq_head_) >= sq_entries_)
+    {
+      // The kernel consumes entries synchronously during submission.
+      if (auto e = flush())
+      {
+        jvs::consume_error(std::move(e));
+        return nullptr;
+      }
+    }
+
+    unsigned index = local_sq_tail_ & sq_mask_;
+    sq_array_[index] = index;
+    ++local_sq_tail_;
+    ++queued_;
+    store_release(sq_tail_, local_sq_tail_);
+    return &sqes_[index];
+  }
+
+  Error queue(const io_uring_sqe& sqe, std::uint64_t token) noexcept
+  {
+    auto* entry = next_sqe();
+    if (!entry)
+    {
+      return create_socket_error(EBUSY);
+    }
+
+    *entry = sqe;
+    entry->user_data = token;
+    return Error::success();
+  }
+
+  Error start(std::unique_ptr<Operation> op) noexcept
+  {
+    std::uint64_t token = ++next_token_;
+    if (auto e = queue(op->sqe, token))
+    {
+      return e;
+    }
+
+    operations_.emplace(token, std::move(op));
+    return Error::success();
+  }
+
+  // Cancels every operation on `fd`. With `linkNext`, the next entry queued
+  // is hard-linked behind the cancellation, so it only starts once the
+  // cancel request has completed. That orders it after the operations which
+  // were cancelled, but not after those already running in io-wq: the
+  // cancellation reports -EALREADY for them, and they finish on their own.
+  Error cancel_fd(std::int32_t fd, bool linkNext) noexcept
+  {
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_ASYNC_CANCEL;
+    sqe.flags = linkNext ? IOSQE_IO_HARDLINK : 0;
+    bool found = false;
+    for (auto& [token, op] : operations_)
+    {
+      if (op->sqe.fd != fd || op->kind == OpKind::Close)
+      {
+        continue;
+      }
+
+      op->cancelled = true;
+      found = true;
+      if (!cancel_by_fd_)
+      {
+        // Older kernels only match by user_data; the entries are chained so
+        // that the link to the next entry starts at the last of them.
+        sqe.addr = token;
+        if (auto e = queue(sqe, InternalToken))
+        {
+          return e;
+        }
+      }
+    }
+
+    if (!cancel_by_fd_ || !found)
+    {
+      return Error::success();
+    }
+
+    sqe.fd = fd;
+    sqe.cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    return queue(sqe, InternalToken);
+  }
+
+  // Returns a provided buffer to the kernel once its contents were consumed.
+  void replenish(const Operation& op, std::uint16_t bufferId) noexcept
+  {
+    io_uring_sqe sqe{};
+    sqe.opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe.fd = 1;
+    sqe.addr = reinterpret_cast<std::uint64_t>(op.pool_base + bufferId * op.pool_buffer_size);
+    sqe.len = static_cast<std::uint32_t>(op.pool_buffer_size);
+    sqe.off = bufferId;
+    sqe.buf_group = op.sqe.buf_group;
+    jvs::consume_error(queue(sqe, InternalToken));
+  }
+
+  // Invokes the handler of a completed operation, re-arming or retiring it.
+  // Returns whether a handler was invoked.
+  bool complete(const io_uring_cqe& cqe) noexcept
+  {
+    auto found = operations_.find(cqe.user_data);
+    if (found == operations_.end())
+    {
+      return false;
+    }
+
+    Operation* op = found->second.get();
+    if (op->kind == OpKind::BufferRecv && op->repeating && cqe.res == -ENOBUFS)
+    {
+      // The pool ran dry; wait for this pass to hand buffers back instead of
+      // reporting an error.
+      if (!(cqe.flags & IORING_CQE_F_MORE))
+      {
+        starved_.push_back(found->first);
+      }
+
+      return false;
+    }
+
+    bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+    // Multishot operations may be ended by the kernel (e.g. when the
+    // completion queue overflows) even though they succeeded.
+    bool rearm = !more && op->repeating && !op->cancelled &&
+      (op->kind == OpKind::Accept ? cqe.res >= 0 : cqe.res > 0);
+    Error rearmError = rearm ? queue(op->sqe, found->first) : Error::success();
+
+    std::unique_ptr<Operation> retired;
+    if ((!more && !rearm) || rearmError)
+    {
+      retired = std::move(found->second);
+      operations_.erase(found);
+    }
+
+    switch (op->kind)
+    {
+    case OpKind::Accept:
+      complete_accept(*op, cqe.res);
+      break;
+    case OpKind::Connect:
+      if (cqe.res == 0 && op->socket)
+      {
+        if (auto remoteEp = convert_to<IpEndPoint>(op->address))
+        {
+          op->socket->remote_endpoint_ = *remoteEp;
+        }
+        else
+        {
+          jvs::consume_error(remoteEp.take_error());
+        }
+
+        op->socket->local_pending_ = true;
+      }
+
+      [[fallthrough]];
+    case OpKind::Transfer:
+    case OpKind::Close:
+      if (cqe.res < 0)
+      {
+        op->handler(create_socket_error(-cqe.res));
+      }
+      else
+      {
+        op->handler(static_cast<std::size_t>(cqe.res));
+      }
+
+      break;
+    case OpKind::BufferRecv:
+      complete_buffer_recv(*op, cqe);
+      break;
+    }
+
+    if (rearmError)
+    {
+      switch (op->kind)
+      {
+      case OpKind::Accept:
+        op->accept_handler(std::move(rearmError));
+        break;
+      case OpKind::BufferRecv:
+        op->buffer_handler(std::move(rearmError));
+        break;
+      default:
+        jvs::consume_error(std::move(rearmError));
+        break;
+      }
+    }
+    else
+    {
+      jvs::consume_error(std::move(rearmError));
+    }
+
+    return true;
+  }
+
+  void complete_accept(Operation& op, int result) noexcept
+  {
+    if (result < 0)
+    {
+      op.accept_handler(create_socket_error(-result));
+      return;
+    }
+
+    Socket accepted(new Socket::SocketImpl(SocketContext(result), op.listener_info));
+    if (op.sqe.addr != 0)
+    {
+      if (auto remoteEp = convert_to<IpEndPoint>(op.address))
+      {
+        accepted.impl_->remote_endpoint_ = *remoteEp;
+      }
+      else
+      {
+        jvs::consume_error(remoteEp.take_error());
+      }
+
+      // Re-armed accepts are submitted with the same template.
+      op.address_length = static_cast<socklen_t>(sizeof(op.address));
+    }
+    else
+    {
+      // A multishot accept has no per-completion address to report the peer
+      // through.
+      accepted.impl_->update_remote_endpoint();
+    }
+
+    accepted.impl_->nonblocking_ = op.accept_nonblocking;
+    op.accept_handler(std::move(accepted));
+  }
+
+  void complete_buffer_recv(Operation& op, const io_uring_cqe& cqe) noexcept
+  {
+    bool hasBuffer = (cqe.flags & IORING_CQE_F_BUFFER) != 0;
+    auto bufferId = static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+    if (cqe.res < 0)
+    {
+      op.buffer_handler(create_socket_error(-cqe.res));
+    }
+    else if (cqe.res == 0 || !hasBuffer)
+    {
+      op.buffer_handler(std::span<const std::byte>{});
+    }
+    else
+    {
+      op.buffer_handler(std::span<const std::byte>(
+        op.pool_base + bufferId * op.pool_buffer_size, static_cast<std::size_t>(cqe.res)));
+    }
+
+    if (hasBuffer)
+    {
+      replenish(op, bufferId);
+    }
+  }
+
+  // Dispatches every completion currently in the queue.
+  std::size_t reap() noexcept
+  {
+    std::size_t dispatched = 0;
+    unsigned head = *cq_head_;
+    while (head != load_acquire(cq_tail_))
+    {
+      io_uring_cqe cqe = cqes_[head & cq_mask_];
+      // Release the slot before dispatching so that handlers queueing new
+      // operations can't be starved of completion queue space.
+      store_release(cq_head_, ++head);
+      if (cqe.user_data != InternalToken && complete(cqe))
+      {
+        ++dispatched;
+      }
+    }
+
+    // Re-armed after the buffers consumed during the pass were replenished.
+    for (auto token : starved_)
+    {
+      auto found = operations_.find(token);
+      if (found == operations_.end())
+      {
+        continue;
+      }
+
+      // Cancelled while it had no submission in flight.
+      Error e = found->second->cancelled ? create_socket_error(ECANCELED)
+                                         : queue(found->second->sqe, token);
+      if (e)
+      {
+        auto op = std::move(found->second);
+        operations_.erase(found);
+        op->buffer_handler(std::move(e));
+        ++dispatched;
+      }
+    }
+
+    starved_.clear();
+    return dispatched;
+  }
+
+  int ring_fd_;
+  unsigned features_{0};
+  void* sq_ring_{nullptr};
+  void* cq_ring_{nullptr};
+  io_uring_sqe* sqes_{nullptr};
+  std::size_t sq_ring_size_{0};
+  std::size_t cq_ring_size_{0};
+  std::size_t sqes_size_{0};
+  unsigned* sq_head_{nullptr};
+  unsigned* sq_tail_{nullptr};
+  unsigned* sq_array_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned sq_entries_{0};
+  unsigned* cq_head_{nullptr};
+  unsigned* cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  io_uring_cqe* cqes_{nullptr};
+  unsigned local_sq_tail_{0};
+  // Entries written to the submission queue but not yet handed to the kernel.
+  unsigned queued_{0};
+
+  bool provided_buffers_{false};
+  bool multishot_accept_{false};
+  bool multishot_recv_{false};
+  bool cancel_by_fd_{false};
+
+  std::unordered_map<std::uint64_t, std::unique_ptr<Operation>> operations_{};
+  // Buffer receives which failed for lack of provided buffers.
+  std::vector<std::uint64_t> starved_{};
+  std::uint64_t next_token_{InternalToken};
+  std::vector<std::span<std::byte>> registered_buffers_{};
+  // Current provided buffer pool; each provide_buffers call gets a new group
+  // so that receives armed with an older pool keep working.
+  std::byte* pool_base_{nullptr};
+  std::size_t pool_buffer_size_{0};
+  std::uint16_t pool_group_{0};
+
+private:
+  void* map_region(std::size_t size, std::uint64_t offset) noexcept
+  {
+    void* region = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      ring_fd_, static_cast<off_t>(offset));
+    return region == MAP_FAILED ? nullptr : region;
+  }
+};
+
+IoUringContext::IoUringContext(IoUringContext&&) = default;
+
+IoUringContext& IoUringContext::operator=(IoUringContext&&) = default;
+
+IoUringContext::IoUringContext(IoUringContextImpl* impl) : impl_(impl)
+{
+}
+
+IoUringContext::~IoUringContext() = default;
+
+Expected<IoUringContext> IoUringContext::create(unsigned entries) noexcept
+{
+  io_uring_params params{};
+  params.flags = IORING_SETUP_CLAMP;
+  int ringFd = ring_setup(entries, &params);
+  if (is_error_result(ringFd))
+  {
+    int ecode = get_last_error();
+    // ENOSYS: not built into the kernel (or filtered by seccomp); EPERM:
+    // disabled through the io_uring_disabled sysctl.
+    if (ecode == ENOSYS || ecode == EPERM)
+    {
+      return unsupported_error(ecode);
+    }
+
+    return create_socket_error(ecode);
+  }
+
+  std::unique_ptr<IoUringContextImpl> impl(new IoUringContextImpl(ringFd, params));
+  if (auto e = impl->map_rings(params))
+  {
+    return std::move(e);
+  }
+
+  if (auto e = impl->probe())
+  {
+    return std::move(e);
+  }
+
+  return IoUringContext(impl.release());
+}
+
+Expected<IoUringContext> IoUringContext::create() noexcept
+{
+  return create(DefaultEntries);
+}
+
+std::size_t IoUringContext::pending() const noexcept
+{
+  return impl_->operations_.size();
+}
+
+Error IoUringContext::register_buffers(std::span<const std::span<std::byte>> buffers) noexcept
+{
+  if (!impl_->registered_buffers_.empty())
+  {
+    if (is_error_result(
+          ring_register(impl_->ring_fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0)))
+    {
+      return create_socket_error(get_last_error());
+    }
+
+    impl_->registered_buffers_.clear();
+  }
+
+  if (buffers.empty())
+  {
+    return Error::success();
+  }
+
+  std::vector<iovec> vectors(buffers.size());
+  for (std::size_t i = 0; i < buffers.size(); ++i)
+  {
+    vectors[i].iov_base = buffers[i].data();
+    vectors[i].iov_len = buffers[i].size();
+  }
+
+  if (is_error_result(ring_register(impl_->ring_fd_, IORING_REGISTER_BUFFERS, vectors.data(),
+        static_cast<unsigned>(vectors.size()))))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  impl_->registered_buffers_.assign(buffers.begin(), buffers.end());
+  return Error::success();
+}
+
+Error IoUringContext::provide_buffers(
+  std::span<std::byte> storage, std::size_t bufferSize) noexcept
+{
+  if (!impl_->provided_buffers_)
+  {
+    return unsupported_error(ENOSYS);
+  }
+
+  std::size_t count = bufferSize ? storage.size() / bufferSize : 0;
+  if (count == 0 || bufferSize > UINT32_MAX)
+  {
+    return create_socket_error(EINVAL);
+  }
+
+  io_uring_sqe sqe{};
+  sqe.opcode = IORING_OP_PROVIDE_BUFFERS;
+  sqe.fd = static_cast<std::int32_t>(std::min(count, MaxProvidedBuffers));
+  sqe.addr = reinterpret_cast<std::uint64_t>(storage.data());
+  sqe.len = static_cast<std::uint32_t>(bufferSize);
+  sqe.off = 0;
+  sqe.buf_group = static_cast<std::uint16_t>(impl_->pool_group_ + 1);
+  if (auto e = impl_->queue(sqe, InternalToken))
+  {
+    return e;
+  }
+
+  impl_->pool_base_ = storage.data();
+  impl_->pool_buffer_size_ = bufferSize;
+  ++impl_->pool_group_;
+  return Error::success();
+}
+
+Error IoUringContext::accept(Socket& listener, AcceptHandler handler) noexcept
+{
+  auto op = std::make_unique<IoUringContextImpl::Operation>();
+  op->kind = IoUringContextImpl::OpKind::Accept;
+  op->sqe.opcode = IORING_OP_ACCEPT;
+  op->sqe.fd = static_cast<std::int32_t>(listener.impl_->socket_info_.context());
+  op->accept_nonblocking = listener.impl_->nonblocking_;
+  op->sqe.accept_flags = SOCK_CLOEXEC | (op->accept_nonblocking ? SOCK_NONBLOCK : 0);
+  op->listener_info = listener.impl_->socket_info_;
+  op->address_length = static_cast<socklen_t>(sizeof(op->address));
+  op->sqe.addr = reinterpret_cast<std::uint64_t>(&op->address);
+  op->sqe.addr2 = reinterpret_cast<std::uint64_t>(&op->address_length);
+  op->accept_handler = std::move(handler);
+  return impl_->start(std::move(op));
+}
+
+Error IoUringContext::accept_multishot(Socket& listener, AcceptHandler handler) noexcept
+{
+  auto op = std::make_unique<IoUringContextImpl::Operation>();
+  op->kind = IoUringContextImpl::OpKind::Accept;
+  op->sqe.opcode = IORING_OP_ACCEPT;
+  op->sqe.fd = static_cast<std::int32_t>(listener.impl_->socket_info_.context());
+  op->accept_nonblocking = listener.impl_->nonblocking_;
+  op->sqe.accept_flags = SOCK_CLOEXEC | (op->accept_nonblocking ? SOCK_NONBLOCK : 0);
+  op->listener_info = listener.impl_->socket_info_;
+  if (impl_->multishot_accept_)
+  {
+    op->sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+  }
+  else
+  {
+    // The emulation accepts one connection at a time, so the peer address
+    // can be received with each of them.
+    op->address_length = static_cast<socklen_t>(sizeof(op->address));
+    op->sqe.addr = reinterpret_cast<std::uint64_t>(&op->address);
+    op->sqe.addr2 = reinterpret_cast<std::uint64_t>(&op->address_length);
+  }
+
+  op->repeating = true;
+  op->accept_handler = std::move(handler);
+  return impl_->start(std::move(op));
+}
+
+Error IoUringContext::connect(Socket& s, const IpEndPoint& remoteEp, Handler handler) noexcept
+{
+  auto op = std::make_unique<IoUringContextImpl::Operation>();
+  op->kind = IoUringContextImpl::OpKind::Connect;
+  op->socket = s.impl_.get();
+  op->address = convert_to<sockaddr>(remoteEp);
+  op->sqe.opcode = IORING_OP_CONNECT;
+  op->sqe.fd = static_cast<std::int32_t>(s.impl_->socket_info_.context());
+  op->sqe.addr = reinterpret_cast<std::uint64_t>(&op->address);
+  op->sqe.off = get_address_length(remoteEp);
+  op->handler = std::move(handler);
+  return impl_->start(std::move(op));
+}
+
+Error IoUringContext::recv(Socket& s, std::span<std::byte> buffer, Handler handler) noexcept
+{
+  auto op = std::make_unique<IoUringContextImpl::Operation>();
+  op->kind = IoUringContextImpl::OpKind::Transfer;
+  op->sqe.opcode = IORING_OP_RECV;
+  op->sqe.fd = static_cast<std::int32_t>(s.impl_->socket_info_.context());
+  op->sqe.addr = reinterpret_cast<std::uint64_t>(buffer.data());
+  op->sqe.len = static_cast<std::uint32_t>(buffer.size());
+  op->handler = std::move(handler);
+  return impl_->start(std::move(op));
+}
+
+Error IoUringContext::recv_fixed(
+  Socket& s, std::size_t bufferIndex, std::span<std::byte> buffer, Handler handler) noexcept
+{
+  auto& registered = impl_->registered_buffers_;
+  if (bufferIndex >= registered.size() || buffer.data() < registered[bufferIndex].data() ||
+    buffer.data() + buffer.size() >
+      registered[bufferIndex].data() + registered[bufferIndex].size())
+  {
+    return create_socket_error(EINVAL);
+  }
+
+  // Fixed buffers are only available to read/write; the offset is ignored for
+  // sockets.
+  auto op = std::make_unique<IoUringContextImpl::Operation>();
+  op->kind = IoUringContextImpl::OpKind::Transfer;
+  op->sqe.opcode = IORING_OP_READ_FIXED;
+  op->sqe.fd = static_cast<std::int32_t>(s.impl_->socket_info_.context());
+  op->sqe.addr = reinterpret_cast<std::uint64_t>(buffer.data());
+  op->sqe.len = static_cast<std::uint32_t>(buffer.size());
+  op->sqe.buf_index = static_cast<std::uint16_t>(bufferIndex);
+  op->handler = std::move(handler);
+  return impl_->start(std::move(op));
+}
+
+Error IoUringContext::recv_multishot(Socket& s, BufferHandler handler) noexcept
+{
+  if (!impl_->pool_base_)
+  {
+    return create_socket_error(EINVAL);
+  }
+
+  auto op = std::make_unique<IoUringContextImpl::Operation>();
+  op->kind = IoUringContextImpl::OpKind::BufferRecv;
+  op->sqe.opcode = IORING_OP_RECV;
+  op->sqe.fd = static_cast<std::int32_t>(s.impl_->socket_info_.context());
+  op->sqe.flags = IOSQE_BUFFER_SELECT;
+  op->sqe.buf_group = impl_->pool_group_;
+  if (impl_->multishot_recv_)
+  {
+    op->sqe.ioprio = IORING_RECV_MULTISHOT;
+  }
+  else
+  {
+    op->sqe.len = static_cast<std::uint32_t>(impl_->pool_buffer_size_);
+  }
+
+  op->repeating = true;
+  op->pool_base = impl_->pool_base_;
+  op->pool_buffer_size = impl_->pool_buffer_size_;
+  op->buffer_handler = std::move(handler);
+  return impl_->start(std::move(op));
+}
+
+Error IoUringContext::send(
+  Socket& s, std::span<const std::byte> buffer, Handler handler) noexcept
+{
+  auto op = std::make_unique<IoUringContextImpl::Operation>();
+  op->kind = IoUringContextImpl::OpKind::Transfer;
+  op->sqe.opcode = IORING_OP_SEND;
+  op->sqe.fd = static_cast<std::int32_t>(s.impl_->socket_info_.context());
+  op->sqe.addr = reinterpret_cast<std::uint64_t>(buffer.data());
+  op->sqe.len = static_cast<std::uint32_t>(buffer.size());
+  op->handler = std::move(handler);
+  return impl_->start(std::move(op));
+}
+
+Error IoUringContext::send_fixed(Socket& s, std::size_t bufferIndex,
+  std::span<const std::byte> buffer, Handler handler) noexcept
+{
+  auto& registered = impl_->registered_buffers_;
+  if (bufferIndex >= registered.size() || buffer.data() < registered[bufferIndex].data() ||
+    buffer.data() + buffer.size() >
+      registered[bufferIndex].data() + registered[bufferIndex].size())
+  {
+    return create_socket_error(EINVAL);
+  }
+
+  auto op = std::make_unique<IoUringContextImpl::Operation>();
+  op->kind = IoUringContextImpl::OpKind::Transfer;
+  op->sqe.opcode = IORING_OP_WRITE_FIXED;
+  op->sqe.fd = static_cast<std::int32_t>(s.impl_->socket_info_.context());
+  op->sqe.addr = reinterpret_cast<std::uint64_t>(buffer.data());
+  op->sqe.len = static_cast<std::uint32_t>(buffer.size());
+  op->sqe.buf_index = static_cast<std::uint16_t>(bufferIndex);
+  op->handler = std::move(handler);
+  return impl_->start(std::move(op));
+}
+
+Error IoUringContext::cancel(Socket& s) noexcept
+{
+  SocketContext ctx = s.impl_->socket_info_.context();
+  if (is_error_result(ctx))
+  {
+    return create_socket_error(EBADF);
+  }
+
+  return impl_->cancel_fd(static_cast<std::int32_t>(ctx), /*linkNext*/ false);
+}
+
+Error IoUringContext::close(Socket& s, Handler handler) noexcept
+{
+  SocketContext ctx = s.impl_->release();
+  if (is_error_result(ctx))
+  {
+    return create_socket_error(EBADF);
+  }
+
+  // Pending operations hold their own reference to the socket, so closing
+  // the descriptor alone wouldn't end them.
+  if (auto e = impl_->cancel_fd(static_cast<std::int32_t>(ctx), /*linkNext*/ true))
+  {
+    ::close(ctx);
+    return e;
+  }
+
+  auto op = std::make_unique<IoUringContextImpl::Operation>();
+  op->kind = IoUringContextImpl::OpKind::Close;
+  op->sqe.opcode = IORING_OP_CLOSE;
+  op->sqe.fd = static_cast<std::int32_t>(ctx);
+  op->handler = std::move(handler);
+  if (auto e = impl_->start(std::move(op)))
+  {
+    ::close(ctx);
+    return e;
+  }
+
+  return Error::success();
+}
+
+Expected<std::size_t> IoUringContext::run_once(std::chrono::milliseconds timeout) noexcept
+{
+  unsigned flags = IORING_ENTER_GETEVENTS;
+  unsigned minComplete = (timeout.count() == 0) ? 0 : 1;
+  __kernel_timespec waitTime{};
+  io_uring_getevents_arg waitArg{};
+  const void* arg = nullptr;
+  std::size_t argSize = 0;
+  if (timeout.count() > 0)
+  {
+    waitTime.tv_sec = timeout.count() / 1000;
+    waitTime.tv_nsec = (timeout.count() % 1000) * 1000000;
+    if (impl_->features_ & IORING_FEAT_EXT_ARG)
+    {
+      waitArg.ts = reinterpret_cast<std::uint64_t>(&waitTime);
+      flags |= IORING_ENTER_EXT_ARG;
+      arg = &waitArg;
+      argSize = sizeof(waitArg);
+    }
+    else
+    {
+      // Older kernels: a timeout operation which completes after the wait
+      // time or the first other completion, whichever comes first. The time
+      // is copied when the entry is submitted.
+      io_uring_sqe sqe{};
+      sqe.opcode = IORING_OP_TIMEOUT;
+      sqe.addr = reinterpret_cast<std::uint64_t>(&waitTime);
+      sqe.len = 1;
+      sqe.off = 1;
+      if (auto e = impl_->queue(sqe, InternalToken))
+      {
+        return std::move(e);
+      }
+    }
+  }
+
+  int submitted = ring_enter(impl_->ring_fd_, impl_->queued_, minComplete, flags, arg, argSize);
+  if (is_error_result(submitted))
+  {
+    int ecode = get_last_error();
+    // ETIME: the wait timed out; EINTR: interrupted by a signal; EBUSY: the
+    // completion queue overflowed and must be drained first.
+    if (ecode != ETIME && ecode != EINTR && ecode != EBUSY)
+    {
+      return create_socket_error(ecode);
+    }
+  }
+  else
+  {
+    impl_->queued_ -= std::min(impl_->queued_, static_cast<unsigned>(submitted));
+  }
+
+  return impl_->reap();
+}
+
+Expected<std::size_t> IoUringContext::run_once() noexcept
+{
+  return run_once(std::chrono::milliseconds(-1));
+}
@@ -1,7 +1,9 @@
 #include <jvs-netlib/ip_end_point.h>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <optional>
 #include <type_traits>
 
@@ -15,6 +17,17 @@ inline constexpr std::size_t Ipv4AddressLength = 16;
 // "ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255%4294967295\0"
 inline constexpr std::size_t Ipv6AddressLength = 57;
 
+// splitmix64 finalizer.
+constexpr std::uint64_t mix64(std::uint64_t h) noexcept
+{
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ull;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebull;
+  h ^= h >> 31;
+  return h;
+}
+
 } // namespace 
 
 
@@ -113,3 +126,26 @@ std::string jvs::ConvertCast<jvs::net::IpEndPoint, std::string>::operator()(
 {
   return jvs::net::to_string(ep);
 }
+
+bool jvs::net::operator==(const IpEndPoint& a, const IpEndPoint& b) noexcept
+{
+  return a.port() == b.port() && a.address() == b.address();
+}
+
+bool jvs::net::operator!=(const IpEndPoint& a, const IpEndPoint& b) noexcept
+{
+  return !(a == b);
+}
+
+std::size_t std::hash<jvs::net::IpEndPoint>::operator()(
+  const jvs::net::IpEndPoint& ep) const noexcept
+{
+  // The address is hashed as two 64-bit words rather than byte by byte, as
+  // end points are used as keys on hot paths (e.g. connection pools).
+  const auto& address = ep.address();
+  std::array<std::uint64_t, 2> words{};
+  std::memcpy(words.data(), address.address_bytes(), address.address_size());
+  std::uint64_t tail = (static_cast<std::uint64_t>(ep.port().value()) << 48) ^
+    (static_cast<std::uint64_t>(address.family()) << 40) ^ address.scope_id();
+  return static_cast<std::size_t>(mix64(words[0] ^ mix64(words[1] ^ tail)));
+}
@@ -0,0 +1,960 @@
+///
+/// @file resolver.cpp
+///
+/// Contains the implementation of jvs::net::Resolver, a DNS stub resolver
+/// driven by a Reactor on a background thread.
+///
+
+#include <jvs-netlib/resolver.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include <jvs-netlib/reactor.h>
+#include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_errors.h>
+
+#include "socket_impl.h"
+
+using namespace jvs;
+using namespace jvs::net;
+using Family = IpAddress::Family;
+
+namespace
+{
+
+inline constexpr std::uint16_t TypeA = 1;
+inline constexpr std::uint16_t TypeAaaa = 28;
+inline constexpr std::uint16_t ClassIn = 1;
+
+inline constexpr std::uint8_t RCodeNoError = 0;
+inline constexpr std::uint8_t RCodeNxDomain = 3;
+
+inline constexpr std::size_t HeaderSize = 12;
+// Names are at most 255 bytes on the wire (RFC 1035 2.3.4).
+inline constexpr std::size_t MaxNameSize = 255;
+inline constexpr std::size_t MaxLabelSize = 63;
+// Without EDNS, UDP answers are limited to 512 bytes, but be lenient in what
+// is accepted.
+inline constexpr std::size_t MaxMessageSize = 4096;
+inline constexpr std::uint16_t DnsPort = 53;
+
+using Clock = std::chrono::steady_clock;
+
+// Lower-cases the name and strips a trailing dot; returns nothing if it can't
+// be encoded as a DNS name.
+std::optional<std::string> normalize_name(std::string_view host)
+{
+  if (!host.empty() && host.back() == '.')
+  {
+    host.remove_suffix(1);
+  }
+
+  if (host.empty() || host.size() + 2 > MaxNameSize)
+  {
+    return std::nullopt;
+  }
+
+  std::string name;
+  name.reserve(host.size());
+  std::size_t labelSize = 0;
+  for (char c : host)
+  {
+    if (c == '.')
+    {
+      if (labelSize == 0)
+      {
+        return std::nullopt;
+      }
+
+      labelSize = 0;
+    }
+    else if (++labelSize > MaxLabelSize)
+    {
+      return std::nullopt;
+    }
+
+    name.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+  }
+
+  if (labelSize == 0)
+  {
+    return std::nullopt;
+  }
+
+  return name;
+}
+
+bool is_localhost(std::string_view name) noexcept
+{
+  constexpr std::string_view Localhost = "localhost";
+  return name == Localhost ||
+    (name.size() > Localhost.size() && name.ends_with(Localhost) &&
+      name[name.size() - Localhost.size() - 1] == '.');
+}
+
+void append_u16(std::vector<std::uint8_t>& message, std::uint16_t value)
+{
+  message.push_back(static_cast<std::uint8_t>(value >> 8));
+  message.push_back(static_cast<std::uint8_t>(value & 0xff));
+}
+
+// Builds a recursive query for a single record type of a normalized name.
+std::vector<std::uint8_t> build_query(std::uint16_t id, std::string_view name,
+  std::uint16_t type)
+{
+  std::vector<std::uint8_t> message;
+  message.reserve(HeaderSize + name.size() + 6);
+  append_u16(message, id);
+  append_u16(message, 0x0100); // Recursion desired.
+  append_u16(message, 1);      // Question count.
+  append_u16(message, 0);
+  append_u16(message, 0);
+  append_u16(message, 0);
+  while (!name.empty())
+  {
+    auto label = name.substr(0, name.find('.'));
+    message.push_back(static_cast<std::uint8_t>(label.size()));
+    message.insert(message.end(), label.begin(), label.end());
+    name.remove_prefix(std::min(label.size() + 1, name.size()));
+  }
+
+  message.push_back(0);
+  append_u16(message, type);
+  append_u16(message, ClassIn);
+  return message;
+}
+
+// Bounds-checked reader for DNS messages; reads past the end turn the reader
+// invalid rather than failing individually.
+class MessageReader final
+{
+public:
+  explicit MessageReader(std::span<const std::uint8_t> message) noexcept
+    : message_(message)
+  {
+  }
+
+  bool valid() const noexcept
+  {
+    return valid_;
+  }
+
+  std::uint8_t u8() noexcept
+  {
+    if (!require(1))
+    {
+      return 0;
+    }
+
+    return message_[position_++];
+  }
+
+  std::uint16_t u16() noexcept
+  {
+    if (!require(2))
+    {
+      return 0;
+    }
+
+    auto value = static_cast<std::uint16_t>((message_[position_] << 8) | message_[position_ + 1]);
+    position_ += 2;
+    return value;
+  }
+
+  std::uint32_t u32() noexcept
+  {
+    std::uint32_t high = u16();
+    return (high << 16) | u16();
+  }
+
+  std::span<const std::uint8_t> bytes(std::size_t count) noexcept
+  {
+    if (!require(count))
+    {
+      return {};
+    }
+
+    auto result = message_.subspan(position_, count);
+    position_ += count;
+    return result;
+  }
+
+  // Skips a (possibly compressed) name without following pointers.
+  void skip_name() noexcept
+  {
+    for (std::size_t labels = 0; valid_ && labels <= MaxNameSize; ++labels)
+    {
+      auto length = u8();
+      if ((length & 0xc0) == 0xc0)
+      {
+        u8();
+        return;
+      }
+
+      if (length == 0 || (length & 0xc0) != 0)
+      {
+        valid_ = valid_ && length == 0;
+        return;
+      }
+
+      bytes(length);
+    }
+
+    valid_ = false;
+  }
+
+  // Reads an uncompressed name and compares it, ignoring ASCII case, with a
+  // dotted name split into labels as by build_query.
+  bool read_name_equals(std::string_view name) noexcept
+  {
+    for (;;)
+    {
+      auto length = u8();
+      if (!valid_ || (length & 0xc0) != 0)
+      {
+        return false;
+      }
+
+      if (length == 0)
+      {
+        return name.empty();
+      }
+
+      auto label = bytes(length);
+      auto expected = name.substr(0, name.find('.'));
+      if (!valid_ || !std::equal(label.begin(), label.end(), expected.begin(), expected.end(),
+        [](std::uint8_t a, char b)
+        {
+          return std::tolower(a) == std::tolower(static_cast<unsigned char>(b));
+        }))
+      {
+        return false;
+      }
+
+      name.remove_prefix(std::min(expected.size() + 1, name.size()));
+    }
+  }
+
+private:
+  std::span<const std::uint8_t> message_;
+  std::size_t position_{0};
+  bool valid_{true};
+
+  bool require(std::size_t count) noexcept
+  {
+    valid_ = valid_ && message_.size() - position_ >= count;
+    return valid_;
+  }
+};
+
+struct Response
+{
+  std::uint16_t id{0};
+  std::uint8_t rcode{0};
+  bool truncated{false};
+  std::vector<IpAddress> addresses{};
+  // Smallest TTL of the records in the answer section.
+  std::uint32_t ttl{0};
+};
+
+std::optional<std::uint16_t> response_id(std::span<const std::uint8_t> message) noexcept
+{
+  MessageReader reader(message);
+  auto id = reader.u16();
+  auto flags = reader.u16();
+  if (!reader.valid() || (flags & 0x8000) == 0)
+  {
+    return std::nullopt;
+  }
+
+  return id;
+}
+
+// Parses the answer to a query for the given name and type. Returns nothing if
+// the message is malformed or doesn't answer that query; checking the echoed
+// name keeps a forged answer from having to guess only the 16-bit ID.
+std::optional<Response> parse_response(std::span<const std::uint8_t> message,
+  std::string_view name, std::uint16_t type)
+{
+  MessageReader reader(message);
+  Response response;
+  response.id = reader.u16();
+  auto flags = reader.u16();
+  auto questionCount = reader.u16();
+  auto answerCount = reader.u16();
+  reader.u16();
+  reader.u16();
+  if (!reader.valid() || questionCount != 1)
+  {
+    return std::nullopt;
+  }
+
+  response.truncated = (flags & 0x0200) != 0;
+  response.rcode = static_cast<std::uint8_t>(flags & 0x000f);
+  bool sameName = reader.read_name_equals(name);
+  auto questionType = reader.u16();
+  auto questionClass = reader.u16();
+  if (!reader.valid() || !sameName || questionType != type || questionClass != ClassIn)
+  {
+    return std::nullopt;
+  }
+
+  std::optional<std::uint32_t> ttl;
+  for (std::uint16_t i = 0; i < answerCount; ++i)
+  {
+    reader.skip_name();
+    auto recordType = reader.u16();
+    auto recordClass = reader.u16();
+    auto recordTtl = reader.u32();
+    auto data = reader.bytes(reader.u16());
+    if (!reader.valid())
+    {
+      // A truncated answer may still carry usable records.
+      if (response.truncated)
+      {
+        break;
+      }
+
+      return std::nullopt;
+    }
+
+    if (recordClass != ClassIn)
+    {
+      continue;
+    }
+
+    // CNAME records leading to the addresses limit the TTL too.
+    ttl = std::min(ttl.value_or(recordTtl), recordTtl);
+    if (recordType == TypeA && type == TypeA && data.size() == Ipv4AddressSize)
+    {
+      response.addresses.emplace_back(data.data(), Family::IPv4);
+    }
+    else if (recordType == TypeAaaa && type == TypeAaaa && data.size() == Ipv6AddressSize)
+    {
+      response.addresses.emplace_back(data.data(), Family::IPv6);
+    }
+  }
+
+  response.ttl = ttl.value_or(0);
+  return response;
+}
+
+std::vector<IpEndPoint> read_system_servers()
+{
+  std::vector<IpEndPoint> servers;
+  std::ifstream resolvConf("/etc/resolv.conf");
+  std::string line;
+  while (std::getline(resolvConf, line))
+  {
+    constexpr std::string_view Keyword = "nameserver";
+    std::string_view view(line);
+    if (!view.starts_with(Keyword))
+    {
+      continue;
+    }
+
+    view.remove_prefix(Keyword.size());
+    auto begin = view.find_first_not_of(" \t");
+    if (begin == std::string_view::npos || begin == 0)
+    {
+      continue;
+    }
+
+    view.remove_prefix(begin);
+    view = view.substr(0, view.find_first_of(" \t#;%"));
+    if (auto address = IpAddress::parse(view))
+    {
+      servers.emplace_back(*address, DnsPort);
+    }
+  }
+
+  if (servers.empty())
+  {
+    servers.emplace_back(IpAddress::ipv4_loopback(), DnsPort);
+  }
+
+  return servers;
+}
+
+} // namespace
+
+class Resolver::ResolverImpl final
+{
+public:
+  struct Key
+  {
+    std::string name;
+    std::uint16_t type;
+
+    bool operator==(const Key&) const = default;
+  };
+
+  struct KeyHash
+  {
+    std::size_t operator()(const Key& key) const noexcept
+    {
+      return std::hash<std::string>{}(key.name) ^ key.type;
+    }
+  };
+
+  struct CacheEntry
+  {
+    std::vector<IpAddress> addresses;
+    // Zero for a positive answer, otherwise the EAI_ code to report.
+    int error{0};
+    Clock::time_point expiry;
+  };
+
+  // One call to resolve(), waiting for up to two queries.
+  struct Lookup
+  {
+    NetworkU16 port;
+    Handler handler;
+    std::size_t remaining{0};
+    std::vector<IpAddress> ipv6{};
+    std::vector<IpAddress> ipv4{};
+    int error{0};
+  };
+
+  // A query in flight, shared by every lookup of the same name and type.
+  struct Query
+  {
+    // Unset until the query is first sent.
+    std::optional<std::uint16_t> id{};
+    std::size_t attempt{0};
+    Clock::time_point deadline{};
+    std::vector<std::shared_ptr<Lookup>> waiters{};
+  };
+
+  ResolverImpl(Options options, Reactor reactor, std::vector<Socket> sockets)
+    : options_(std::move(options)),
+    reactor_(std::move(reactor)),
+    sockets_(std::move(sockets)),
+    random_(std::random_device{}())
+  {
+  }
+
+  ~ResolverImpl()
+  {
+    stopping_.store(true, std::memory_order_release);
+    reactor_.wake();
+    if (thread_.joinable())
+    {
+      thread_.join();
+    }
+
+    for (auto& s : sockets_)
+    {
+      jvs::consume_error(reactor_.remove(s));
+      s.close();
+    }
+  }
+
+  Error start() noexcept
+  {
+    for (std::size_t i = 0; i < sockets_.size(); ++i)
+    {
+      if (auto e = reactor_.add(sockets_[i], Reactor::Readable,
+        [this, i](Reactor::EventMask) { receive(i); }))
+      {
+        return e;
+      }
+    }
+
+    try
+    {
+      thread_ = std::thread([this] { run(); });
+    }
+    catch (const std::system_error& e)
+    {
+      return make_error<SocketError>(e.code().value());
+    }
+
+    return Error::success();
+  }
+
+  // Called from any thread.
+  void resolve(std::string name, NetworkU16 port, Family family, Handler handler)
+  {
+    auto lookup = std::make_shared<Lookup>(Lookup{port, std::move(handler)});
+    bool queued = false;
+    {
+      std::lock_guard lock(mutex_);
+      auto now = Clock::now();
+      for (auto type : {TypeAaaa, TypeA})
+      {
+        if ((type == TypeA && family == Family::IPv6) ||
+          (type == TypeAaaa && family == Family::IPv4))
+        {
+          continue;
+        }
+
+        Key key{name, type};
+        auto cached = cache_.find(key);
+        if (cached != cache_.end() && cached->second.expiry > now)
+        {
+          add_answer(*lookup, type, cached->second.addresses, cached->second.error);
+          continue;
+        }
+
+        ++lookup->remaining;
+        queued_.emplace_back(std::move(key), lookup);
+        queued = true;
+      }
+    }
+
+    // Once queued, the lookup belongs to the resolver's thread.
+    if (!queued)
+    {
+      finish(*lookup);
+      return;
+    }
+
+    reactor_.wake();
+  }
+
+  std::size_t cached() const noexcept
+  {
+    std::lock_guard lock(mutex_);
+    return cache_.size();
+  }
+
+  void clear_cache() noexcept
+  {
+    std::lock_guard lock(mutex_);
+    cache_.clear();
+  }
+
+  static void add_answer(Lookup& lookup, std::uint16_t type,
+    const std::vector<IpAddress>& addresses, int error)
+  {
+    auto& target = (type == TypeAaaa) ? lookup.ipv6 : lookup.ipv4;
+    target.insert(target.end(), addresses.begin(), addresses.end());
+    if (error && (!lookup.error || lookup.error == EAI_NONAME))
+    {
+      lookup.error = error;
+    }
+  }
+
+  static void finish(Lookup& lookup)
+  {
+    if (lookup.ipv6.empty() && lookup.ipv4.empty())
+    {
+      lookup.handler(create_addrinfo_error(lookup.error ? lookup.error : EAI_NONAME));
+      return;
+    }
+
+    std::vector<IpEndPoint> endPoints;
+    endPoints.reserve(lookup.ipv6.size() + lookup.ipv4.size());
+    for (auto* addresses : {&lookup.ipv6, &lookup.ipv4})
+    {
+      for (auto& address : *addresses)
+      {
+        endPoints.emplace_back(address, lookup.port);
+      }
+    }
+
+    lookup.handler(std::move(endPoints));
+  }
+
+private:
+  Options options_;
+  Reactor reactor_;
+  // One connected socket per name server, so that answers can only come from
+  // the server which was asked.
+  std::vector<Socket> sockets_;
+  std::thread thread_{};
+  std::atomic<bool> stopping_{false};
+
+  // Guards the cache and the lookups queued for the resolver's thread.
+  mutable std::mutex mutex_{};
+  std::unordered_map<Key, CacheEntry, KeyHash> cache_{};
+  std::vector<std::pair<Key, std::shared_ptr<Lookup>>> queued_{};
+
+  // Only used by the resolver's thread.
+  std::unordered_map<Key, Query, KeyHash> queries_{};
+  std::unordered_map<std::uint16_t, Key> ids_{};
+  std::mt19937 random_;
+  std::array<std::uint8_t, MaxMessageSize> buffer_{};
+
+  void run() noexcept
+  {
+    while (!stopping_.load(std::memory_order_acquire))
+    {
+      auto dispatched = reactor_.run_once(next_timeout());
+      jvs::consume_error(dispatched.take_error());
+      start_queued();
+      expire();
+    }
+
+    cancel_all();
+  }
+
+  std::chrono::milliseconds next_timeout() const noexcept
+  {
+    if (queries_.empty())
+    {
+      return std::chrono::milliseconds(-1);
+    }
+
+    auto deadline = Clock::time_point::max();
+    for (auto& [key, query] : queries_)
+    {
+      deadline = std::min(deadline, query.deadline);
+    }
+
+    auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - Clock::now());
+    return std::max(remaining, std::chrono::milliseconds(0));
+  }
+
+  void start_queued()
+  {
+    std::vector<std::pair<Key, std::shared_ptr<Lookup>>> queued;
+    {
+      std::lock_guard lock(mutex_);
+      queued.swap(queued_);
+    }
+
+    for (auto& [key, lookup] : queued)
+    {
+      auto [found, inserted] = queries_.try_emplace(key);
+      found->second.waiters.push_back(std::move(lookup));
+      if (inserted)
+      {
+        send(found->first, found->second);
+      }
+    }
+  }
+
+  // Sends the query to the server chosen by its attempt number, under a fresh
+  // ID.
+  void send(const Key& key, Query& query)
+  {
+    if (query.id)
+    {
+      ids_.erase(*query.id);
+    }
+
+    std::uniform_int_distribution<unsigned> distribution(0, 0xffff);
+    std::uint16_t id;
+    do
+    {
+      id = static_cast<std::uint16_t>(distribution(random_));
+    } while (ids_.contains(id));
+
+    query.id = id;
+    ids_.emplace(id, key);
+    query.deadline = Clock::now() + options_.timeout;
+    auto message = build_query(id, key.name, key.type);
+    auto sent = sockets_[query.attempt % sockets_.size()].send(message.data(), message.size());
+    if (!sent)
+    {
+      // Move on to the next server straight away.
+      jvs::consume_error(sent.take_error());
+      query.deadline = Clock::now();
+    }
+  }
+
+  void receive(std::size_t server)
+  {
+    for (;;)
+    {
+      auto received = sockets_[server].recv(buffer_.data(), buffer_.size());
+      if (!received)
+      {
+        if (!received.error_is_a<NonBlockingStatus>())
+        {
+          // Most likely an ICMP error (e.g. nothing listening on the server
+          // port); give up on this server for the queries waiting on it.
+          for (auto& [key, query] : queries_)
+          {
+            if (query.attempt % sockets_.size() == server)
+            {
+              query.deadline = Clock::now();
+            }
+          }
+        }
+
+        jvs::consume_error(received.take_error());
+        return;
+      }
+
+      handle_response(server, std::span<const std::uint8_t>(buffer_.data(), *received));
+    }
+  }
+
+  void handle_response(std::size_t server, std::span<const std::uint8_t> message)
+  {
+    auto id = response_id(message);
+    auto idEntry = id ? ids_.find(*id) : ids_.end();
+    if (idEntry == ids_.end())
+    {
+      return;
+    }
+
+    auto found = queries_.find(idEntry->second);
+    if (found == queries_.end() || found->second.attempt % sockets_.size() != server)
+    {
+      return;
+    }
+
+    auto response = parse_response(message, found->first.name, found->first.type);
+    if (!response)
+    {
+      return;
+    }
+
+    if (response->rcode == RCodeNxDomain ||
+      (response->rcode == RCodeNoError && !response->truncated) ||
+      !response->addresses.empty())
+    {
+      int error = response->addresses.empty() ? EAI_NONAME : 0;
+      auto ttl = error ? options_.negative_ttl : std::chrono::seconds(response->ttl);
+      complete(found, std::move(response->addresses), error, ttl);
+      return;
+    }
+
+    // Server failures and refusals: ask the next server.
+    found->second.deadline = Clock::now();
+  }
+
+  void expire()
+  {
+    auto now = Clock::now();
+    std::size_t maxAttempts =
+      sockets_.size() * static_cast<std::size_t>(std::max(options_.attempts, 1));
+    for (auto it = queries_.begin(); it != queries_.end();)
+    {
+      auto current = it++;
+      if (current->second.deadline > now)
+      {
+        continue;
+      }
+
+      if (++current->second.attempt < maxAttempts)
+      {
+        send(current->first, current->second);
+      }
+      else
+      {
+        complete(current, {}, EAI_AGAIN, std::chrono::seconds(0));
+      }
+    }
+  }
+
+  void complete(std::unordered_map<Key, Query, KeyHash>::iterator found,
+    std::vector<IpAddress> addresses, int error, std::chrono::seconds ttl)
+  {
+    auto key = std::move(found->first);
+    auto query = std::move(found->second);
+    queries_.erase(found);
+    if (query.id)
+    {
+      ids_.erase(*query.id);
+    }
+
+    ttl = std::min(ttl, options_.max_ttl);
+    if (ttl.count() > 0)
+    {
+      std::lock_guard lock(mutex_);
+      insert_cache(key, CacheEntry{addresses, error, Clock::now() + ttl});
+    }
+
+    for (auto& waiter : query.waiters)
+    {
+      add_answer(*waiter, key.type, addresses, error);
+      if (--waiter->remaining == 0)
+      {
+        finish(*waiter);
+      }
+    }
+  }
+
+  // Requires mutex_ to be held.
+  void insert_cache(const Key& key, CacheEntry entry)
+  {
+    if (cache_.size() >= options_.max_cache_entries && !cache_.contains(key))
+    {
+      auto now = Clock::now();
+      std::erase_if(cache_, [&](const auto& item) { return item.second.expiry <= now; });
+      if (cache_.size() >= options_.max_cache_entries && !cache_.empty())
+      {
+        cache_.erase(cache_.begin());
+      }
+    }
+
+    if (options_.max_cache_entries > 0)
+    {
+      cache_.insert_or_assign(key, std::move(entry));
+    }
+  }
+
+  void cancel_all()
+  {
+    start_queued();
+    for (auto& [key, query] : queries_)
+    {
+      for (auto& waiter : query.waiters)
+      {
+        // Only report once for lookups waiting on two queries.
+        if (waiter->remaining != 0)
+        {
+          waiter->remaining = 0;
+          waiter->handler(make_error<SocketError>(ECANCELED));
+        }
+      }
+    }
+
+    queries_.clear();
+    ids_.clear();
+  }
+};
+
+Resolver::Resolver(Resolver&&) = default;
+
+Resolver& Resolver::operator=(Resolver&&) = default;
+
+Resolver::Resolver(ResolverImpl* impl) : impl_(impl)
+{
+}
+
+Resolver::~Resolver() = default;
+
+Expected<Resolver> Resolver::create() noexcept
+{
+  return create(Options{});
+}
+
+Expected<Resolver> Resolver::create(Options options) noexcept
+{
+  try
+  {
+    if (options.servers.empty())
+    {
+      options.servers = read_system_servers();
+    }
+
+    auto reactor = Reactor::create();
+    if (auto e = reactor.take_error())
+    {
+      return std::move(e);
+    }
+
+    std::vector<Socket> sockets;
+    sockets.reserve(options.servers.size());
+    auto closeAll = [&]
+    {
+      for (auto& s : sockets)
+      {
+        s.close();
+      }
+    };
+
+    for (auto& server : options.servers)
+    {
+      Socket s(server.address().family(), Socket::Transport::Udp, /*nonBlocking*/ true);
+      if (s.descriptor() < 0)
+      {
+        closeAll();
+        return create_socket_error(errcodes::EAFNoSupport);
+      }
+
+      auto connected = s.connect(server);
+      sockets.push_back(std::move(s));
+      if (auto e = connected.take_error())
+      {
+        closeAll();
+        return std::move(e);
+      }
+    }
+
+    Resolver resolver(new ResolverImpl(std::move(options), std::move(*reactor),
+      std::move(sockets)));
+    if (auto e = resolver.impl_->start())
+    {
+      return std::move(e);
+    }
+
+    return resolver;
+  }
+  catch (const std::bad_alloc&)
+  {
+    return make_error<SocketError>(errcodes::ENoBufs);
+  }
+}
+
+void Resolver::resolve(std::string_view host, NetworkU16 port, Handler handler)
+{
+  resolve(host, port, Family::Unspecified, std::move(handler));
+}
+
+void Resolver::resolve(std::string_view host, NetworkU16 port, Family family,
+  Handler handler)
+{
+  auto matches = [family](const IpAddress& address)
+  {
+    return family == Family::Unspecified || address.family() == family;
+  };
+
+  if (auto address = IpAddress::parse(host))
+  {
+    if (!matches(*address))
+    {
+      handler(create_addrinfo_error(EAI_NONAME));
+      return;
+    }
+
+    handler(std::vector<IpEndPoint>{IpEndPoint(*address, port)});
+    return;
+  }
+
+  auto name = normalize_name(host);
+  if (!name)
+  {
+    handler(create_addrinfo_error(EAI_NONAME));
+    return;
+  }
+
+  // RFC 6761 reserves localhost names for the loopback addresses.
+  if (is_localhost(*name))
+  {
+    std::vector<IpEndPoint> endPoints;
+    for (auto* address : {&IpAddress::ipv6_loopback(), &IpAddress::ipv4_loopback()})
+    {
+      if (matches(*address))
+      {
+        endPoints.emplace_back(*address, port);
+      }
+    }
+
+    handler(std::move(endPoints));
+    return;
+  }
+
+  impl_->resolve(std::move(*name), port, family, std::move(handler));
+}
+
+std::size_t Resolver::cached() const noexcept
+{
+  return impl_->cached();
+}
+
+void Resolver::clear_cache() noexcept
+{
+  impl_->clear_cache();
+}
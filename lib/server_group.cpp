@@ -0,0 +1,369 @@
+///
+/// @file server_group.cpp
+///
+/// Contains the implementation of jvs::net::ServerGroup, SO_REUSEPORT
+/// listeners served by one Reactor thread each.
+///
+
+#include <jvs-netlib/server_group.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <linux/filter.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+
+#if !defined(SO_ATTACH_REUSEPORT_CBPF)
+#define SO_ATTACH_REUSEPORT_CBPF 51
+#endif
+
+#include <jvs-netlib/socket_errors.h>
+
+#include "socket_impl.h"
+
+using namespace jvs;
+using namespace jvs::net;
+
+namespace
+{
+
+// CPUs the process may run on, in ascending order.
+std::vector<int> allowed_cpus() noexcept
+{
+  std::vector<int> cpus;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (::sched_getaffinity(0, sizeof(set), &set) == 0)
+  {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+      if (CPU_ISSET(cpu, &set))
+      {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+
+  return cpus;
+}
+
+// Makes the reuseport group pick the socket whose index equals the number of
+// the CPU handling the incoming packet (modulo the group size).
+Error attach_cpu_steering(Socket& member, std::size_t groupSize) noexcept
+{
+  sock_filter code[] = {
+    {BPF_LD | BPF_W | BPF_ABS, 0, 0, static_cast<std::uint32_t>(SKF_AD_OFF + SKF_AD_CPU)},
+    {BPF_ALU | BPF_MOD | BPF_K, 0, 0, static_cast<std::uint32_t>(groupSize)},
+    {BPF_RET | BPF_A, 0, 0, 0},
+  };
+
+  sock_fprog program{static_cast<unsigned short>(std::size(code)), code};
+  return member.set_option(SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &program, sizeof(program));
+}
+
+} // namespace
+
+class ServerGroup::ServerGroupImpl final
+{
+public:
+  // Reactor, listener and connections of one thread. The connection map is
+  // only touched from the worker's thread while it runs.
+  struct Worker
+  {
+    Reactor reactor;
+    Socket listener;
+    Handler handler;
+    std::unordered_map<std::intptr_t, Socket> connections{};
+    std::atomic<std::size_t> connection_count{0};
+    std::thread thread{};
+
+    Worker(Reactor r, Socket l, Handler h)
+      : reactor(std::move(r)), listener(std::move(l)), handler(std::move(h))
+    {
+    }
+
+    void accept_all() noexcept
+    {
+      for (;;)
+      {
+        auto accepted = listener.accept();
+        if (!accepted)
+        {
+          // Usually NonBlockingStatus; connections aborted before they were
+          // accepted or descriptor exhaustion are waited out the same way.
+          jvs::consume_error(accepted.take_error());
+          return;
+        }
+
+        auto descriptor = accepted->descriptor();
+        auto [connection, inserted] = connections.emplace(descriptor, std::move(*accepted));
+        auto e = reactor.add(connection->second, Reactor::Readable | Reactor::Writable,
+          [this, descriptor](Reactor::EventMask events) { serve(descriptor, events); });
+        if (e)
+        {
+          jvs::consume_error(std::move(e));
+          connection->second.close();
+          connections.erase(connection);
+          continue;
+        }
+
+        connection_count.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    void serve(std::intptr_t descriptor, Reactor::EventMask events) noexcept
+    {
+      auto connection = connections.find(descriptor);
+      if (connection == connections.end())
+      {
+        return;
+      }
+
+      if (handler(connection->second, events) && (events & Reactor::Failed) == 0)
+      {
+        return;
+      }
+
+      jvs::consume_error(reactor.remove(connection->second));
+      connection->second.close();
+      connections.erase(connection);
+      connection_count.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void close_all() noexcept
+    {
+      for (auto& [descriptor, connection] : connections)
+      {
+        jvs::consume_error(reactor.remove(connection));
+        connection.close();
+      }
+
+      connections.clear();
+      connection_count.store(0, std::memory_order_relaxed);
+      jvs::consume_error(reactor.remove(listener));
+      listener.close();
+    }
+  };
+
+  explicit ServerGroupImpl(IpEndPoint local)
+    : local_(local)
+  {
+  }
+
+  ~ServerGroupImpl()
+  {
+    stop();
+  }
+
+  const IpEndPoint& local() const noexcept
+  {
+    return local_;
+  }
+
+  std::size_t size() const noexcept
+  {
+    return workers_.size();
+  }
+
+  std::size_t connections() const noexcept
+  {
+    std::size_t total = 0;
+    for (auto& worker : workers_)
+    {
+      total += worker->connection_count.load(std::memory_order_relaxed);
+    }
+
+    return total;
+  }
+
+  // Opens the next listener of the group, bound to the end point of the
+  // first one, and its reactor.
+  Error add_worker(const Options& options, const Handler& handler)
+  {
+    auto reactor = Reactor::create();
+    if (auto e = reactor.take_error())
+    {
+      return e;
+    }
+
+    Socket listener(local_.address().family(), Socket::Transport::Tcp, /*nonBlocking*/ true);
+    if (listener.descriptor() < 0)
+    {
+      return create_socket_error(errcodes::EAFNoSupport);
+    }
+
+    auto listening = [&]() -> Expected<IpEndPoint>
+    {
+      if (auto e = listener.set_reuse_port(true))
+      {
+        return std::move(e);
+      }
+
+      auto bound = listener.bind(local_);
+      if (!bound)
+      {
+        return bound.take_error();
+      }
+
+      return listener.listen(options.backlog);
+    }();
+
+    if (!listening)
+    {
+      listener.close();
+      return listening.take_error();
+    }
+
+    local_ = *listening;
+    workers_.push_back(std::make_unique<Worker>(std::move(*reactor), std::move(listener), handler));
+    auto& worker = *workers_.back();
+    return worker.reactor.add(worker.listener, Reactor::Readable,
+      [&worker](Reactor::EventMask) { worker.accept_all(); });
+  }
+
+  Error attach_cpu_steering() noexcept
+  {
+    return ::attach_cpu_steering(workers_.front()->listener, workers_.size());
+  }
+
+  // With CPU steering, worker i must run on CPU i, which the steering
+  // program hands it the connections of; otherwise workers are spread over
+  // the allowed CPUs.
+  Error start(bool pinThreads, bool cpuSteering) noexcept
+  {
+    auto cpus = pinThreads ? allowed_cpus() : std::vector<int>{};
+    for (std::size_t i = 0; i < workers_.size(); ++i)
+    {
+      auto& worker = *workers_[i];
+      try
+      {
+        worker.thread = std::thread([&worker] { jvs::consume_error(worker.reactor.run()); });
+      }
+      catch (const std::system_error& e)
+      {
+        return make_error<SocketError>(e.code().value());
+      }
+
+      if (!cpus.empty())
+      {
+        // Best effort: a failure only costs locality.
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpuSteering ? static_cast<int>(i) : cpus[i % cpus.size()], &set);
+        ::pthread_setaffinity_np(worker.thread.native_handle(), sizeof(set), &set);
+      }
+    }
+
+    return Error::success();
+  }
+
+  void stop() noexcept
+  {
+    for (auto& worker : workers_)
+    {
+      worker->reactor.stop();
+    }
+
+    for (auto& worker : workers_)
+    {
+      if (worker->thread.joinable())
+      {
+        worker->thread.join();
+      }
+
+      worker->close_all();
+    }
+
+    workers_.clear();
+  }
+
+private:
+  IpEndPoint local_;
+  std::vector<std::unique_ptr<Worker>> workers_{};
+};
+
+ServerGroup::ServerGroup(ServerGroup&&) = default;
+
+ServerGroup& ServerGroup::operator=(ServerGroup&&) = default;
+
+ServerGroup::ServerGroup(ServerGroupImpl* impl) : impl_(impl)
+{
+}
+
+ServerGroup::~ServerGroup() = default;
+
+Expected<ServerGroup> ServerGroup::create(const IpEndPoint& localEndPoint,
+  Handler handler) noexcept
+{
+  return create(localEndPoint, std::move(handler), Options{});
+}
+
+Expected<ServerGroup> ServerGroup::create(const IpEndPoint& localEndPoint, Handler handler,
+  Options options) noexcept
+{
+  try
+  {
+    auto threads = options.threads;
+    if (threads == 0)
+    {
+      threads = std::max<std::size_t>(allowed_cpus().size(), 1);
+    }
+
+    ServerGroup group(new ServerGroupImpl(localEndPoint));
+    auto& impl = *group.impl_;
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+      if (auto e = impl.add_worker(options, handler))
+      {
+        return std::move(e);
+      }
+    }
+
+    if (options.cpu_steering)
+    {
+      if (auto e = impl.attach_cpu_steering())
+      {
+        return std::move(e);
+      }
+    }
+
+    if (auto e = impl.start(options.pin_threads, options.cpu_steering))
+    {
+      return std::move(e);
+    }
+
+    return group;
+  }
+  catch (const std::bad_alloc&)
+  {
+    return make_error<SocketError>(errcodes::ENoBufs);
+  }
+}
+
+const IpEndPoint& ServerGroup::local() const noexcept
+{
+  return impl_->local();
+}
+
+std::size_t ServerGroup::size() const noexcept
+{
+  return impl_->size();
+}
+
+std::size_t ServerGroup::connections() const noexcept
+{
+  return impl_->connections();
+}
+
+void ServerGroup::stop() noexcept
+{
+  impl_->stop();
+}
@@ -14,11 +14,14 @@
 #include <jvs-netlib/socket_context.h>
 #include <jvs-netlib/socket_errors.h>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <type_traits>
 
+#include "block_cache.h"
 #include "native_sockets.h"
 #include "socket_impl.h"
 #include "socket_info.h"
@@ -30,6 +33,7 @@
 #else
 #include "bsd_sockets_impl.h"
 #include <jvs-netlib/socket.h>
+#include <fcntl.h>
 #endif
 
 using namespace jvs;
@@ -37,33 +41,14 @@ using namespace jvs::net;
 using Family = IpAddress::Family;
 using Transport = Socket::Transport;
 
-// namespace injection for ConvertCast
-namespace jvs
-{
-
-template <>
-struct ConvertCast<sockaddr, jvs::net::IpEndPoint>
-{
-  Expected<jvs::net::IpEndPoint> operator()(const sockaddr& addr) const noexcept;
-};
-
-template <>
-struct ConvertCast<sockaddr_storage, jvs::net::IpEndPoint>
-{
-  Expected<jvs::net::IpEndPoint> operator()(const sockaddr_storage& addr) const noexcept;
-};
-
-template <>
-struct ConvertCast<IpEndPoint, sockaddr>
-{
-  sockaddr_storage operator()(const IpEndPoint& ep) const noexcept;
-};
-
-}  // namespace jvs
-
 namespace
 {
 
+// Accepted connections are typically created and destroyed on the same event
+// loop thread, so the implementation objects are recycled per thread instead
+// of going through the global heap for every connection.
+constexpr std::size_t MaxCachedSocketImpls = 256;
+
 using GetNameFunc = decltype(::getsockname)*;
 
 IpAddress get_ip_address(const addrinfo& addrInfo) noexcept
@@ -191,17 +176,34 @@ SocketInfo::SocketInfo(SocketContext ctx) : context_(ctx)
 {
   if (auto localEndpoint = get_local_endpoint(ctx))
   {
-    address_ = localEndpoint->address();
+    set_address(localEndpoint->address());
     port_ = localEndpoint->port();
-    family_ = address_.family();
   }
 }
 
+SocketInfo::SocketInfo(SocketContext ctx, const SocketInfo& listener)
+  : SocketInfo(listener)
+{
+  context_ = ctx;
+}
+
 const IpAddress& SocketInfo::address() const noexcept
 {
   return address_;
 }
 
+SocketInfo& SocketInfo::set_address(const IpAddress& address) noexcept
+{
+  address_ = address;
+  family_ = address_.family();
+  return *this;
+}
+
+bool SocketInfo::has_wildcard_address() const noexcept
+{
+  return address_ == IpAddress::ipv4_any() || address_ == IpAddress::ipv6_any();
+}
+
 Family SocketInfo::family() const noexcept
 {
   return family_;
@@ -313,11 +315,32 @@ void SocketInfo::reset() noexcept
 // Common Socket::SocketImpl implementations
 ////////////////////////////////////////////////////////////////////////////////
 
+void* Socket::SocketImpl::operator new(std::size_t size)
+{
+  return BlockCache<sizeof(SocketImpl), MaxCachedSocketImpls>::allocate(size);
+}
+
+void Socket::SocketImpl::operator delete(void* p) noexcept
+{
+  BlockCache<sizeof(SocketImpl), MaxCachedSocketImpls>::deallocate(p);
+}
+
+IpEndPoint Socket::SocketImpl::local_endpoint() noexcept
+{
+  if (local_pending_)
+  {
+    update_local_endpoint();
+  }
+
+  return IpEndPoint(socket_info_.address(), socket_info_.port());
+}
+
 bool Socket::SocketImpl::update_local_endpoint() noexcept
 {
   if (auto localEp = get_local_endpoint(socket_info_.context()))
   {
-    local_endpoint_ = *localEp;
+    socket_info_.set_address(localEp->address()).set_port(localEp->port());
+    local_pending_ = false;
     return true;
   }
 
@@ -345,20 +368,61 @@ Socket::Socket(IpAddress::Family addressFamily, Socket::Transport transport)
 {
 }
 
-Socket::Socket(Socket::SocketImpl* impl) : impl_(impl)
+Socket::Socket(
+  IpAddress::Family addressFamily, Socket::Transport transport, bool nonBlocking)
+  : Socket(addressFamily, transport)
 {
+  if (nonBlocking)
+  {
+    if (auto e = set_nonblocking(true))
+    {
+      // Callers expect non-blocking operations; a blocking socket would be
+      // worse than none.
+      jvs::consume_error(std::move(e));
+      close();
+    }
+  }
 }
 
-Socket::~Socket() = default;
+Socket::Socket(Socket::SocketImpl* impl) : impl_(impl)
+{
+}
 
-IpEndPoint Socket::local() const noexcept
+Expected<Socket> Socket::adopt(std::intptr_t descriptor) noexcept
 {
-  if (impl_->local_endpoint_)
+  auto ctx = static_cast<SocketContext>(descriptor);
+  int type = 0;
+  socklen_t typeLength = static_cast<socklen_t>(sizeof(type));
+  if (is_error_result(::getsockopt(ctx, SOL_SOCKET, SO_TYPE,
+    reinterpret_cast<char*>(&type), &typeLength)))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  SocketImpl* impl = new SocketImpl(ctx);
+  Socket adopted(impl);
+  // Unix domain and other non-IP sockets have no IpEndPoint; the descriptor
+  // stays open and owned by the caller.
+  if (impl->socket_info_.family() == Family::Unspecified)
   {
-    return *impl_->local_endpoint_;
+    return create_socket_error(errcodes::EAFNoSupport);
   }
 
-  return IpEndPoint(impl_->socket_info_.address(), impl_->socket_info_.port());
+  impl->socket_info_.set_transports(static_cast<SocketTransport>(type));
+  // Fails with ENOTCONN for listening and unconnected sockets.
+  impl->update_remote_endpoint();
+#if !defined(_WIN32)
+  int flags = ::fcntl(ctx, F_GETFL, 0);
+  impl->nonblocking_ = !is_error_result(flags) && (flags & O_NONBLOCK) != 0;
+#endif
+  return adopted;
+}
+
+Socket::~Socket() = default;
+
+IpEndPoint Socket::local() const noexcept
+{
+  return impl_->local_endpoint();
 }
 
 const std::optional<IpEndPoint>& Socket::remote() const noexcept
@@ -371,20 +435,89 @@ std::intptr_t Socket::descriptor() const noexcept
   return static_cast<std::intptr_t>(impl_->socket_info_.context());
 }
 
+bool Socket::is_nonblocking() const noexcept
+{
+  return impl_->nonblocking_;
+}
+
+Error Socket::set_nonblocking(bool nonBlocking) noexcept
+{
+  if (is_error_result(set_socket_nonblocking(impl_->socket_info_.context(), nonBlocking)))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  impl_->nonblocking_ = nonBlocking;
+  return Error::success();
+}
+
+Error Socket::set_option(int level, int name, const void* value, std::size_t length) noexcept
+{
+  if (is_error_result(::setsockopt(impl_->socket_info_.context(), level, name,
+    reinterpret_cast<const char*>(value), static_cast<socklen_t>(length))))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  return Error::success();
+}
+
+Expected<std::size_t> Socket::get_option(int level, int name, void* value,
+  std::size_t length) noexcept
+{
+  auto optionLength = static_cast<socklen_t>(length);
+  if (is_error_result(::getsockopt(impl_->socket_info_.context(), level, name,
+    reinterpret_cast<char*>(value), &optionLength)))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  return static_cast<std::size_t>(optionLength);
+}
+
 Expected<Socket> Socket::accept() noexcept
 {
   sockaddr_storage remoteAddrInfo {};
   socklen_t addrLen = static_cast<socklen_t>(sizeof(remoteAddrInfo));
+#if defined(__linux__)
+  // The accepted socket inherits the listener's blocking mode in the same
+  // call instead of through a separate fcntl.
+  int acceptFlags = SOCK_CLOEXEC | (impl_->nonblocking_ ? SOCK_NONBLOCK : 0);
+  auto remoteCtx = ::accept4(impl_->socket_info_.context(),
+    reinterpret_cast<sockaddr*>(&remoteAddrInfo), &addrLen, acceptFlags);
+#else
   auto remoteCtx =
     ::accept(impl_->socket_info_.context(), reinterpret_cast<sockaddr*>(&remoteAddrInfo), &addrLen);
+#endif
   if (is_error_result(remoteCtx))
   {
     return create_socket_error(impl_->socket_info_.context());
   }
 
-  SocketImpl* impl = new SocketImpl(SocketContext(remoteCtx));
+  SocketImpl* impl = new SocketImpl(SocketContext(remoteCtx), impl_->socket_info_);
   Socket remoteSock(impl);
-  remoteSock.impl_->update_remote_endpoint();
+  if (auto remoteEp = convert_to<IpEndPoint>(remoteAddrInfo))
+  {
+    impl->remote_endpoint_ = *remoteEp;
+  }
+  else
+  {
+    jvs::consume_error(remoteEp.take_error());
+  }
+
+#if defined(__linux__)
+  impl->nonblocking_ = impl_->nonblocking_;
+#else
+  if (impl_->nonblocking_)
+  {
+    if (auto e = remoteSock.set_nonblocking(true))
+    {
+      remoteSock.close();
+      return std::move(e);
+    }
+  }
+#endif
+
   return remoteSock;
 }
 
@@ -398,7 +531,9 @@ Expected<IpEndPoint> Socket::bind(IpEndPoint localEndPoint) noexcept
     return create_socket_error(impl_->socket_info_.context());
   }
 
-  impl_->update_local_endpoint();
+  // Only an ephemeral port needs to be looked up.
+  impl_->socket_info_.set_address(localEndPoint.address()).set_port(localEndPoint.port());
+  impl_->local_pending_ = (localEndPoint.port() == 0);
   return local();
 }
 
@@ -433,12 +568,9 @@ Expected<IpEndPoint> Socket::connect(IpEndPoint remoteEndPoint) noexcept
     return create_socket_error(impl_->socket_info_.context());
   }
 
-  impl_->update_remote_endpoint();
-  if (remote())
-  {
-    return *remote();
-  }
-
+  // The kernel picks the local end point while connecting.
+  impl_->remote_endpoint_ = remoteEndPoint;
+  impl_->local_pending_ = true;
   return remoteEndPoint;
 }
 
@@ -447,6 +579,35 @@ Expected<IpEndPoint> Socket::connect(IpAddress remoteAddress, NetworkU16 remoteP
   return connect(IpEndPoint(remoteAddress, remotePort));
 }
 
+Error Socket::connect_result() noexcept
+{
+  auto ecode = get_pending_error(impl_->socket_info_.context());
+  if (!ecode)
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  return create_socket_error(*ecode);
+}
+
+Expected<IpEndPoint> Socket::finish_connect() noexcept
+{
+  if (auto e = connect_result())
+  {
+    return std::move(e);
+  }
+
+  // No error is pending, but the connection may not have been established
+  // yet; the peer name is only available once it has.
+  if (!impl_->update_remote_endpoint())
+  {
+    return create_socket_error(errcodes::EInProgress);
+  }
+
+  impl_->local_pending_ = true;
+  return *remote();
+}
+
 Expected<IpEndPoint> Socket::listen(int backlog) noexcept
 {
   int result = ::listen(impl_->socket_info_.context(), backlog);
@@ -455,7 +616,12 @@ Expected<IpEndPoint> Socket::listen(int backlog) noexcept
     return create_socket_error(impl_->socket_info_.context());
   }
 
-  impl_->update_local_endpoint();
+  // Listening on an unbound socket binds it to an ephemeral port.
+  if (impl_->socket_info_.port() == 0)
+  {
+    impl_->local_pending_ = true;
+  }
+
   return local();
 }
 
@@ -554,26 +720,227 @@ Expected<std::size_t> Socket::sendto(
   return sendto(buffer, length, /*flags*/ 0, remoteEp);
 }
 
-jvs::Expected<std::optional<std::string>> jvs::net::read(Socket& s)
+Expected<std::size_t> Socket::recvv(std::span<const std::span<std::byte>> buffers) noexcept
+{
+  return recvv(buffers, /*flags*/ 0);
+}
+
+Expected<std::size_t> Socket::sendv(
+  std::span<const std::span<const std::byte>> buffers) noexcept
+{
+  return sendv(buffers, /*flags*/ 0);
+}
+
+Expected<std::size_t> Socket::recv_batch(std::span<RecvSlot> slots, bool fillRemote) noexcept
+{
+  return recv_batch(slots, /*flags*/ 0, fillRemote);
+}
+
+Expected<std::size_t> Socket::recv_batch(std::span<RecvSlot> slots) noexcept
 {
-  char startBuf = 0;
-  auto recvResult = s.recv(&startBuf, 0);
-  if (auto e = recvResult.take_error())
+  return recv_batch(slots, /*flags*/ 0, /*fillRemote*/ true);
+}
+
+Expected<std::size_t> Socket::send_batch(std::span<SendSlot> slots) noexcept
+{
+  return send_batch(slots, /*flags*/ 0);
+}
+
+#if !defined(__linux__)
+
+// Fallbacks for systems without recvmmsg/sendmmsg or UDP segmentation
+// offload: one call per datagram. Only the first datagram of a batch is
+// waited for; the rest is whatever can be transferred without blocking (or
+// nothing more, if the system can't do per-call non-blocking I/O).
+
+Expected<std::size_t> Socket::recv_batch(
+  std::span<RecvSlot> slots, int flags, bool fillRemote) noexcept
+{
+  std::size_t count = std::min(slots.size(), MaxBatchDatagrams);
+  std::size_t receivedCount = 0;
+  for (; receivedCount < count; ++receivedCount)
   {
-    return std::move(e);
+    int callFlags = flags;
+    if (receivedCount > 0)
+    {
+#if defined(MSG_DONTWAIT)
+      callFlags |= MSG_DONTWAIT;
+#else
+      break;
+#endif
+    }
+
+    auto& slot = slots[receivedCount];
+    Expected<std::size_t> received = [&]() -> Expected<std::size_t>
+    {
+      if (!fillRemote)
+      {
+        return recv(slot.buffer.data(), slot.buffer.size(), callFlags);
+      }
+
+      auto result = recvfrom(slot.buffer.data(), slot.buffer.size(), callFlags);
+      if (!result)
+      {
+        return result.take_error();
+      }
+
+      slot.remote = result->second;
+      return result->first;
+    }();
+
+    if (!received)
+    {
+      if (receivedCount == 0)
+      {
+        return received.take_error();
+      }
+
+      jvs::consume_error(received.take_error());
+      break;
+    }
+
+    slot.length = *received;
   }
 
-  auto bytesToRead = s.available();
-  if (auto e = bytesToRead.take_error())
+  return receivedCount;
+}
+
+Expected<std::size_t> Socket::send_batch(std::span<SendSlot> slots, int flags) noexcept
+{
+  std::size_t count = std::min(slots.size(), MaxBatchDatagrams);
+  std::size_t sentCount = 0;
+  for (; sentCount < count; ++sentCount)
   {
-    return std::move(e);
+    auto& slot = slots[sentCount];
+    auto sent = (slot.remote.address().family() == Family::Unspecified)
+      ? send(slot.buffer.data(), slot.buffer.size(), flags)
+      : sendto(slot.buffer.data(), slot.buffer.size(), flags, slot.remote);
+    if (!sent)
+    {
+      if (sentCount == 0)
+      {
+        return sent.take_error();
+      }
+
+      jvs::consume_error(sent.take_error());
+      break;
+    }
+
+    slot.length = *sent;
+  }
+
+  return sentCount;
+}
+
+Expected<std::size_t> Socket::sendto_segmented(const void* buffer, std::size_t length,
+  std::size_t segmentSize, int flags, const IpEndPoint& remoteEp) noexcept
+{
+  if (segmentSize == 0 || segmentSize > std::numeric_limits<std::uint16_t>::max())
+  {
+    return create_socket_error(errcodes::EMsgSize);
+  }
+
+  auto* bytes = static_cast<const char*>(buffer);
+  std::size_t sentSize = 0;
+  while (sentSize < length)
+  {
+    std::size_t segmentLength = std::min(segmentSize, length - sentSize);
+    auto sent = (remoteEp.address().family() == Family::Unspecified)
+      ? send(bytes + sentSize, segmentLength, flags)
+      : sendto(bytes + sentSize, segmentLength, flags, remoteEp);
+    if (!sent)
+    {
+      if (sentSize == 0)
+      {
+        return sent.take_error();
+      }
+
+      jvs::consume_error(sent.take_error());
+      break;
+    }
+
+    sentSize += *sent;
+  }
+
+  return sentSize;
+}
+
+Error Socket::set_udp_gro(bool /*enabled*/) noexcept
+{
+  return create_socket_error(errcodes::EOpNotSupp);
+}
+
+Expected<Socket::SegmentedDatagram> Socket::recvfrom_segmented(
+  void* buffer, std::size_t length, int flags) noexcept
+{
+  auto received = recvfrom(buffer, length, flags);
+  if (!received)
+  {
+    return received.take_error();
   }
 
-  std::optional<std::string> buffer(std::in_place, *bytesToRead, static_cast<char>(0));
-  auto bytesRead = s.recv(buffer->data(), buffer->size());
+  SegmentedDatagram datagram{};
+  datagram.data = std::span(static_cast<std::byte*>(buffer), received->first);
+  datagram.segment_size = received->first;
+  datagram.remote = received->second;
+  return datagram;
+}
+
+Error Socket::set_zerocopy(bool /*enabled*/) noexcept
+{
+  return create_socket_error(errcodes::EOpNotSupp);
+}
+
+Expected<Socket::ZeroCopySend> Socket::send_zerocopy(
+  const void* /*buffer*/, std::size_t /*length*/, int /*flags*/) noexcept
+{
+  return create_socket_error(errcodes::EOpNotSupp);
+}
+
+Expected<Socket::ZeroCopyCompletion> Socket::recv_zerocopy_completion() noexcept
+{
+  return create_socket_error(errcodes::EOpNotSupp);
+}
+
+Expected<std::size_t> Socket::send_file(
+  int /*fd*/, std::int64_t /*offset*/, std::size_t /*count*/) noexcept
+{
+  return create_socket_error(errcodes::EOpNotSupp);
+}
+
+Expected<std::size_t> Socket::splice_from(int /*pipeFd*/, std::size_t /*count*/) noexcept
+{
+  return create_socket_error(errcodes::EOpNotSupp);
+}
+
+#endif // !__linux__
+
+Expected<Socket::ZeroCopySend> Socket::send_zerocopy(
+  const void* buffer, std::size_t length) noexcept
+{
+  return send_zerocopy(buffer, length, /*flags*/ 0);
+}
+
+Expected<std::size_t> Socket::sendto_segmented(const void* buffer, std::size_t length,
+  std::size_t segmentSize, const IpEndPoint& remoteEp) noexcept
+{
+  return sendto_segmented(buffer, length, segmentSize, /*flags*/ 0, remoteEp);
+}
+
+Expected<Socket::SegmentedDatagram> Socket::recvfrom_segmented(
+  void* buffer, std::size_t length) noexcept
+{
+  return recvfrom_segmented(buffer, length, /*flags*/ 0);
+}
+
+jvs::Expected<std::optional<std::string>> jvs::net::read(Socket& s)
+{
+  // One recv call; whatever doesn't fit is left for the next call.
+  std::array<char, ReadChunkSize> chunk;
+  auto bytesRead = s.recv(chunk.data(), chunk.size());
   if (auto e = bytesRead.take_error())
   {
-    return std::move(e);    
+    return std::move(e);
   }
 
   if (!*bytesRead)
@@ -582,7 +949,7 @@ jvs::Expected<std::optional<std::string>> jvs::net::read(Socket& s)
     return std::nullopt;
   }
 
-  return buffer;
+  return std::optional<std::string>(std::in_place, chunk.data(), *bytesRead);
 }
 
 jvs::Error jvs::net::write(Socket& s, std::string_view data)
@@ -607,3 +974,72 @@ jvs::Error jvs::net::write(Socket& s, std::string_view data)
 
   return Error::success();
 }
+
+jvs::Error jvs::net::write_all(
+  Socket& s, std::span<const std::span<const std::byte>> buffers)
+{
+  std::array<std::span<const std::byte>, Socket::MaxIoBuffers> pending;
+  std::size_t index = 0;
+  // Number of bytes of buffers[index] which have already been sent.
+  std::size_t offset = 0;
+  while (index < buffers.size())
+  {
+    if (offset == buffers[index].size())
+    {
+      ++index;
+      offset = 0;
+      continue;
+    }
+
+    std::size_t count = std::min(buffers.size() - index, pending.size());
+    std::copy_n(buffers.begin() + index, count, pending.begin());
+    pending[0] = pending[0].subspan(offset);
+    auto bytesSent = s.sendv(std::span(pending.data(), count));
+    if (auto e = bytesSent.take_error())
+    {
+      return e;
+    }
+
+    // Advance past everything that was sent, which may end in the middle of
+    // a buffer.
+    std::size_t sent = *bytesSent;
+    while (sent > 0)
+    {
+      std::size_t left = buffers[index].size() - offset;
+      if (sent < left)
+      {
+        offset += sent;
+        break;
+      }
+
+      sent -= left;
+      ++index;
+      offset = 0;
+    }
+  }
+
+  return Error::success();
+}
+
+jvs::Error jvs::net::write_file(Socket& s, int fd, std::int64_t offset, std::size_t count)
+{
+  std::size_t totalSent = 0;
+  while (totalSent < count)
+  {
+    auto bytesSent = s.send_file(fd, offset + static_cast<std::int64_t>(totalSent),
+      count - totalSent);
+    if (auto e = bytesSent.take_error())
+    {
+      return e;
+    }
+
+    if (*bytesSent == 0)
+    {
+      return make_error<StringError>("file shorter than requested");
+    }
+
+    totalSent += *bytesSent;
+  }
+
+  return Error::success();
+}
@@ -1,7 +1,15 @@
 #include <jvs-netlib/socket_errors.h>
 
+#include "block_cache.h"
 #include "socket_impl.h"
 
+namespace
+{
+
+using NonBlockingStatusCache = jvs::BlockCache<sizeof(jvs::net::NonBlockingStatus)>;
+
+} // namespace
+
 char jvs::net::SocketError::ID = 0;
 
 jvs::net::SocketError::SocketError(int code, const std::string& message)
@@ -11,7 +19,7 @@ jvs::net::SocketError::SocketError(int code, const std::string& message)
 }
 
 jvs::net::SocketError::SocketError(int code)
-  : SocketError(code, get_socket_error_message(code))
+  : code_(code)
 {
 }
 
@@ -27,10 +35,24 @@ bool jvs::net::SocketError::is_fatal() const
 
 void jvs::net::SocketError::log(std::ostream& os) const
 {
-  os << message_ << " (" << code_ << std::hex << " = 0x" << code_ << std::dec
+  if (message_.empty())
+  {
+    os << describe();
+  }
+  else
+  {
+    os << message_;
+  }
+
+  os << " (" << code_ << std::hex << " = 0x" << code_ << std::dec
     << ")";
 }
 
+std::string jvs::net::SocketError::describe() const
+{
+  return get_socket_error_message(code_);
+}
+
 char jvs::net::SocketErrorNonFatal::ID = 0;
 
 bool jvs::net::SocketErrorNonFatal::is_fatal() const
@@ -41,11 +63,26 @@ bool jvs::net::SocketErrorNonFatal::is_fatal() const
 char jvs::net::AddressInfoError::ID = 0;
 
 jvs::net::AddressInfoError::AddressInfoError(int code)
-  : Base(code, get_addrinfo_error_message(code))
+  : Base(code)
 {
 }
 
+std::string jvs::net::AddressInfoError::describe() const
+{
+  return get_addrinfo_error_message(code());
+}
+
 char jvs::net::NonBlockingStatus::ID = 0;
 
+void* jvs::net::NonBlockingStatus::operator new(std::size_t size)
+{
+  return NonBlockingStatusCache::allocate(size);
+}
+
+void jvs::net::NonBlockingStatus::operator delete(void* p) noexcept
+{
+  NonBlockingStatusCache::deallocate(p);
+}
+
 char jvs::net::UnsupportedError::ID = 0;
 
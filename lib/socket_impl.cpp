@@ -40,31 +40,23 @@ addrinfo jvs::net::create_hints(
 Expected<SocketInfo> jvs::net::create_socket(
   Family addressFamily, Transport transport) noexcept
 {
-  addrinfo hints = create_hints(addressFamily, transport);
-  addrinfo* ainfo;
-  int status =
-    ::getaddrinfo(/*nodeName*/ nullptr, /*serviceName*/ "0", &hints, &ainfo);
-  if (status == 0)
+  // A passive getaddrinfo lookup without a node name only ever yields the
+  // wildcard address of the family (IPv4 first when the family is
+  // unspecified), so build that directly rather than paying for the lookup
+  // on every construction.
+  SocketInfo result(addressFamily == Family::IPv6 ?
+    IpAddress::ipv6_any() : IpAddress::ipv4_any());
+  result.set_transports(get_socket_transport(transport));
+  SocketContext ctx = ::socket(get_address_family(result.family()),
+    static_cast<int>(result.socket_transport()),
+    static_cast<int>(result.network_transport()));
+  if (is_error_result(ctx))
   {
-    SocketInfo result(*ainfo);
-    ::freeaddrinfo(ainfo);
-    SocketContext ctx = ::socket(get_address_family(result.family()),
-      static_cast<int>(result.socket_transport()),
-      static_cast<int>(result.network_transport()));
-    result.set_context(ctx);
-    if (!is_error_result(ctx))
-    {
-      return result;
-    }
-    else
-    {
-      return create_socket_error(get_last_error());
-    }
-  }
-  else
-  {
-    return create_addrinfo_error(status);
+    return create_socket_error(get_last_error());
   }
+
+  result.set_context(ctx);
+  return result;
 }
 
 Error jvs::net::create_socket_error(int ecode) noexcept
@@ -88,19 +80,38 @@ Error jvs::net::create_socket_error(int ecode) noexcept
   return jvs::make_error<SocketError>(ecode);
 }
 
-Error jvs::net::create_socket_error(SocketContext s) noexcept
+std::optional<int> jvs::net::get_pending_error(SocketContext s) noexcept
 {
   int ecode{};
   socklen_t codeSize = static_cast<socklen_t>(sizeof(ecode));
-  int lastErr = get_last_error();
   auto result = ::getsockopt(
     s, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&ecode), &codeSize);
-  if (is_error_result(result) || (lastErr != 0 && ecode == 0))
+  if (is_error_result(result))
+  {
+    return std::nullopt;
+  }
+
+  return ecode;
+}
+
+Error jvs::net::create_socket_error(SocketContext s) noexcept
+{
+  int lastErr = get_last_error();
+  // Would-block results are the common case on non-blocking sockets, and a
+  // pending asynchronous error would have been reported by the failed call
+  // itself, so don't spend a getsockopt call on them.
+  if (lastErr == EAgain || lastErr == EWouldBlock)
+  {
+    return create_socket_error(lastErr);
+  }
+
+  auto ecode = get_pending_error(s);
+  if (!ecode || (lastErr != 0 && *ecode == 0))
   {
     return create_socket_error(lastErr);
   }
 
-  return create_socket_error(ecode);
+  return create_socket_error(*ecode);
 }
 
 Error jvs::net::create_addrinfo_error(int ecode) noexcept
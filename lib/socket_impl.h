@@ -8,6 +8,7 @@
 #if !defined(JVS_NETLIB_SOCKET_IMPL_H_)
 #define JVS_NETLIB_SOCKET_IMPL_H_
 
+#include <optional>
 #include <string>
 
 #include <jvs-netlib/error.h>
@@ -30,6 +31,10 @@ jvs::Expected<SocketInfo> create_socket(
 
 jvs::Error create_socket_error(SocketContext s) noexcept;
 
+// Reads (and clears) the pending error code of the socket via SO_ERROR.
+// Returns an empty value if the option couldn't be read.
+std::optional<int> get_pending_error(SocketContext s) noexcept;
+
 template <typename ResultT>
 static constexpr bool is_error_result(ResultT result) noexcept
 {
@@ -51,6 +56,10 @@ std::string get_socket_error_message(int ecode) noexcept;
 
 std::string get_addrinfo_error_message(int ecode) noexcept;
 
+// Returns 0 on success or -1 on failure (with the error available from
+// get_last_error()).
+int set_socket_nonblocking(SocketContext s, bool nonBlocking) noexcept;
+
 
 } // namespace jvs::net
 
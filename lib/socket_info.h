@@ -29,7 +29,17 @@ public:
 
   explicit SocketInfo(SocketContext ctx);
 
+  // Info for a socket accepted from a listener with the info `listener`; the
+  // address, port and transports are inherited.
+  SocketInfo(SocketContext ctx, const SocketInfo& listener);
+
   const IpAddress& address() const noexcept;
+
+  // Sets the address and the family to match it.
+  SocketInfo& set_address(const IpAddress& address) noexcept;
+
+  // True if the address is the IPv4 or IPv6 "any" address.
+  bool has_wildcard_address() const noexcept;
   
   IpAddress::Family family() const noexcept;
   
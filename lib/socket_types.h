@@ -3,11 +3,38 @@
 
 #include "native_sockets.h"
 
+#include <jvs-netlib/convert_cast.h>
+#include <jvs-netlib/error.h>
+#include <jvs-netlib/ip_end_point.h>
 #include <jvs-netlib/socket.h>
 #include <jvs-netlib/socket_context.h>
 
 #include "utils.h"
 
+// namespace injection for ConvertCast (implemented in socket.cpp)
+namespace jvs
+{
+
+template <>
+struct ConvertCast<sockaddr, jvs::net::IpEndPoint>
+{
+  Expected<jvs::net::IpEndPoint> operator()(const sockaddr& addr) const noexcept;
+};
+
+template <>
+struct ConvertCast<sockaddr_storage, jvs::net::IpEndPoint>
+{
+  Expected<jvs::net::IpEndPoint> operator()(const sockaddr_storage& addr) const noexcept;
+};
+
+template <>
+struct ConvertCast<jvs::net::IpEndPoint, sockaddr>
+{
+  sockaddr_storage operator()(const jvs::net::IpEndPoint& ep) const noexcept;
+};
+
+}  // namespace jvs
+
 namespace jvs::net
 {
 
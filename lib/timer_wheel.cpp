@@ -0,0 +1,294 @@
+///
+/// @file timer_wheel.cpp
+///
+/// Contains the implementation of jvs::net::TimerWheel.
+///
+/// A timer expiring at tick `e` is kept on the level of the highest 6-bit
+/// digit in which `e` differs from the current tick, in the slot given by
+/// that digit of `e`. When the wheel reaches the first tick of a slot on
+/// level L > 0 (digits below L all zero), the slot's timers are re-inserted
+/// and land on lower levels; the level 0 slot of the current tick holds the
+/// timers which expire now. Per-level occupancy bitmaps let advance() jump
+/// straight to the next tick at which a slot needs processing.
+///
+
+#include <jvs-netlib/timer_wheel.h>
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <utility>
+
+using namespace jvs::net;
+
+TimerWheel::Timer::Timer(Callback callback)
+  : callback_(std::move(callback))
+{
+}
+
+TimerWheel::Timer::~Timer()
+{
+  if (wheel_)
+  {
+    wheel_->cancel(*this);
+  }
+}
+
+void TimerWheel::Timer::set_callback(Callback callback)
+{
+  callback_ = std::move(callback);
+}
+
+bool TimerWheel::Timer::armed() const noexcept
+{
+  return wheel_ != nullptr;
+}
+
+TimerWheel::Clock::time_point TimerWheel::Timer::deadline() const noexcept
+{
+  if (!wheel_)
+  {
+    return Clock::time_point{};
+  }
+
+  return wheel_->start_ + wheel_->resolution_ * static_cast<Clock::rep>(expiry_);
+}
+
+TimerWheel::TimerWheel(Clock::duration resolution, Clock::time_point start) noexcept
+  : resolution_(std::max(resolution, Clock::duration(1))),
+  start_(start)
+{
+  for (auto& slot : slots_)
+  {
+    slot.prev = &slot;
+    slot.next = &slot;
+  }
+}
+
+TimerWheel::~TimerWheel()
+{
+  for (auto& slot : slots_)
+  {
+    while (slot.next != &slot)
+    {
+      auto& timer = static_cast<Timer&>(*slot.next);
+      unlink(timer);
+      timer.wheel_ = nullptr;
+    }
+  }
+}
+
+void TimerWheel::arm(Timer& timer, Clock::time_point deadline) noexcept
+{
+  if (timer.wheel_)
+  {
+    timer.wheel_->cancel(timer);
+  }
+
+  // Never earlier than the next tick, so that a callback re-arming its timer
+  // for the past can't keep advance() in the current tick.
+  timer.expiry_ = std::max(to_tick(deadline, /*roundUp*/ true), current_ + 1);
+  timer.wheel_ = this;
+  insert(timer);
+  ++size_;
+}
+
+void TimerWheel::arm(Timer& timer, Clock::duration delay) noexcept
+{
+  arm(timer, now() + delay);
+}
+
+void TimerWheel::cancel(Timer& timer) noexcept
+{
+  if (timer.wheel_ != this)
+  {
+    return;
+  }
+
+  unlink(timer);
+  timer.wheel_ = nullptr;
+  --size_;
+}
+
+std::size_t TimerWheel::advance(Clock::time_point now)
+{
+  auto target = to_tick(now, /*roundUp*/ false);
+  std::size_t fired = 0;
+  while (current_ < target)
+  {
+    auto next = (size_ == 0) ? target : std::min(next_event(), target);
+    current_ = next;
+    if (size_ == 0)
+    {
+      break;
+    }
+
+    // Cascade the slots starting at this tick, highest level first, so that
+    // timers can fall through several levels.
+    for (std::size_t level = LevelCount; level-- > 1;)
+    {
+      auto shift = level * SlotBits;
+      if ((current_ & ((std::uint64_t{1} << shift) - 1)) != 0)
+      {
+        continue;
+      }
+
+      Link list;
+      take(level * SlotCount + ((current_ >> shift) & (SlotCount - 1)), list);
+      while (list.next != &list)
+      {
+        auto& timer = static_cast<Timer&>(*list.next);
+        unlink(timer);
+        insert(timer);
+      }
+    }
+
+    Link expired;
+    take(current_ & (SlotCount - 1), expired);
+    while (expired.next != &expired)
+    {
+      // The list is re-read after every callback, which may have cancelled or
+      // re-armed the timers still on it.
+      auto& timer = static_cast<Timer&>(*expired.next);
+      unlink(timer);
+      timer.wheel_ = nullptr;
+      --size_;
+      ++fired;
+      timer.callback_();
+    }
+  }
+
+  return fired;
+}
+
+std::chrono::milliseconds TimerWheel::timeout(Clock::time_point now) const noexcept
+{
+  using std::chrono::milliseconds;
+  if (size_ == 0)
+  {
+    return milliseconds(-1);
+  }
+
+  // Capped, to keep far-off deadlines from overflowing the clock.
+  constexpr milliseconds MaxTimeout(std::numeric_limits<int>::max());
+  auto ticks = next_event() - current_;
+  auto maxTicks = static_cast<std::uint64_t>(
+    std::chrono::ceil<Clock::duration>(MaxTimeout) / resolution_);
+  if (ticks > maxTicks)
+  {
+    return MaxTimeout;
+  }
+
+  auto remaining = this->now() + resolution_ * static_cast<Clock::rep>(ticks) - now;
+  return std::max(std::chrono::ceil<milliseconds>(remaining), milliseconds(0));
+}
+
+TimerWheel::Clock::time_point TimerWheel::now() const noexcept
+{
+  return start_ + resolution_ * static_cast<Clock::rep>(current_);
+}
+
+TimerWheel::Clock::duration TimerWheel::resolution() const noexcept
+{
+  return resolution_;
+}
+
+std::size_t TimerWheel::size() const noexcept
+{
+  return size_;
+}
+
+void TimerWheel::insert(Timer& timer) noexcept
+{
+  auto difference = timer.expiry_ ^ current_;
+  std::size_t level = (difference == 0)
+    ? 0 : static_cast<std::size_t>(std::bit_width(difference) - 1) / SlotBits;
+  auto index = (timer.expiry_ >> (level * SlotBits)) & (SlotCount - 1);
+  timer.slot_ = static_cast<std::uint16_t>(level * SlotCount + index);
+
+  // Appended, so that timers of the same tick fire in the order they were
+  // armed.
+  auto& slot = slots_[timer.slot_];
+  timer.prev = slot.prev;
+  timer.next = &slot;
+  slot.prev->next = &timer;
+  slot.prev = &timer;
+  occupied_[level] |= std::uint64_t{1} << index;
+}
+
+void TimerWheel::unlink(Timer& timer) noexcept
+{
+  timer.prev->next = timer.next;
+  timer.next->prev = timer.prev;
+  timer.prev = nullptr;
+  timer.next = nullptr;
+
+  // The timer may be on a list taken off its slot (see take()), in which
+  // case the slot's bit is already clear unless new timers have arrived.
+  auto& slot = slots_[timer.slot_];
+  if (slot.next == &slot)
+  {
+    occupied_[timer.slot_ / SlotCount] &= ~(std::uint64_t{1} << (timer.slot_ % SlotCount));
+  }
+}
+
+void TimerWheel::take(std::size_t index, Link& list) noexcept
+{
+  auto& slot = slots_[index];
+  if (slot.next == &slot)
+  {
+    list.prev = &list;
+    list.next = &list;
+    return;
+  }
+
+  list.next = slot.next;
+  list.prev = slot.prev;
+  list.next->prev = &list;
+  list.prev->next = &list;
+  slot.prev = &slot;
+  slot.next = &slot;
+  occupied_[index / SlotCount] &= ~(std::uint64_t{1} << (index % SlotCount));
+}
+
+std::uint64_t TimerWheel::next_event() const noexcept
+{
+  // Every timer on level L is due before any timer on a higher level, so the
+  // lowest occupied level has the next event: the first occupied slot after
+  // the current tick's digit.
+  for (std::size_t level = 0; level < LevelCount; ++level)
+  {
+    auto shift = level * SlotBits;
+    auto digit = (current_ >> shift) & (SlotCount - 1);
+    auto later = (digit == SlotCount - 1)
+      ? 0
+      : occupied_[level] & (~std::uint64_t{0} << (digit + 1));
+    if (later == 0)
+    {
+      continue;
+    }
+
+    auto upperShift = shift + SlotBits;
+    auto upper = (upperShift >= 64) ? 0 : (current_ >> upperShift) << upperShift;
+    return upper | (static_cast<std::uint64_t>(std::countr_zero(later)) << shift);
+  }
+
+  return std::numeric_limits<std::uint64_t>::max();
+}
+
+std::uint64_t TimerWheel::to_tick(Clock::time_point t, bool roundUp) const noexcept
+{
+  if (t <= start_)
+  {
+    return 0;
+  }
+
+  auto elapsed = t - start_;
+  auto ticks = static_cast<std::uint64_t>(elapsed / resolution_);
+  if (roundUp && elapsed % resolution_ != Clock::duration::zero())
+  {
+    ++ticks;
+  }
+
+  return ticks;
+}
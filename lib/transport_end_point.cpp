@@ -84,3 +84,21 @@ std::string jvs::ConvertCast<jvs::net::TransportEndPoint,
 {
   return jvs::net::to_string(ep);
 }
+
+bool jvs::net::operator==(const TransportEndPoint& a, const TransportEndPoint& b) noexcept
+{
+  return a.transport() == b.transport() && a.ip_end_point() == b.ip_end_point();
+}
+
+bool jvs::net::operator!=(const TransportEndPoint& a, const TransportEndPoint& b) noexcept
+{
+  return !(a == b);
+}
+
+std::size_t std::hash<jvs::net::TransportEndPoint>::operator()(
+  const jvs::net::TransportEndPoint& ep) const noexcept
+{
+  auto h = std::hash<jvs::net::IpEndPoint>{}(ep.ip_end_point());
+  return h ^ (static_cast<std::size_t>(ep.transport()) *
+    static_cast<std::size_t>(0x9e3779b97f4a7c15ull));
+}
@@ -0,0 +1,113 @@
+///
+/// @file unix_end_point.cpp
+///
+/// Contains the implementation of jvs::net::UnixEndPoint.
+///
+
+#include <jvs-netlib/unix_end_point.h>
+
+#include <cerrno>
+#include <new>
+#include <utility>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <jvs-netlib/socket_errors.h>
+
+#include "socket_impl.h"
+
+using namespace jvs;
+using namespace jvs::net;
+
+// sun_path is NUL-terminated for paths and starts with a NUL for abstract
+// names, which takes one byte either way.
+const std::size_t UnixEndPoint::MaxNameLength = sizeof(sockaddr_un::sun_path) - 1;
+
+UnixEndPoint::UnixEndPoint(std::string name, bool abstract) noexcept
+  : name_(std::move(name)), abstract_(abstract)
+{
+}
+
+Expected<UnixEndPoint> UnixEndPoint::path(std::string_view path) noexcept
+{
+  if (path.empty() || path.find('\0') != std::string_view::npos)
+  {
+    return create_socket_error(EINVAL);
+  }
+
+  if (path.size() > MaxNameLength)
+  {
+    return create_socket_error(errcodes::ENameTooLong);
+  }
+
+  try
+  {
+    return UnixEndPoint(std::string(path), /*abstract*/ false);
+  }
+  catch (const std::bad_alloc&)
+  {
+    return create_socket_error(errcodes::ENoBufs);
+  }
+}
+
+Expected<UnixEndPoint> UnixEndPoint::abstract(std::string_view name) noexcept
+{
+#if defined(__linux__)
+  if (name.size() > MaxNameLength)
+  {
+    return create_socket_error(errcodes::ENameTooLong);
+  }
+
+  try
+  {
+    return UnixEndPoint(std::string(name), /*abstract*/ true);
+  }
+  catch (const std::bad_alloc&)
+  {
+    return create_socket_error(errcodes::ENoBufs);
+  }
+#else
+  return create_socket_error(errcodes::EOpNotSupp);
+#endif
+}
+
+Expected<UnixEndPoint> UnixEndPoint::parse(std::string_view unixEndPointString) noexcept
+{
+  if (!unixEndPointString.empty() && unixEndPointString.front() == '@')
+  {
+    return abstract(unixEndPointString.substr(1));
+  }
+
+  return path(unixEndPointString);
+}
+
+bool UnixEndPoint::is_unnamed() const noexcept
+{
+  return !abstract_ && name_.empty();
+}
+
+bool UnixEndPoint::is_abstract() const noexcept
+{
+  return abstract_;
+}
+
+const std::string& UnixEndPoint::name() const noexcept
+{
+  return name_;
+}
+
+std::string jvs::net::to_string(const UnixEndPoint& ep)
+{
+  return ep.is_abstract() ? "@" + ep.name() : ep.name();
+}
+
+bool jvs::net::operator==(const UnixEndPoint& a, const UnixEndPoint& b) noexcept
+{
+  return a.is_abstract() == b.is_abstract() && a.name() == b.name();
+}
+
+bool jvs::net::operator!=(const UnixEndPoint& a, const UnixEndPoint& b) noexcept
+{
+  return !(a == b);
+}
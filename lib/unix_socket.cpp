@@ -0,0 +1,429 @@
+///
+/// @file unix_socket.cpp
+///
+/// Contains the implementation of jvs::net::UnixSocket.
+///
+
+#include <jvs-netlib/unix_socket.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <jvs-netlib/socket_errors.h>
+
+#include "socket_impl.h"
+
+using namespace jvs;
+using namespace jvs::net;
+
+namespace
+{
+
+constexpr socklen_t PathOffset = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path));
+
+int to_socket_type(UnixSocket::Transport transport) noexcept
+{
+  return (transport == UnixSocket::Transport::SeqPacket) ? SOCK_SEQPACKET : SOCK_STREAM;
+}
+
+// Socket type flags applied atomically where supported.
+int creation_flags(bool nonBlocking) noexcept
+{
+#if defined(__linux__)
+  return SOCK_CLOEXEC | (nonBlocking ? SOCK_NONBLOCK : 0);
+#else
+  return 0;
+#endif
+}
+
+// Applies what creation_flags couldn't.
+int finish_creation(int fd, bool nonBlocking) noexcept
+{
+#if defined(__linux__)
+  // SOCK_CLOEXEC and SOCK_NONBLOCK were passed to socket() already.
+  (void)nonBlocking;
+  return fd;
+#else
+  if (fd >= 0 && (is_error_result(::fcntl(fd, F_SETFD, FD_CLOEXEC)) ||
+    (nonBlocking && is_error_result(set_socket_nonblocking(fd, true)))))
+  {
+    int ecode = get_last_error();
+    ::close(fd);
+    errno = ecode;
+    return -1;
+  }
+
+  return fd;
+#endif
+}
+
+socklen_t to_sockaddr(const UnixEndPoint& ep, sockaddr_un& addr) noexcept
+{
+  addr = {};
+  addr.sun_family = AF_UNIX;
+  auto& name = ep.name();
+  if (ep.is_abstract())
+  {
+    std::memcpy(addr.sun_path + 1, name.data(), name.size());
+    return PathOffset + 1 + static_cast<socklen_t>(name.size());
+  }
+
+  if (ep.is_unnamed())
+  {
+    return PathOffset;
+  }
+
+  std::memcpy(addr.sun_path, name.data(), name.size());
+  return PathOffset + static_cast<socklen_t>(name.size()) + 1;
+}
+
+Expected<UnixEndPoint> from_sockaddr(const sockaddr_un& addr, socklen_t length) noexcept
+{
+  if (length <= PathOffset)
+  {
+    return UnixEndPoint();
+  }
+
+  auto pathLength = std::min<std::size_t>(length - PathOffset, sizeof(addr.sun_path));
+  if (addr.sun_path[0] == '\0')
+  {
+    return UnixEndPoint::abstract(std::string_view(addr.sun_path + 1, pathLength - 1));
+  }
+
+  return UnixEndPoint::path(std::string_view(addr.sun_path, ::strnlen(addr.sun_path, pathLength)));
+}
+
+using GetNameFunc = decltype(::getsockname)*;
+
+Expected<UnixEndPoint> get_endpoint(int fd, GetNameFunc nameFunc) noexcept
+{
+  sockaddr_un addr{};
+  socklen_t length = static_cast<socklen_t>(sizeof(addr));
+  if (is_error_result(nameFunc(fd, reinterpret_cast<sockaddr*>(&addr), &length)))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  return from_sockaddr(addr, length);
+}
+
+} // namespace
+
+UnixSocket::UnixSocket(Transport transport)
+  : UnixSocket(transport, /*nonBlocking*/ false)
+{
+}
+
+UnixSocket::UnixSocket(Transport transport, bool nonBlocking)
+  : transport_(transport), nonblocking_(nonBlocking)
+{
+  descriptor_ = finish_creation(
+    ::socket(AF_UNIX, to_socket_type(transport) | creation_flags(nonBlocking), 0), nonBlocking);
+}
+
+UnixSocket::UnixSocket(int descriptor, Transport transport, bool nonBlocking) noexcept
+  : descriptor_(descriptor), transport_(transport), nonblocking_(nonBlocking)
+{
+}
+
+UnixSocket::UnixSocket(UnixSocket&& other) noexcept
+  : descriptor_(std::exchange(other.descriptor_, -1)),
+  transport_(other.transport_),
+  nonblocking_(std::exchange(other.nonblocking_, false))
+{
+}
+
+UnixSocket& UnixSocket::operator=(UnixSocket&& other) noexcept
+{
+  if (this != &other)
+  {
+    descriptor_ = std::exchange(other.descriptor_, -1);
+    transport_ = other.transport_;
+    nonblocking_ = std::exchange(other.nonblocking_, false);
+  }
+
+  return *this;
+}
+
+UnixSocket::~UnixSocket() = default;
+
+Expected<std::pair<UnixSocket, UnixSocket>> UnixSocket::pair(Transport transport) noexcept
+{
+  return pair(transport, /*nonBlocking*/ false);
+}
+
+Expected<std::pair<UnixSocket, UnixSocket>> UnixSocket::pair(
+  Transport transport, bool nonBlocking) noexcept
+{
+  int fds[2];
+  if (is_error_result(::socketpair(AF_UNIX,
+    to_socket_type(transport) | creation_flags(nonBlocking), 0, fds)))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  fds[0] = finish_creation(fds[0], nonBlocking);
+  fds[1] = finish_creation(fds[1], nonBlocking);
+  if (fds[0] < 0 || fds[1] < 0)
+  {
+    int ecode = get_last_error();
+    for (int fd : fds)
+    {
+      if (fd >= 0)
+      {
+        ::close(fd);
+      }
+    }
+
+    return create_socket_error(ecode);
+  }
+
+  return std::pair(UnixSocket(fds[0], transport, nonBlocking),
+    UnixSocket(fds[1], transport, nonBlocking));
+}
+
+UnixSocket::Transport UnixSocket::transport() const noexcept
+{
+  return transport_;
+}
+
+std::intptr_t UnixSocket::descriptor() const noexcept
+{
+  return descriptor_;
+}
+
+bool UnixSocket::is_nonblocking() const noexcept
+{
+  return nonblocking_;
+}
+
+Error UnixSocket::set_nonblocking(bool nonBlocking) noexcept
+{
+  if (is_error_result(set_socket_nonblocking(descriptor_, nonBlocking)))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  nonblocking_ = nonBlocking;
+  return Error::success();
+}
+
+Expected<UnixEndPoint> UnixSocket::local() const noexcept
+{
+  return get_endpoint(descriptor_, ::getsockname);
+}
+
+Expected<UnixEndPoint> UnixSocket::remote() const noexcept
+{
+  return get_endpoint(descriptor_, ::getpeername);
+}
+
+Expected<UnixEndPoint> UnixSocket::bind(const UnixEndPoint& localEndPoint) noexcept
+{
+  sockaddr_un addr;
+  auto length = to_sockaddr(localEndPoint, addr);
+  if (is_error_result(::bind(descriptor_, reinterpret_cast<sockaddr*>(&addr), length)))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  return local();
+}
+
+Expected<UnixEndPoint> UnixSocket::listen() noexcept
+{
+  return listen(SOMAXCONN);
+}
+
+Expected<UnixEndPoint> UnixSocket::listen(int backlog) noexcept
+{
+  if (is_error_result(::listen(descriptor_, backlog)))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  return local();
+}
+
+Expected<UnixSocket> UnixSocket::accept() noexcept
+{
+#if defined(__linux__)
+  int fd = ::accept4(descriptor_, nullptr, nullptr, creation_flags(nonblocking_));
+#else
+  int fd = finish_creation(::accept(descriptor_, nullptr, nullptr), nonblocking_);
+#endif
+  if (is_error_result(fd))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  return UnixSocket(fd, transport_, nonblocking_);
+}
+
+Expected<UnixEndPoint> UnixSocket::connect(const UnixEndPoint& remoteEndPoint) noexcept
+{
+  sockaddr_un addr;
+  auto length = to_sockaddr(remoteEndPoint, addr);
+  if (is_error_result(::connect(descriptor_, reinterpret_cast<sockaddr*>(&addr), length)))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  return remoteEndPoint;
+}
+
+Expected<std::size_t> UnixSocket::recv(void* buffer, std::size_t length, int flags) noexcept
+{
+  auto received = ::recv(descriptor_, buffer, length, flags);
+  if (is_error_result(received))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  return static_cast<std::size_t>(received);
+}
+
+Expected<std::size_t> UnixSocket::recv(void* buffer, std::size_t length) noexcept
+{
+  return recv(buffer, length, /*flags*/ 0);
+}
+
+Expected<std::size_t> UnixSocket::send(const void* buffer, std::size_t length, int flags) noexcept
+{
+  auto sent = ::send(descriptor_, buffer, length, flags);
+  if (is_error_result(sent))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  return static_cast<std::size_t>(sent);
+}
+
+Expected<std::size_t> UnixSocket::send(const void* buffer, std::size_t length) noexcept
+{
+  return send(buffer, length, /*flags*/ 0);
+}
+
+Expected<std::size_t> UnixSocket::send_fds(const void* buffer, std::size_t length,
+  std::span<const int> fds) noexcept
+{
+  // Descriptors travel as ancillary data of a data byte; without data they
+  // would be lost on stream sockets.
+  if (length == 0 || fds.size() > MaxFds)
+  {
+    return create_socket_error(EINVAL);
+  }
+
+  // Aligned storage for the largest control message.
+  union
+  {
+    char buffer[CMSG_SPACE(sizeof(int) * MaxFds)];
+    cmsghdr align;
+  } control;
+
+  iovec vector{const_cast<void*>(buffer), length};
+  msghdr message{};
+  message.msg_iov = &vector;
+  message.msg_iovlen = 1;
+  if (!fds.empty())
+  {
+    std::memset(control.buffer, 0, sizeof(control.buffer));
+    message.msg_control = control.buffer;
+    message.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+    auto header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+    std::memcpy(CMSG_DATA(header), fds.data(), sizeof(int) * fds.size());
+  }
+
+  auto sent = ::sendmsg(descriptor_, &message, 0);
+  if (is_error_result(sent))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  return static_cast<std::size_t>(sent);
+}
+
+Expected<UnixSocket::ReceivedFds> UnixSocket::recv_fds(void* buffer, std::size_t length,
+  std::span<int> fds) noexcept
+{
+  union
+  {
+    char buffer[CMSG_SPACE(sizeof(int) * MaxFds)];
+    cmsghdr align;
+  } control;
+
+  auto capacity = std::min(fds.size(), MaxFds);
+  iovec vector{buffer, length};
+  msghdr message{};
+  message.msg_iov = &vector;
+  message.msg_iovlen = 1;
+  // Even with no room for descriptors, a control buffer is passed so that
+  // MSG_CTRUNC reports (and the kernel closes) the ones sent.
+  message.msg_control = control.buffer;
+  message.msg_controllen = CMSG_SPACE(sizeof(int) * std::max<std::size_t>(capacity, 1));
+#if defined(MSG_CMSG_CLOEXEC)
+  int flags = MSG_CMSG_CLOEXEC;
+#else
+  int flags = 0;
+#endif
+  auto received = ::recvmsg(descriptor_, &message, flags);
+  if (is_error_result(received))
+  {
+    return create_socket_error(get_last_error());
+  }
+
+  ReceivedFds result{static_cast<std::size_t>(received), 0, (message.msg_flags & MSG_CTRUNC) != 0};
+  for (auto header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header))
+  {
+    if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_RIGHTS)
+    {
+      continue;
+    }
+
+    auto count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+      int fd;
+      std::memcpy(&fd, CMSG_DATA(header) + i * sizeof(int), sizeof(fd));
+      if (result.fd_count < capacity)
+      {
+        fds[result.fd_count++] = fd;
+#if !defined(MSG_CMSG_CLOEXEC)
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+#endif
+      }
+      else
+      {
+        // Only possible with the padding of the control buffer.
+        ::close(fd);
+        result.truncated = true;
+      }
+    }
+  }
+
+  return result;
+}
+
+int UnixSocket::close() noexcept
+{
+  if (descriptor_ < 0)
+  {
+    return 0;
+  }
+
+  nonblocking_ = false;
+  return ::close(std::exchange(descriptor_, -1));
+}
@@ -1,5 +1,7 @@
 #include "winsock_impl.h"
 
+#include <algorithm>
+#include <array>
 #include <string>
 #include <tuple>
 
@@ -88,6 +90,20 @@ static std::string getWinsockAddrInfoErrorMessage(int ecode) noexcept
   return getWinsockErrorMessage(translateWinsockAddrInfoError(ecode));
 }
 
+template <typename ByteT>
+static DWORD fillWsaBuffers(std::array<WSABUF, Socket::MaxIoBuffers>& wsaBuffers,
+  std::span<const std::span<ByteT>> buffers) noexcept
+{
+  std::size_t count = std::min(buffers.size(), wsaBuffers.size());
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    wsaBuffers[i].buf = reinterpret_cast<CHAR*>(const_cast<std::byte*>(buffers[i].data()));
+    wsaBuffers[i].len = static_cast<ULONG>(buffers[i].size());
+  }
+
+  return static_cast<DWORD>(count);
+}
+
 static auto initWinsock() noexcept
 {
   struct { int Code{WSAVERNOTSUPPORTED}; WSADATA Data; } result;
@@ -118,6 +134,15 @@ Socket::SocketImpl::SocketImpl(SocketContext ctx)
   data_ = initResult.Data;
 }
 
+Socket::SocketImpl::SocketImpl(SocketContext ctx, const SocketInfo& listenerInfo)
+  : socket_info_(ctx, listenerInfo),
+  local_pending_(listenerInfo.has_wildcard_address())
+{
+  auto initResult = initWinsock();
+  startup_code_ = initResult.Code;
+  data_ = initResult.Data;
+}
+
 Socket::SocketImpl::~SocketImpl()
 {
   if (!startup_code_)
@@ -126,12 +151,6 @@ Socket::SocketImpl::~SocketImpl()
   }
 }
 
-const std::optional<IpEndPoint>& Socket::SocketImpl::local_endpoint()
-  const noexcept
-{
-  return local_endpoint_;
-}
-
 const std::optional<IpEndPoint>& Socket::SocketImpl::remote_endpoint()
   const noexcept
 {
@@ -172,6 +191,12 @@ std::string jvs::net::get_addrinfo_error_message(int ecode) noexcept
   return getWinsockAddrInfoErrorMessage(ecode);
 }
 
+int jvs::net::set_socket_nonblocking(SocketContext s, bool nonBlocking) noexcept
+{
+  u_long mode = nonBlocking ? 1 : 0;
+  return ::ioctlsocket(s, FIONBIO, &mode);
+}
+
 // Winsock-specific Socket member implementations
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -195,7 +220,48 @@ int Socket::close() noexcept
   // file descriptors. As such, `close()` can't be used.
   int closeResult = ::closesocket(impl_->socket_info_.context());
   impl_->socket_info_.reset();
-  impl_->local_endpoint_.reset();
   impl_->remote_endpoint_.reset();
+  impl_->local_pending_ = false;
+  impl_->nonblocking_ = false;
   return closeResult;
 }
+
+jvs::Expected<std::size_t> Socket::recvv(
+  std::span<const std::span<std::byte>> buffers, int flags) noexcept
+{
+  std::array<WSABUF, MaxIoBuffers> wsaBuffers;
+  DWORD bufferCount = fillWsaBuffers(wsaBuffers, buffers);
+  DWORD receivedSize = 0;
+  DWORD recvFlags = static_cast<DWORD>(flags);
+  int result = ::WSARecv(impl_->socket_info_.context(), wsaBuffers.data(), bufferCount,
+    &receivedSize, &recvFlags, /*lpOverlapped*/ nullptr, /*lpCompletionRoutine*/ nullptr);
+  if (result == SOCKET_ERROR)
+  {
+    return jvs::net::create_socket_error(impl_->socket_info_.context());
+  }
+
+  return static_cast<std::size_t>(receivedSize);
+}
+
+jvs::Expected<std::size_t> Socket::sendv(
+  std::span<const std::span<const std::byte>> buffers, int flags) noexcept
+{
+  std::array<WSABUF, MaxIoBuffers> wsaBuffers;
+  DWORD bufferCount = fillWsaBuffers(wsaBuffers, buffers);
+  DWORD sentSize = 0;
+  int result = ::WSASend(impl_->socket_info_.context(), wsaBuffers.data(), bufferCount,
+    &sentSize, static_cast<DWORD>(flags), /*lpOverlapped*/ nullptr,
+    /*lpCompletionRoutine*/ nullptr);
+  if (result == SOCKET_ERROR)
+  {
+    return jvs::net::create_socket_error(impl_->socket_info_.context());
+  }
+
+  return static_cast<std::size_t>(sentSize);
+}
+
+jvs::Error Socket::set_reuse_port(bool /*enabled*/) noexcept
+{
+  // Winsock has no load-balancing equivalent of SO_REUSEPORT.
+  return jvs::net::create_socket_error(errcodes::EOpNotSupp);
+}
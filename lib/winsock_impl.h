@@ -8,6 +8,7 @@
 #if !defined(JVS_NETLIB_WINSOCK_IMPL_H_)
 #define JVS_NETLIB_WINSOCK_IMPL_H_
 
+#include <cstddef>
 #include <optional>
 
 #include "native_sockets.h"
@@ -25,10 +26,20 @@ class Socket::SocketImpl final
 public:
   SocketImpl();
   SocketImpl(SocketContext ctx);
+  // Implementation of a socket accepted from a listener with the given info.
+  // Nothing is queried from the native socket.
+  SocketImpl(SocketContext ctx, const SocketInfo& listenerInfo);
   SocketImpl(IpAddress::Family addressFamily, Socket::Transport transport);  
   ~SocketImpl();
+
+  // Allocated from a per-thread cache; see socket.cpp.
+  static void* operator new(std::size_t size);
+  static void operator delete(void* p) noexcept;
   
-  const std::optional<IpEndPoint>& local_endpoint() const noexcept;
+  // The local end point is kept in socket_info_ rather than duplicated here,
+  // and is only queried from the native socket on first use after the
+  // kernel may have assigned it (connect, accept from a wildcard listener).
+  IpEndPoint local_endpoint() noexcept;
   const std::optional<IpEndPoint>& remote_endpoint() const noexcept;
   
   bool update_local_endpoint() noexcept;
@@ -40,8 +51,9 @@ private:
   int startup_code_{WSAVERNOTSUPPORTED};
   WSADATA data_{};
   SocketInfo socket_info_{};
-  std::optional<IpEndPoint> local_endpoint_{};
   std::optional<IpEndPoint> remote_endpoint_{};
+  bool local_pending_{false};
+  bool nonblocking_{false};
 };
 
 } // namespace jvs::net
@@ -0,0 +1,190 @@
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/async_socket.h>
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/reactor.h>
+#include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_errors.h>
+#include <jvs-netlib/task.h>
+
+namespace
+{
+
+using jvs::Expected;
+using jvs::net::AsyncSocket;
+using jvs::net::IpAddress;
+using jvs::net::IpEndPoint;
+using jvs::net::Reactor;
+using jvs::net::Socket;
+using jvs::net::Task;
+
+std::span<const std::byte> as_bytes(std::string_view text)
+{
+  return std::as_bytes(std::span(text.data(), text.size()));
+}
+
+Expected<AsyncSocket> listen(Reactor& reactor, const char* endPoint)
+{
+  Socket listener(IpEndPoint::parse(endPoint)->address().family(), Socket::Transport::Tcp);
+  auto bound = listener.bind(*IpEndPoint::parse(endPoint));
+  EXPECT_TRUE(static_cast<bool>(bound));
+  auto listening = listener.listen(16);
+  EXPECT_TRUE(static_cast<bool>(listening));
+  return AsyncSocket::create(reactor, std::move(listener));
+}
+
+// Echoes until the peer closes the connection, the way a thread-per-client
+// handler would, returning the number of bytes echoed.
+Task<std::size_t> echo(AsyncSocket client)
+{
+  std::array<std::byte, 64> buffer{};
+  std::size_t total = 0;
+  for (;;)
+  {
+    auto received = co_await client.async_recv(buffer);
+    if (!received || *received == 0)
+    {
+      jvs::consume_error(received.take_error());
+      break;
+    }
+
+    auto sent = co_await client.async_send(std::span(buffer.data(), *received));
+    if (!sent)
+    {
+      jvs::consume_error(sent.take_error());
+      break;
+    }
+
+    total += *sent;
+  }
+
+  client.close();
+  co_return total;
+}
+
+Task<std::size_t> serve_one(AsyncSocket& listener)
+{
+  auto client = co_await listener.async_accept();
+  if (!client)
+  {
+    jvs::consume_error(client.take_error());
+    co_return 0;
+  }
+
+  co_return co_await echo(std::move(*client));
+}
+
+Task<std::string> exchange(Reactor& reactor, IpEndPoint server)
+{
+  auto client = AsyncSocket::create(reactor, Socket(server.address().family(), Socket::Transport::Tcp));
+  if (!client)
+  {
+    jvs::consume_error(client.take_error());
+    co_return "create failed";
+  }
+
+  auto connected = co_await client->async_connect(server);
+  if (!connected)
+  {
+    jvs::consume_error(connected.take_error());
+    co_return "connect failed";
+  }
+
+  std::string reply;
+  for (std::string_view message : {"hello", " coroutine", " world"})
+  {
+    auto sent = co_await client->async_send(as_bytes(message));
+    std::array<std::byte, 64> buffer{};
+    std::size_t received = 0;
+    while (sent && received < *sent)
+    {
+      auto chunk = co_await client->async_recv(std::span(buffer).subspan(received));
+      if (!chunk || *chunk == 0)
+      {
+        jvs::consume_error(chunk.take_error());
+        break;
+      }
+
+      received += *chunk;
+    }
+
+    jvs::consume_error(sent.take_error());
+    reply.append(reinterpret_cast<const char*>(buffer.data()), received);
+  }
+
+  client->close();
+  co_return reply;
+}
+
+} // namespace
+
+TEST(AsyncSocketTest, EchoOverLoopback)
+{
+  auto reactor = Reactor::create();
+  ASSERT_TRUE(static_cast<bool>(reactor));
+  auto listener = listen(*reactor, "127.0.0.1:0");
+  ASSERT_TRUE(static_cast<bool>(listener));
+  auto server = listener->socket().local();
+
+  std::size_t echoed = 0;
+  [](AsyncSocket& l, std::size_t& out) -> Task<>
+  {
+    out = co_await serve_one(l);
+  }(*listener, echoed).detach();
+
+  auto reply = jvs::net::sync_wait(*reactor, exchange(*reactor, server));
+  EXPECT_EQ(reply, "hello coroutine world");
+
+  // Let the server see the end of the connection.
+  while (echoed == 0)
+  {
+    jvs::consume_error(reactor->run_once(std::chrono::milliseconds(100)).take_error());
+  }
+
+  EXPECT_EQ(echoed, reply.size());
+  listener->close();
+  EXPECT_EQ(reactor->size(), 0u);
+}
+
+TEST(AsyncSocketTest, ConnectRefused)
+{
+  auto reactor = Reactor::create();
+  ASSERT_TRUE(static_cast<bool>(reactor));
+  Socket unused(IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  auto refused = unused.bind(*IpEndPoint::parse("127.0.0.1:0"));
+  ASSERT_TRUE(static_cast<bool>(refused));
+  unused.close();
+
+  auto client = AsyncSocket::create(*reactor, Socket(IpAddress::Family::IPv4, Socket::Transport::Tcp));
+  ASSERT_TRUE(static_cast<bool>(client));
+  EXPECT_TRUE(client->socket().is_nonblocking());
+  auto connected = jvs::net::sync_wait(*reactor, client->async_connect(*refused));
+  ASSERT_FALSE(static_cast<bool>(connected));
+  EXPECT_TRUE(connected.error_is_a<jvs::net::SocketError>());
+  jvs::consume_error(connected.take_error());
+  client->close();
+}
+
+TEST(AsyncSocketTest, CloseResumesPendingOperation)
+{
+  auto reactor = Reactor::create();
+  ASSERT_TRUE(static_cast<bool>(reactor));
+  auto listener = listen(*reactor, "127.0.0.1:0");
+  ASSERT_TRUE(static_cast<bool>(listener));
+
+  bool failed = false;
+  [](AsyncSocket& l, bool& out) -> Task<>
+  {
+    auto accepted = co_await l.async_accept();
+    out = !accepted;
+    jvs::consume_error(accepted.take_error());
+  }(*listener, failed).detach();
+
+  EXPECT_FALSE(failed);
+  listener->close();
+  EXPECT_TRUE(failed);
+}
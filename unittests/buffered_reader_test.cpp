@@ -0,0 +1,126 @@
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/buffered_reader.h>
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/socket.h>
+
+namespace
+{
+
+using jvs::net::Socket;
+
+struct SocketPair
+{
+  Socket server{jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp};
+  Socket client{jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp};
+  std::optional<Socket> peer{};
+
+  bool connect()
+  {
+    auto boundEp = server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"));
+    auto listenEp = server.listen();
+    if (!boundEp || !listenEp)
+    {
+      jvs::consume_error(boundEp.take_error());
+      jvs::consume_error(listenEp.take_error());
+      return false;
+    }
+
+    auto remoteEp = client.connect(*listenEp);
+    if (!remoteEp)
+    {
+      jvs::consume_error(remoteEp.take_error());
+      return false;
+    }
+
+    auto connection = server.accept();
+    if (!connection)
+    {
+      jvs::consume_error(connection.take_error());
+      return false;
+    }
+
+    peer.emplace(std::move(*connection));
+    return true;
+  }
+
+  ~SocketPair()
+  {
+    if (peer)
+    {
+      peer->close();
+    }
+
+    client.close();
+    server.close();
+  }
+};
+
+} // namespace
+
+TEST(BufferedReaderTest, ReadUntilDelimiter)
+{
+  SocketPair sockets;
+  ASSERT_TRUE(sockets.connect());
+  ASSERT_FALSE(jvs::error_to_bool(jvs::net::write(sockets.client, "alpha\nbeta\ngam")));
+
+  jvs::net::BufferedReader reader(*sockets.peer);
+  auto line = reader.read_until('\n');
+  ASSERT_TRUE(static_cast<bool>(line));
+  ASSERT_TRUE(line->has_value());
+  EXPECT_EQ(**line, "alpha");
+
+  line = reader.read_until('\n');
+  ASSERT_TRUE(static_cast<bool>(line));
+  ASSERT_TRUE(line->has_value());
+  EXPECT_EQ(**line, "beta");
+
+  ASSERT_FALSE(jvs::error_to_bool(jvs::net::write(sockets.client, "ma\n")));
+  line = reader.read_until('\n');
+  ASSERT_TRUE(static_cast<bool>(line));
+  ASSERT_TRUE(line->has_value());
+  EXPECT_EQ(**line, "gamma");
+
+  sockets.client.close();
+  auto rest = reader.read_some();
+  ASSERT_TRUE(static_cast<bool>(rest));
+  EXPECT_FALSE(rest->has_value());
+}
+
+TEST(BufferedReaderTest, ReusesAndGrowsBuffer)
+{
+  SocketPair sockets;
+  ASSERT_TRUE(sockets.connect());
+
+  jvs::net::BufferedReader reader(*sockets.peer, 8, 64);
+  ASSERT_FALSE(jvs::error_to_bool(jvs::net::write(sockets.client, "0123456789abcdef;")));
+  auto record = reader.read_until(';');
+  ASSERT_TRUE(static_cast<bool>(record));
+  ASSERT_TRUE(record->has_value());
+  EXPECT_EQ(**record, "0123456789abcdef");
+  EXPECT_GE(reader.capacity(), 17u);
+  EXPECT_EQ(reader.size(), 0u);
+
+  // Consumed space is reclaimed rather than growing again.
+  auto capacity = reader.capacity();
+  for (int i = 0; i < 10; ++i)
+  {
+    ASSERT_FALSE(jvs::error_to_bool(jvs::net::write(sockets.client, "xyz;")));
+    record = reader.read_until(';');
+    ASSERT_TRUE(static_cast<bool>(record));
+    ASSERT_TRUE(record->has_value());
+    EXPECT_EQ(**record, "xyz");
+  }
+
+  EXPECT_EQ(reader.capacity(), capacity);
+
+  ASSERT_FALSE(jvs::error_to_bool(jvs::net::write(sockets.client, std::string(100, 'z'))));
+  record = reader.read_until(';');
+  ASSERT_FALSE(static_cast<bool>(record));
+  jvs::consume_error(record.take_error());
+}
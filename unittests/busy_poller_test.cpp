@@ -0,0 +1,165 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/busy_poller.h>
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_errors.h>
+#include <jvs-netlib/socket_options.h>
+
+namespace
+{
+
+using jvs::net::BusyPoller;
+using jvs::net::IpAddress;
+using jvs::net::IpEndPoint;
+using jvs::net::Socket;
+
+} // namespace
+
+TEST(BusyPollerTest, EchoesDatagrams)
+{
+  auto poller = BusyPoller::create({/*cpu*/ 0});
+  ASSERT_TRUE(static_cast<bool>(poller));
+
+  Socket server(IpAddress::Family::IPv4, Socket::Transport::Udp);
+  auto serverEp = server.bind(*IpEndPoint::parse("127.0.0.1:0"));
+  ASSERT_TRUE(static_cast<bool>(serverEp));
+  ASSERT_FALSE(jvs::error_to_bool(poller->add(server, [](Socket& s)
+    {
+      std::array<char, 64> buffer{};
+      for (;;)
+      {
+        auto received = s.recvfrom(buffer.data(), buffer.size());
+        if (!received)
+        {
+          // Drained; any other error removes the socket.
+          bool drained = received.error_is_a<jvs::net::NonBlockingStatus>();
+          jvs::consume_error(received.take_error());
+          return drained;
+        }
+
+        auto [length, remote] = *received;
+        jvs::consume_error(s.sendto(buffer.data(), length, remote).take_error());
+      }
+    })));
+
+  EXPECT_EQ(poller->size(), 1u);
+  EXPECT_TRUE(server.is_nonblocking());
+#if defined(SO_BUSY_POLL)
+  auto busyPoll = server.get_option<jvs::net::sockopt::BusyPoll>();
+  ASSERT_TRUE(static_cast<bool>(busyPoll));
+  EXPECT_EQ(*busyPoll, 50);
+#endif
+
+  Socket client(IpAddress::Family::IPv4, Socket::Transport::Udp);
+  for (char i = 0; i < 5; ++i)
+  {
+    ASSERT_TRUE(static_cast<bool>(client.sendto(&i, 1, *serverEp)));
+    char echoed = -1;
+    auto received = client.recv(&echoed, 1);
+    ASSERT_TRUE(static_cast<bool>(received));
+    EXPECT_EQ(echoed, i);
+  }
+
+  EXPECT_EQ(poller->size(), 1u);
+  EXPECT_FALSE(jvs::error_to_bool(poller->remove(server)));
+  client.close();
+  server.close();
+}
+
+TEST(BusyPollerTest, AddAndRemove)
+{
+  auto poller = BusyPoller::create({/*cpu*/ -1, /*busy_poll*/ std::chrono::microseconds(0)});
+  ASSERT_TRUE(static_cast<bool>(poller));
+
+  Socket first(IpAddress::Family::IPv4, Socket::Transport::Udp);
+  Socket second(IpAddress::Family::IPv4, Socket::Transport::Udp);
+  std::atomic<int> firstCalls{0};
+  std::atomic<int> secondCalls{0};
+  ASSERT_FALSE(jvs::error_to_bool(poller->add(first, [&](Socket&)
+    {
+      ++firstCalls;
+      return true;
+    })));
+  EXPECT_TRUE(jvs::error_to_bool(poller->add(first, [](Socket&) { return true; })));
+  // Removes itself after three calls.
+  ASSERT_FALSE(jvs::error_to_bool(poller->add(second, [&](Socket&)
+    {
+      return ++secondCalls < 3;
+    })));
+
+  while (poller->size() != 1)
+  {
+    std::this_thread::yield();
+  }
+
+  EXPECT_EQ(secondCalls.load(), 3);
+  EXPECT_TRUE(jvs::error_to_bool(poller->remove(second)));
+  EXPECT_FALSE(jvs::error_to_bool(poller->remove(first)));
+  auto calls = firstCalls.load();
+  EXPECT_GT(calls, 0);
+  // Once remove() returns, the handler isn't invoked anymore.
+  auto sweeps = poller->sweeps();
+  while (poller->sweeps() < sweeps + 10)
+  {
+    std::this_thread::yield();
+  }
+
+  EXPECT_EQ(firstCalls.load(), calls);
+  EXPECT_EQ(poller->size(), 0u);
+  poller->stop();
+  first.close();
+  second.close();
+}
+
+TEST(BusyPollerTest, HandlerClosesItsSocket)
+{
+  auto poller = BusyPoller::create({/*cpu*/ -1, /*busy_poll*/ std::chrono::microseconds(0)});
+  ASSERT_TRUE(static_cast<bool>(poller));
+
+  // Stays registered after its socket was closed, so that it and the socket
+  // below share a descriptor of -1.
+  Socket closedEarly(IpAddress::Family::IPv4, Socket::Transport::Udp);
+  std::atomic<bool> closedEarlyDone{false};
+  ASSERT_FALSE(jvs::error_to_bool(poller->add(closedEarly, [&](Socket&)
+    {
+      return !closedEarlyDone.load();
+    })));
+  closedEarly.close();
+
+  Socket s(IpAddress::Family::IPv4, Socket::Transport::Udp);
+  std::atomic<int> calls{0};
+  ASSERT_FALSE(jvs::error_to_bool(poller->add(s, [&](Socket& self)
+    {
+      ++calls;
+      self.close();
+      return false;
+    })));
+
+  while (poller->size() != 1)
+  {
+    std::this_thread::yield();
+  }
+
+  auto sweeps = poller->sweeps();
+  while (poller->sweeps() < sweeps + 10)
+  {
+    std::this_thread::yield();
+  }
+
+  EXPECT_EQ(calls.load(), 1);
+  EXPECT_LT(s.descriptor(), 0);
+  // The handler that returned false was the one dropped.
+  closedEarlyDone.store(true);
+  while (poller->size() != 0)
+  {
+    std::this_thread::yield();
+  }
+
+  poller->stop();
+}
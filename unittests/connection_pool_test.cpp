@@ -0,0 +1,140 @@
+#include <chrono>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/connection_pool.h>
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_errors.h>
+#include <jvs-netlib/transport_end_point.h>
+
+#include "test_helpers.h"
+
+namespace
+{
+
+using jvs::net::ConnectionPool;
+using jvs::net::IpAddress;
+using jvs::net::IpEndPoint;
+using jvs::net::Socket;
+using jvs::test::Listener;
+using jvs::test::refused_end_point;
+using jvs::test::socket_error_code;
+
+} // namespace
+
+TEST(ConnectionPoolTest, ReusesReleasedConnection)
+{
+  Listener listener;
+  ConnectionPool pool;
+  auto first = pool.acquire(listener.end_point());
+  ASSERT_TRUE(static_cast<bool>(first));
+  auto server = listener.accept();
+  auto port = first->local().port();
+  pool.release(listener.end_point(), std::move(*first));
+  EXPECT_EQ(pool.idle_count(), 1u);
+
+  auto second = pool.acquire(listener.end_point());
+  ASSERT_TRUE(static_cast<bool>(second));
+  EXPECT_EQ(second->local().port(), port);
+  EXPECT_EQ(pool.idle_count(), 0u);
+
+  // Still connected to the same peer.
+  ASSERT_TRUE(static_cast<bool>(second->send("x", 1)));
+  char c = 0;
+  auto received = server.recv(&c, 1);
+  ASSERT_TRUE(static_cast<bool>(received));
+  EXPECT_EQ(c, 'x');
+  pool.discard(listener.end_point(), std::move(*second));
+  server.close();
+}
+
+TEST(ConnectionPoolTest, DropsConnectionsClosedByPeer)
+{
+  Listener listener;
+  ConnectionPool pool;
+  auto first = pool.acquire(listener.end_point());
+  ASSERT_TRUE(static_cast<bool>(first));
+  auto port = first->local().port();
+  pool.release(listener.end_point(), std::move(*first));
+  listener.accept().close();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  auto second = pool.acquire(listener.end_point());
+  ASSERT_TRUE(static_cast<bool>(second));
+  EXPECT_NE(second->local().port(), port);
+  auto server = listener.accept();
+  pool.release(listener.end_point(), std::move(*second));
+
+  // Unread data also makes a connection unusable.
+  ASSERT_TRUE(static_cast<bool>(server.send("x", 1)));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  auto third = pool.acquire(listener.end_point());
+  ASSERT_TRUE(static_cast<bool>(third));
+  EXPECT_NE(third->local().port(), port);
+  EXPECT_EQ(pool.idle_count(), 0u);
+  pool.discard(listener.end_point(), std::move(*third));
+  listener.accept().close();
+  server.close();
+}
+
+TEST(ConnectionPoolTest, EnforcesIdleLimits)
+{
+  Listener listener;
+  ConnectionPool::Options options;
+  options.max_idle_per_host = 1;
+  options.idle_timeout = std::chrono::milliseconds(50);
+  ConnectionPool pool(options);
+
+  auto first = pool.acquire(listener.end_point());
+  auto second = pool.acquire(listener.end_point());
+  ASSERT_TRUE(first && second);
+  pool.release(listener.end_point(), std::move(*first));
+  pool.release(listener.end_point(), std::move(*second));
+  EXPECT_EQ(pool.idle_count(), 1u);
+  EXPECT_EQ(pool.idle_count(jvs::net::TransportEndPoint(listener.end_point(), Socket::Transport::Tcp)), 1u);
+  EXPECT_EQ(pool.prune(), 0u);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  EXPECT_EQ(pool.prune(), 1u);
+  EXPECT_EQ(pool.idle_count(), 0u);
+  listener.accept().close();
+  listener.accept().close();
+}
+
+TEST(ConnectionPoolTest, EnforcesMaxPerHost)
+{
+  Listener listener;
+  ConnectionPool::Options options;
+  options.max_per_host = 1;
+  ConnectionPool pool(options);
+
+  auto first = pool.acquire(listener.end_point());
+  ASSERT_TRUE(static_cast<bool>(first));
+  auto second = pool.acquire(listener.end_point());
+  ASSERT_FALSE(static_cast<bool>(second));
+  EXPECT_EQ(socket_error_code(second.take_error()), jvs::net::errcodes::EAgain);
+
+  pool.discard(listener.end_point(), std::move(*first));
+  second = pool.acquire(listener.end_point());
+  ASSERT_TRUE(static_cast<bool>(second));
+  pool.discard(listener.end_point(), std::move(*second));
+  listener.accept().close();
+  listener.accept().close();
+}
+
+TEST(ConnectionPoolTest, FailedConnectReleasesSlot)
+{
+  auto refused = refused_end_point();
+
+  ConnectionPool::Options options;
+  options.max_per_host = 1;
+  ConnectionPool pool(options);
+  for (int i = 0; i < 2; ++i)
+  {
+    auto connected = pool.acquire(refused);
+    ASSERT_FALSE(static_cast<bool>(connected));
+    EXPECT_EQ(socket_error_code(connected.take_error()), jvs::net::errcodes::EConnRefused);
+  }
+}
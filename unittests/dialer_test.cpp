@@ -0,0 +1,113 @@
+#include <chrono>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/dialer.h>
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_errors.h>
+
+#include "test_helpers.h"
+
+namespace
+{
+
+using jvs::net::IpAddress;
+using jvs::net::IpEndPoint;
+using jvs::net::Socket;
+using jvs::test::Listener;
+using jvs::test::refused_end_point;
+using jvs::test::socket_error_code;
+
+} // namespace
+
+TEST(DialerTest, InterleaveFamilies)
+{
+  std::vector<IpEndPoint> endPoints{
+    *IpEndPoint::parse("[2001:db8::1]:80"),
+    *IpEndPoint::parse("[2001:db8::2]:80"),
+    *IpEndPoint::parse("[2001:db8::3]:80"),
+    *IpEndPoint::parse("192.0.2.1:80"),
+  };
+
+  auto ordered = jvs::net::interleave_families(endPoints);
+  ASSERT_EQ(ordered.size(), 4u);
+  EXPECT_EQ(ordered[0].address(), endPoints[0].address());
+  EXPECT_EQ(ordered[1].address(), endPoints[3].address());
+  EXPECT_EQ(ordered[2].address(), endPoints[1].address());
+  EXPECT_EQ(ordered[3].address(), endPoints[2].address());
+  EXPECT_TRUE(jvs::net::interleave_families({}).empty());
+}
+
+TEST(DialerTest, FallsBackFromBlackHole)
+{
+  Listener blackHole("127.0.0.1:0", /*blackHole*/ true);
+  Listener good("[::1]:0");
+  // The IPv6 end point is listed last but is tried second.
+  std::vector<IpEndPoint> endPoints{blackHole.end_point(), blackHole.end_point(), good.end_point()};
+  jvs::net::ConnectOptions options;
+  options.attempt_delay = std::chrono::milliseconds(50);
+
+  auto start = std::chrono::steady_clock::now();
+  auto connected = jvs::net::connect_any(endPoints, options);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  ASSERT_TRUE(static_cast<bool>(connected));
+  ASSERT_TRUE(connected->remote().has_value());
+  EXPECT_EQ(connected->remote()->address(), IpAddress::ipv6_loopback());
+  EXPECT_EQ(connected->remote()->port(), good.end_point().port());
+  EXPECT_FALSE(connected->is_nonblocking());
+  EXPECT_GE(elapsed, std::chrono::milliseconds(50));
+  EXPECT_LT(elapsed, std::chrono::milliseconds(1000));
+
+  auto accepted = good.socket().accept();
+  ASSERT_TRUE(static_cast<bool>(accepted));
+  accepted->close();
+  connected->close();
+}
+
+TEST(DialerTest, RefusedAttemptStartsNextImmediately)
+{
+  Listener good("127.0.0.1:0");
+  std::vector<IpEndPoint> endPoints{refused_end_point(), good.end_point()};
+  jvs::net::ConnectOptions options;
+  options.attempt_delay = std::chrono::seconds(5);
+  options.nonblocking = true;
+
+  auto start = std::chrono::steady_clock::now();
+  auto connected = jvs::net::connect_any(endPoints, options);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  ASSERT_TRUE(static_cast<bool>(connected));
+  EXPECT_TRUE(connected->is_nonblocking());
+  EXPECT_EQ(connected->remote()->port(), good.end_point().port());
+  EXPECT_LT(elapsed, std::chrono::seconds(1));
+  connected->close();
+}
+
+TEST(DialerTest, ReportsLastFailure)
+{
+  std::vector<IpEndPoint> endPoints{refused_end_point(), refused_end_point()};
+  auto connected = jvs::net::connect_any(endPoints);
+  ASSERT_FALSE(static_cast<bool>(connected));
+  EXPECT_EQ(socket_error_code(connected.take_error()), jvs::net::errcodes::EConnRefused);
+
+  connected = jvs::net::connect_any({});
+  ASSERT_FALSE(static_cast<bool>(connected));
+  EXPECT_EQ(socket_error_code(connected.take_error()), jvs::net::errcodes::EDestAddrReq);
+}
+
+TEST(DialerTest, TimesOut)
+{
+  Listener blackHole("127.0.0.1:0", /*blackHole*/ true);
+  std::vector<IpEndPoint> endPoints{blackHole.end_point()};
+  jvs::net::ConnectOptions options;
+  options.timeout = std::chrono::milliseconds(100);
+
+  auto start = std::chrono::steady_clock::now();
+  auto connected = jvs::net::connect_any(endPoints, options);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  ASSERT_FALSE(static_cast<bool>(connected));
+  EXPECT_EQ(socket_error_code(connected.take_error()), jvs::net::errcodes::ETimedOut);
+  EXPECT_GE(elapsed, std::chrono::milliseconds(100));
+  EXPECT_LT(elapsed, std::chrono::seconds(1));
+}
@@ -0,0 +1,203 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <latch>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/executor.h>
+
+#if defined(__linux__)
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/reactor.h>
+#include <jvs-netlib/socket.h>
+#endif
+
+namespace
+{
+
+using jvs::net::Executor;
+
+Executor create_executor(std::size_t threads)
+{
+  auto executor = Executor::create({threads});
+  EXPECT_TRUE(static_cast<bool>(executor));
+  return std::move(*executor);
+}
+
+} // namespace
+
+TEST(ExecutorTest, RunsFunctionsPostedFromOutside)
+{
+  std::atomic<std::size_t> count{0};
+  {
+    auto executor = create_executor(4);
+    EXPECT_EQ(executor.size(), 4u);
+    EXPECT_FALSE(executor.running_in_this_thread());
+    for (std::size_t i = 0; i < 10000; ++i)
+    {
+      executor.post([&] { count.fetch_add(1); });
+    }
+  }
+
+  EXPECT_EQ(count.load(), 10000u);
+}
+
+TEST(ExecutorTest, DestructorWaitsForNestedPosts)
+{
+  std::atomic<std::size_t> count{0};
+  // Outlives the executor, which runs it until it is destroyed.
+  std::function<void(int)> fork;
+  {
+    auto executor = create_executor(3);
+    // A binary tree of 2^12 - 1 functions, each posting its children.
+    fork = [&](int depth)
+    {
+      count.fetch_add(1);
+      if (depth > 1)
+      {
+        executor.post([&, depth] { fork(depth - 1); });
+        executor.post([&, depth] { fork(depth - 1); });
+      }
+    };
+
+    executor.post([&] { fork(12); });
+  }
+
+  EXPECT_EQ(count.load(), 4095u);
+}
+
+TEST(ExecutorTest, IdleWorkersSteal)
+{
+  auto executor = create_executor(4);
+  constexpr std::size_t Children = 200;
+  std::latch done(Children);
+  std::atomic<bool> onWorkers{true};
+  executor.post([&]
+    {
+      // Everything lands on this worker's deque; the others must steal it.
+      for (std::size_t i = 0; i < Children; ++i)
+      {
+        executor.post([&]
+          {
+            if (!executor.running_in_this_thread())
+            {
+              onWorkers = false;
+            }
+
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            done.count_down();
+          });
+      }
+    });
+
+  done.wait();
+  auto stats = executor.stats();
+  EXPECT_TRUE(onWorkers.load());
+  EXPECT_EQ(stats.queued, 0u);
+  EXPECT_EQ(stats.executed, Children + 1);
+  EXPECT_GT(stats.steals, 0u);
+}
+
+TEST(ExecutorTest, QueueDepth)
+{
+  std::promise<void> started;
+  std::promise<void> release;
+  auto released = release.get_future().share();
+  std::atomic<std::size_t> count{0};
+  {
+    auto executor = create_executor(1);
+    executor.post([&]
+      {
+        for (int i = 0; i < 5; ++i)
+        {
+          executor.post([&] { count.fetch_add(1); });
+        }
+
+        started.set_value();
+        released.wait();
+      });
+
+    started.get_future().wait();
+    EXPECT_EQ(executor.queue_depth(0), 5u);
+    EXPECT_EQ(executor.queue_depth(1), 0u);
+    for (int i = 0; i < 3; ++i)
+    {
+      executor.post([&] { count.fetch_add(1); });
+    }
+
+    auto stats = executor.stats();
+    EXPECT_EQ(stats.queued, 8u);
+    EXPECT_EQ(stats.executed, 1u);
+    EXPECT_EQ(stats.steals, 0u);
+    release.set_value();
+  }
+
+  EXPECT_EQ(count.load(), 8u);
+}
+
+#if defined(__linux__)
+
+TEST(ExecutorTest, PostFromReactorHandler)
+{
+  using jvs::net::IpAddress;
+  using jvs::net::IpEndPoint;
+  using jvs::net::Reactor;
+  using jvs::net::Socket;
+
+  // Created first, as the executor's functions use it until they are done.
+  auto reactor = Reactor::create();
+  ASSERT_TRUE(static_cast<bool>(reactor));
+  auto executor = create_executor(2);
+
+  Socket receiver(IpAddress::Family::IPv4, Socket::Transport::Udp, /*nonBlocking*/ true);
+  auto receiverEp = receiver.bind(*IpEndPoint::parse("127.0.0.1:0"));
+  ASSERT_TRUE(static_cast<bool>(receiverEp));
+
+  // The handler only drains the socket; the work and the reply happen on the
+  // executor, which stops the reactor once every datagram was handled.
+  constexpr int Datagrams = 10;
+  std::atomic<int> sum{0};
+  std::atomic<int> handled{0};
+  ASSERT_FALSE(jvs::error_to_bool(reactor->add(receiver, Reactor::Readable,
+    [&](Reactor::EventMask)
+    {
+      for (;;)
+      {
+        char value = 0;
+        auto received = receiver.recv(&value, 1);
+        if (!received)
+        {
+          jvs::consume_error(received.take_error());
+          return;
+        }
+
+        executor.post([&, value]
+          {
+            sum.fetch_add(value);
+            if (handled.fetch_add(1) + 1 == Datagrams)
+            {
+              reactor->stop();
+            }
+          });
+      }
+    })));
+
+  Socket sender(IpAddress::Family::IPv4, Socket::Transport::Udp);
+  for (char i = 1; i <= Datagrams; ++i)
+  {
+    ASSERT_TRUE(static_cast<bool>(sender.sendto(&i, 1, *receiverEp)));
+  }
+
+  EXPECT_FALSE(jvs::error_to_bool(reactor->run()));
+  EXPECT_EQ(handled.load(), Datagrams);
+  EXPECT_EQ(sum.load(), Datagrams * (Datagrams + 1) / 2);
+  EXPECT_FALSE(jvs::error_to_bool(reactor->remove(receiver)));
+  sender.close();
+  receiver.close();
+}
+
+#endif // __linux__
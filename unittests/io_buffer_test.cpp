@@ -0,0 +1,134 @@
+#include <cstddef>
+#include <cstring>
+#include <future>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/io_buffer.h>
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/socket.h>
+
+namespace
+{
+
+std::string to_string(std::span<const std::span<const std::byte>> spans)
+{
+  std::string result;
+  for (auto& span : spans)
+  {
+    result.append(reinterpret_cast<const char*>(span.data()), span.size());
+  }
+
+  return result;
+}
+
+std::span<const std::byte> as_bytes(std::string_view s)
+{
+  return std::as_bytes(std::span<const char>(s.data(), s.size()));
+}
+
+} // namespace
+
+TEST(IoBufferTest, PrepareCommitConsume)
+{
+  jvs::net::SegmentPool pool(8, 16);
+  jvs::net::IoBuffer buffer(pool, jvs::net::IoBuffer::Unlimited);
+  EXPECT_TRUE(buffer.empty());
+
+  auto spans = buffer.prepare(20);
+  ASSERT_EQ(spans.size(), 3u);
+  EXPECT_EQ(spans[0].size(), 8u);
+  EXPECT_EQ(spans[2].size(), 4u);
+  std::string_view text("abcdefghijkl");
+  std::memcpy(spans[0].data(), text.data(), 8);
+  std::memcpy(spans[1].data(), text.data() + 8, 4);
+  buffer.commit(12);
+  // The unused third segment went back to the pool.
+  EXPECT_EQ(pool.cached(), 1u);
+  EXPECT_EQ(buffer.size(), 12u);
+  EXPECT_EQ(to_string(buffer.data()), text);
+
+  buffer.consume(10);
+  EXPECT_EQ(to_string(buffer.data()), "kl");
+  EXPECT_EQ(pool.cached(), 2u);
+
+  EXPECT_EQ(buffer.append(as_bytes("mnopqrstuvwxyz")), 14u);
+  EXPECT_EQ(to_string(buffer.data()), "klmnopqrstuvwxyz");
+  EXPECT_EQ(buffer.data().size(), 3u);
+
+  buffer.clear();
+  EXPECT_TRUE(buffer.empty());
+  EXPECT_EQ(pool.cached(), 3u);
+}
+
+TEST(IoBufferTest, MaxSize)
+{
+  jvs::net::SegmentPool pool(4, 16);
+  jvs::net::IoBuffer buffer(pool, 10);
+  EXPECT_EQ(buffer.append(as_bytes("0123456789abcdef")), 10u);
+  EXPECT_TRUE(buffer.prepare(1).empty());
+  buffer.consume(4);
+  EXPECT_EQ(buffer.append(as_bytes("ghijkl")), 4u);
+  EXPECT_EQ(to_string(buffer.data()), "456789ghij");
+}
+
+TEST(IoBufferTest, SocketRecvSendTcpv4)
+{
+  using jvs::net::Socket;
+
+  Socket server(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"))));
+  auto listenEp = server.listen();
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+  Socket client(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(client.connect(*listenEp)));
+  auto peer = server.accept();
+  ASSERT_TRUE(static_cast<bool>(peer));
+
+  std::vector<char> payload(50000);
+  std::iota(payload.begin(), payload.end(), 0);
+  auto senderTask = std::async(std::launch::async, [&]
+    {
+      // Uses the sending thread's pool.
+      jvs::net::IoBuffer outgoing;
+      if (outgoing.append(std::as_bytes(std::span(payload))) != payload.size())
+      {
+        return false;
+      }
+
+      while (!outgoing.empty())
+      {
+        auto sent = jvs::net::send(client, outgoing);
+        if (!sent)
+        {
+          jvs::consume_error(sent.take_error());
+          return false;
+        }
+      }
+
+      client.close();
+      return true;
+    });
+
+  // Room for the payload, so that the end of the stream can still be read.
+  jvs::net::IoBuffer incoming(payload.size() + 1);
+  for (;;)
+  {
+    auto received = jvs::net::recv(*peer, incoming, 16384);
+    ASSERT_TRUE(static_cast<bool>(received));
+    if (*received == 0)
+    {
+      break;
+    }
+  }
+
+  EXPECT_TRUE(senderTask.get());
+  EXPECT_EQ(to_string(incoming.data()), std::string(payload.begin(), payload.end()));
+  peer->close();
+  server.close();
+}
@@ -0,0 +1,349 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/io_uring_context.h>
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/socket.h>
+
+namespace
+{
+
+using jvs::net::IoUringContext;
+using jvs::net::Socket;
+
+// Creates a context, or returns nothing when the kernel doesn't support
+// io_uring (in which case the calling test is skipped).
+std::optional<IoUringContext> create_context()
+{
+  auto ctx = IoUringContext::create();
+  if (!ctx)
+  {
+    EXPECT_TRUE(ctx.error_is_a<jvs::net::UnsupportedError>());
+    jvs::consume_error(ctx.take_error());
+    return std::nullopt;
+  }
+
+  return std::move(*ctx);
+}
+
+// Runs the context until `done` returns true (or nothing more can complete).
+template <typename PredicateT>
+void run_until(IoUringContext& ctx, PredicateT done)
+{
+  for (int i = 0; i < 100 && !done(); ++i)
+  {
+    auto dispatched = ctx.run_once(std::chrono::milliseconds(100));
+    ASSERT_TRUE(static_cast<bool>(dispatched));
+  }
+}
+
+std::span<const std::byte> as_bytes(std::string_view s)
+{
+  return std::as_bytes(std::span<const char>(s.data(), s.size()));
+}
+
+} // namespace
+
+TEST(IoUringContextTest, CreateAndPoll)
+{
+  auto ctx = create_context();
+  if (!ctx)
+  {
+    GTEST_SKIP();
+  }
+
+  EXPECT_EQ(ctx->pending(), 0u);
+  auto dispatched = ctx->run_once(std::chrono::milliseconds(0));
+  ASSERT_TRUE(static_cast<bool>(dispatched));
+  EXPECT_EQ(*dispatched, 0u);
+  dispatched = ctx->run_once(std::chrono::milliseconds(10));
+  ASSERT_TRUE(static_cast<bool>(dispatched));
+  EXPECT_EQ(*dispatched, 0u);
+}
+
+TEST(IoUringContextTest, AcceptConnectSendRecvTcpv4)
+{
+  auto ctx = create_context();
+  if (!ctx)
+  {
+    GTEST_SKIP();
+  }
+
+  Socket server(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"))));
+  auto listenEp = server.listen();
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+
+  std::unique_ptr<Socket> accepted;
+  ASSERT_FALSE(jvs::error_to_bool(ctx->accept(server,
+    [&](jvs::Expected<Socket> s)
+    {
+      ASSERT_TRUE(static_cast<bool>(s));
+      accepted = std::make_unique<Socket>(std::move(*s));
+    })));
+
+  Socket client(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  bool connected = false;
+  ASSERT_FALSE(jvs::error_to_bool(ctx->connect(client, *listenEp,
+    [&](jvs::Expected<std::size_t> result)
+    {
+      EXPECT_TRUE(static_cast<bool>(result));
+      jvs::consume_error(result.take_error());
+      connected = true;
+    })));
+  EXPECT_EQ(ctx->pending(), 2u);
+
+  run_until(*ctx, [&] { return connected && accepted; });
+  ASSERT_TRUE(connected);
+  ASSERT_TRUE(accepted);
+  ASSERT_TRUE(client.remote().has_value());
+  EXPECT_EQ(client.remote()->port(), listenEp->port());
+  EXPECT_TRUE(accepted->remote().has_value());
+
+  std::string_view cs("Hello, io_uring!");
+  std::array<std::byte, 64> buffer{};
+  std::size_t sent = 0;
+  std::size_t received = 0;
+  ASSERT_FALSE(jvs::error_to_bool(ctx->recv(*accepted, buffer,
+    [&](jvs::Expected<std::size_t> result)
+    {
+      ASSERT_TRUE(static_cast<bool>(result));
+      received = *result;
+    })));
+  ASSERT_FALSE(jvs::error_to_bool(ctx->send(client, as_bytes(cs),
+    [&](jvs::Expected<std::size_t> result)
+    {
+      ASSERT_TRUE(static_cast<bool>(result));
+      sent = *result;
+    })));
+
+  run_until(*ctx, [&] { return sent && received; });
+  EXPECT_EQ(sent, cs.size());
+  ASSERT_EQ(received, cs.size());
+  EXPECT_EQ(std::memcmp(buffer.data(), cs.data(), cs.size()), 0);
+
+  int closed = 0;
+  auto onClose = [&](jvs::Expected<std::size_t> result)
+  {
+    EXPECT_TRUE(static_cast<bool>(result));
+    jvs::consume_error(result.take_error());
+    ++closed;
+  };
+
+  ASSERT_FALSE(jvs::error_to_bool(ctx->close(client, onClose)));
+  ASSERT_FALSE(jvs::error_to_bool(ctx->close(*accepted, onClose)));
+  EXPECT_EQ(client.descriptor(), -1);
+  run_until(*ctx, [&] { return closed == 2; });
+  EXPECT_EQ(closed, 2);
+  EXPECT_EQ(ctx->pending(), 0u);
+  server.close();
+}
+
+TEST(IoUringContextTest, MultishotAcceptAndRecv)
+{
+  auto ctx = create_context();
+  if (!ctx)
+  {
+    GTEST_SKIP();
+  }
+
+  Socket server(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"))));
+  auto listenEp = server.listen();
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+
+  std::vector<std::byte> pool(4 * 16);
+  ASSERT_FALSE(jvs::error_to_bool(ctx->provide_buffers(pool, 16)));
+
+  std::vector<std::unique_ptr<Socket>> accepted;
+  std::string received;
+  int closedPeers = 0;
+  ASSERT_FALSE(jvs::error_to_bool(ctx->accept_multishot(server,
+    [&](jvs::Expected<Socket> s)
+    {
+      ASSERT_TRUE(static_cast<bool>(s));
+      accepted.push_back(std::make_unique<Socket>(std::move(*s)));
+      EXPECT_FALSE(jvs::error_to_bool(ctx->recv_multishot(*accepted.back(),
+        [&](jvs::Expected<std::span<const std::byte>> data)
+        {
+          ASSERT_TRUE(static_cast<bool>(data));
+          if (data->empty())
+          {
+            ++closedPeers;
+            return;
+          }
+
+          received.append(reinterpret_cast<const char*>(data->data()), data->size());
+        })));
+    })));
+
+  constexpr int ClientCount = 3;
+  std::string_view cs("multishot receive through provided buffers;");
+  for (int i = 0; i < ClientCount; ++i)
+  {
+    Socket client(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+    ASSERT_TRUE(static_cast<bool>(client.connect(*listenEp)));
+    ASSERT_FALSE(jvs::error_to_bool(jvs::net::write(client, cs)));
+    client.close();
+  }
+
+  run_until(*ctx, [&] { return closedPeers == ClientCount; });
+  EXPECT_EQ(accepted.size(), static_cast<std::size_t>(ClientCount));
+  EXPECT_EQ(closedPeers, ClientCount);
+  EXPECT_EQ(received.size(), ClientCount * cs.size());
+  // Only the multishot accept is left.
+  EXPECT_EQ(ctx->pending(), 1u);
+
+  for (auto& s : accepted)
+  {
+    s->close();
+  }
+
+  server.close();
+}
+
+TEST(IoUringContextTest, CloseCancelsMultishotOperations)
+{
+  auto ctx = create_context();
+  if (!ctx)
+  {
+    GTEST_SKIP();
+  }
+
+  Socket server(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"))));
+  auto listenEp = server.listen();
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+
+  std::vector<std::byte> pool(4 * 16);
+  ASSERT_FALSE(jvs::error_to_bool(ctx->provide_buffers(pool, 16)));
+
+  std::optional<Socket> accepted;
+  int acceptErrors = 0;
+  ASSERT_FALSE(jvs::error_to_bool(ctx->accept_multishot(server,
+    [&](jvs::Expected<Socket> s)
+    {
+      if (!s)
+      {
+        ++acceptErrors;
+        jvs::consume_error(s.take_error());
+        return;
+      }
+
+      accepted.emplace(std::move(*s));
+    })));
+
+  Socket client(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(client.connect(*listenEp)));
+  run_until(*ctx, [&] { return accepted.has_value(); });
+  ASSERT_TRUE(accepted.has_value());
+
+  int recvErrors = 0;
+  ASSERT_FALSE(jvs::error_to_bool(ctx->recv_multishot(*accepted,
+    [&](jvs::Expected<std::span<const std::byte>> data)
+    {
+      if (!data)
+      {
+        ++recvErrors;
+        jvs::consume_error(data.take_error());
+      }
+    })));
+  EXPECT_EQ(ctx->pending(), 2u);
+
+  // The listener stays open; only its accept is cancelled.
+  ASSERT_FALSE(jvs::error_to_bool(ctx->cancel(server)));
+  run_until(*ctx, [&] { return acceptErrors > 0; });
+  EXPECT_EQ(acceptErrors, 1);
+  EXPECT_EQ(ctx->pending(), 1u);
+
+  // The peer is still connected, so only the cancellation ends the receive.
+  bool closed = false;
+  ASSERT_FALSE(jvs::error_to_bool(ctx->close(*accepted,
+    [&](jvs::Expected<std::size_t> result)
+    {
+      EXPECT_TRUE(static_cast<bool>(result));
+      jvs::consume_error(result.take_error());
+      EXPECT_EQ(recvErrors, 1);
+      closed = true;
+    })));
+  run_until(*ctx, [&] { return closed; });
+  EXPECT_TRUE(closed);
+  EXPECT_EQ(recvErrors, 1);
+  EXPECT_EQ(ctx->pending(), 0u);
+
+  // The connection is really closed.
+  std::array<char, 16> buffer{};
+  auto received = client.recv(buffer.data(), buffer.size());
+  ASSERT_TRUE(static_cast<bool>(received));
+  EXPECT_EQ(*received, 0u);
+
+  client.close();
+  server.close();
+}
+
+TEST(IoUringContextTest, FixedBuffersTcpv4)
+{
+  auto ctx = create_context();
+  if (!ctx)
+  {
+    GTEST_SKIP();
+  }
+
+  Socket server(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"))));
+  auto listenEp = server.listen();
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+  Socket client(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(client.connect(*listenEp)));
+  auto peer = server.accept();
+  ASSERT_TRUE(static_cast<bool>(peer));
+
+  std::array<std::byte, 128> sendBuffer{};
+  std::array<std::byte, 128> recvBuffer{};
+  for (std::size_t i = 0; i < sendBuffer.size(); ++i)
+  {
+    sendBuffer[i] = static_cast<std::byte>(i);
+  }
+
+  std::array<std::span<std::byte>, 2> registered{sendBuffer, recvBuffer};
+  ASSERT_FALSE(jvs::error_to_bool(ctx->register_buffers(registered)));
+
+  // Outside of the registered buffer.
+  EXPECT_TRUE(jvs::error_to_bool(
+    ctx->send_fixed(client, 1, sendBuffer, [](jvs::Expected<std::size_t>) {})));
+  EXPECT_TRUE(jvs::error_to_bool(
+    ctx->recv_fixed(*peer, 2, recvBuffer, [](jvs::Expected<std::size_t>) {})));
+
+  std::size_t sent = 0;
+  std::size_t received = 0;
+  ASSERT_FALSE(jvs::error_to_bool(ctx->recv_fixed(*peer, 1, recvBuffer,
+    [&](jvs::Expected<std::size_t> result)
+    {
+      ASSERT_TRUE(static_cast<bool>(result));
+      received = *result;
+    })));
+  ASSERT_FALSE(jvs::error_to_bool(ctx->send_fixed(client, 0, sendBuffer,
+    [&](jvs::Expected<std::size_t> result)
+    {
+      ASSERT_TRUE(static_cast<bool>(result));
+      sent = *result;
+    })));
+
+  run_until(*ctx, [&] { return sent && received; });
+  EXPECT_EQ(sent, sendBuffer.size());
+  ASSERT_EQ(received, recvBuffer.size());
+  EXPECT_EQ(recvBuffer, sendBuffer);
+
+  peer->close();
+  client.close();
+  server.close();
+}
@@ -52,3 +52,20 @@ TEST(IpEndPointTest, Parse4to6MappedEndPoint)
   EXPECT_EQ(jvs::net::to_string(ep->address()), "::ffff:192.168.201.232");
   EXPECT_EQ(ep->port(), 1234);
 }
+
+TEST(IpEndPointTest, EqualityAndHash)
+{
+  auto ep = jvs::net::IpEndPoint::parse("[fc00::1234:89AB]:22");
+  auto same = jvs::net::IpEndPoint::parse("[fc00::1234:89ab]:22");
+  auto otherPort = jvs::net::IpEndPoint::parse("[fc00::1234:89AB]:23");
+  auto otherAddress = jvs::net::IpEndPoint::parse("192.168.123.114:22");
+  ASSERT_TRUE(ep && same && otherPort && otherAddress);
+  EXPECT_EQ(*ep, *same);
+  EXPECT_NE(*ep, *otherPort);
+  EXPECT_NE(*ep, *otherAddress);
+
+  std::hash<jvs::net::IpEndPoint> hash;
+  EXPECT_EQ(hash(*ep), hash(*same));
+  EXPECT_NE(hash(*ep), hash(*otherPort));
+  EXPECT_NE(hash(*ep), hash(*otherAddress));
+}
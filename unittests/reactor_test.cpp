@@ -0,0 +1,179 @@
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/reactor.h>
+#include <jvs-netlib/socket.h>
+
+TEST(ReactorTest, CreateAndWake)
+{
+  auto reactor = jvs::net::Reactor::create();
+  ASSERT_TRUE(static_cast<bool>(reactor));
+  EXPECT_EQ(reactor->size(), 0u);
+
+  reactor->wake();
+  auto dispatched = reactor->run_once(std::chrono::milliseconds(1000));
+  ASSERT_TRUE(static_cast<bool>(dispatched));
+  EXPECT_EQ(*dispatched, 0u);
+}
+
+TEST(ReactorTest, StopFromAnotherThread)
+{
+  auto reactor = jvs::net::Reactor::create();
+  ASSERT_TRUE(static_cast<bool>(reactor));
+
+  auto stopper = std::async(std::launch::async, [&]
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      reactor->stop();
+    });
+
+  EXPECT_FALSE(jvs::error_to_bool(reactor->run()));
+  stopper.wait();
+}
+
+TEST(ReactorTest, DuplicateAndUnknownDescriptors)
+{
+  auto reactor = jvs::net::Reactor::create();
+  ASSERT_TRUE(static_cast<bool>(reactor));
+
+  jvs::net::Socket sock(jvs::net::IpAddress::Family::IPv4,
+    jvs::net::Socket::Transport::Udp);
+  EXPECT_FALSE(jvs::error_to_bool(
+    reactor->add(sock, jvs::net::Reactor::Readable, [](auto) {})));
+  EXPECT_TRUE(jvs::error_to_bool(
+    reactor->add(sock, jvs::net::Reactor::Readable, [](auto) {})));
+  EXPECT_EQ(reactor->size(), 1u);
+  EXPECT_FALSE(jvs::error_to_bool(reactor->remove(sock)));
+  EXPECT_TRUE(jvs::error_to_bool(reactor->remove(sock)));
+  EXPECT_EQ(reactor->size(), 0u);
+  sock.close();
+}
+
+TEST(ReactorTest, EchoTcpv4)
+{
+  using jvs::net::Reactor;
+  using jvs::net::Socket;
+
+  auto reactor = Reactor::create();
+  ASSERT_TRUE(static_cast<bool>(reactor));
+
+  Socket server(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"))));
+  auto listenEp = server.listen();
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+  ASSERT_FALSE(jvs::error_to_bool(server.set_nonblocking(true)));
+
+  std::unordered_map<std::intptr_t, std::unique_ptr<Socket>> clients;
+  std::size_t echoedBytes = 0;
+
+  auto onClient = [&](std::intptr_t fd, Reactor::EventMask)
+  {
+    auto& client = *clients[fd];
+    char buffer[256];
+    for (;;)
+    {
+      auto received = client.recv(buffer, sizeof(buffer));
+      if (!received)
+      {
+        bool wouldBlock = received.error_is_a<jvs::net::NonBlockingStatus>();
+        jvs::consume_error(received.take_error());
+        if (wouldBlock)
+        {
+          return;
+        }
+
+        break;
+      }
+
+      if (*received == 0)
+      {
+        break;
+      }
+
+      echoedBytes += *received;
+      EXPECT_FALSE(
+        jvs::error_to_bool(jvs::net::write(client, std::string_view(buffer, *received))));
+    }
+
+    // Disconnected: unregister and close from inside the handler.
+    EXPECT_FALSE(jvs::error_to_bool(reactor->remove(fd)));
+    client.close();
+    clients.erase(fd);
+    reactor->stop();
+  };
+
+  ASSERT_FALSE(jvs::error_to_bool(reactor->add(server, Reactor::Readable,
+    [&](Reactor::EventMask)
+    {
+      for (;;)
+      {
+        auto connection = server.accept();
+        if (!connection)
+        {
+          EXPECT_TRUE(connection.error_is_a<jvs::net::NonBlockingStatus>());
+          jvs::consume_error(connection.take_error());
+          return;
+        }
+
+        EXPECT_TRUE(connection->is_nonblocking());
+        auto fd = connection->descriptor();
+        clients[fd] = std::make_unique<Socket>(std::move(*connection));
+        EXPECT_FALSE(jvs::error_to_bool(reactor->add(fd, Reactor::Readable,
+          [&, fd](Reactor::EventMask events) { onClient(fd, events); })));
+      }
+    })));
+
+  auto clientTask = std::async(std::launch::async, [ep = *listenEp]
+    {
+      Socket client(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+      auto remoteEp = client.connect(ep);
+      if (!remoteEp)
+      {
+        jvs::consume_error(remoteEp.take_error());
+        return false;
+      }
+
+      std::string_view cs("Hello, reactor!\n");
+      if (jvs::error_to_bool(jvs::net::write(client, cs)))
+      {
+        return false;
+      }
+
+      std::string reply;
+      char buffer[64];
+      while (reply.size() < cs.size())
+      {
+        auto received = client.recv(buffer, sizeof(buffer));
+        if (!received || *received == 0)
+        {
+          if (!received)
+          {
+            jvs::consume_error(received.take_error());
+          }
+
+          break;
+        }
+
+        reply.append(buffer, *received);
+      }
+
+      client.close();
+      return reply == cs;
+    });
+
+  EXPECT_FALSE(jvs::error_to_bool(reactor->run()));
+  EXPECT_TRUE(clientTask.get());
+  EXPECT_EQ(echoedBytes, 16u);
+  EXPECT_EQ(reactor->size(), 1u);
+  EXPECT_FALSE(jvs::error_to_bool(reactor->remove(server)));
+  server.close();
+}
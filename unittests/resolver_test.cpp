@@ -0,0 +1,397 @@
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netdb.h>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/resolver.h>
+#include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_errors.h>
+
+namespace
+{
+
+using jvs::net::IpAddress;
+using jvs::net::IpEndPoint;
+using jvs::net::Resolver;
+using jvs::net::Socket;
+
+// Minimal DNS server on loopback answering A and AAAA queries for
+// "example.test" (and CNAME-free aliases of it) and NXDOMAIN for anything
+// else. Answers can be delayed to keep queries in flight, and their question
+// name altered.
+class StubDnsServer final
+{
+public:
+  enum class Echo
+  {
+    Question,
+    // Upper case, as servers randomizing the case of names may echo it.
+    UpperCaseQuestion,
+    // A different name, as in a forged answer.
+    OtherQuestion
+  };
+
+  explicit StubDnsServer(std::chrono::milliseconds delay = {}, bool silent = false,
+    Echo echo = Echo::Question)
+    : delay_(delay), silent_(silent), echo_(echo)
+  {
+    auto bound = socket_.bind(*IpEndPoint::parse("127.0.0.1:0"));
+    EXPECT_TRUE(static_cast<bool>(bound));
+    end_point_ = *bound;
+    thread_ = std::thread([this] { serve(); });
+  }
+
+  ~StubDnsServer()
+  {
+    // An empty datagram stops the server.
+    Socket stopper(IpAddress::Family::IPv4, Socket::Transport::Udp);
+    jvs::consume_error(stopper.sendto("", 0, end_point_).take_error());
+    thread_.join();
+    stopper.close();
+    socket_.close();
+  }
+
+  const IpEndPoint& end_point() const noexcept
+  {
+    return end_point_;
+  }
+
+  int queries() const noexcept
+  {
+    return queries_.load();
+  }
+
+private:
+  Socket socket_{IpAddress::Family::IPv4, Socket::Transport::Udp};
+  IpEndPoint end_point_{};
+  std::chrono::milliseconds delay_;
+  bool silent_;
+  Echo echo_;
+  std::atomic<int> queries_{0};
+  std::thread thread_{};
+
+  void serve()
+  {
+    std::array<std::uint8_t, 512> buffer{};
+    for (;;)
+    {
+      auto received = socket_.recvfrom(buffer.data(), buffer.size());
+      if (!received || received->first < 12)
+      {
+        jvs::consume_error(received.take_error());
+        return;
+      }
+
+      ++queries_;
+      if (silent_)
+      {
+        continue;
+      }
+
+      std::this_thread::sleep_for(delay_);
+      auto [size, from] = *received;
+      std::vector<std::uint8_t> response(buffer.begin(), buffer.begin() + size);
+      answer(response);
+      alter_question(response);
+      jvs::consume_error(socket_.sendto(response.data(), response.size(), from).take_error());
+    }
+  }
+
+  void alter_question(std::vector<std::uint8_t>& message) const
+  {
+    if (echo_ == Echo::OtherQuestion)
+    {
+      // First character of the first label.
+      message[13] = 'x';
+      return;
+    }
+
+    for (std::size_t position = 12; echo_ == Echo::UpperCaseQuestion &&
+      position < message.size() && message[position] != 0; position += message[position] + 1)
+    {
+      for (std::size_t i = 1; i <= message[position]; ++i)
+      {
+        message[position + i] =
+          static_cast<std::uint8_t>(std::toupper(message[position + i]));
+      }
+    }
+  }
+
+  static void answer(std::vector<std::uint8_t>& message)
+  {
+    // Read the question name back as a dotted string.
+    std::string name;
+    std::size_t position = 12;
+    while (position < message.size() && message[position] != 0)
+    {
+      std::size_t length = message[position++];
+      if (!name.empty())
+      {
+        name.push_back('.');
+      }
+
+      name.append(reinterpret_cast<const char*>(&message[position]), length);
+      position += length;
+    }
+
+    std::uint16_t type = static_cast<std::uint16_t>((message[position + 1] << 8) | message[position + 2]);
+    message.resize(position + 5);
+    message[2] = 0x81; // Response, recursion desired.
+    message[3] = 0x80; // Recursion available.
+    if (name != "example.test")
+    {
+      message[3] |= 3; // NXDOMAIN.
+      return;
+    }
+
+    std::vector<std::vector<std::uint8_t>> records;
+    if (type == 1)
+    {
+      records = {{192, 0, 2, 1}, {192, 0, 2, 2}};
+    }
+    else if (type == 28)
+    {
+      records = {{0x20, 0x01, 0x0d, 0xb8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1}};
+    }
+
+    message[7] = static_cast<std::uint8_t>(records.size());
+    for (auto& data : records)
+    {
+      // Name pointer to the question, type, class IN, TTL 300.
+      std::vector<std::uint8_t> record{0xc0, 12, 0, static_cast<std::uint8_t>(type), 0, 1,
+        0, 0, 0x01, 0x2c, 0, static_cast<std::uint8_t>(data.size())};
+      record.insert(record.end(), data.begin(), data.end());
+      message.insert(message.end(), record.begin(), record.end());
+    }
+  }
+};
+
+Resolver::Options stub_options(const StubDnsServer& server)
+{
+  Resolver::Options options;
+  options.servers = {server.end_point()};
+  options.timeout = std::chrono::milliseconds(200);
+  options.attempts = 1;
+  return options;
+}
+
+jvs::Expected<std::vector<IpEndPoint>> resolve(Resolver& resolver, std::string_view host,
+  IpAddress::Family family = IpAddress::Family::Unspecified)
+{
+  std::promise<jvs::Expected<std::vector<IpEndPoint>>> promise;
+  auto result = promise.get_future();
+  resolver.resolve(host, 443, family,
+    [&](jvs::Expected<std::vector<IpEndPoint>> endPoints)
+    {
+      promise.set_value(std::move(endPoints));
+    });
+
+  return result.get();
+}
+
+int addrinfo_error_code(jvs::Error e)
+{
+  int code = 0;
+  jvs::handle_all_errors(std::move(e),
+    [&](const jvs::net::AddressInfoError& error) { code = error.code(); });
+  return code;
+}
+
+} // namespace
+
+TEST(ResolverTest, NumericAndLocalhostNames)
+{
+  StubDnsServer server;
+  auto resolver = Resolver::create(stub_options(server));
+  ASSERT_TRUE(static_cast<bool>(resolver));
+
+  auto numeric = resolve(*resolver, "192.0.2.7");
+  ASSERT_TRUE(static_cast<bool>(numeric));
+  ASSERT_EQ(numeric->size(), 1u);
+  EXPECT_EQ((*numeric)[0].address(), *IpAddress::parse("192.0.2.7"));
+  EXPECT_EQ((*numeric)[0].port(), 443);
+
+  auto localhost = resolve(*resolver, "localhost", IpAddress::Family::IPv4);
+  ASSERT_TRUE(static_cast<bool>(localhost));
+  ASSERT_EQ(localhost->size(), 1u);
+  EXPECT_EQ((*localhost)[0].address(), IpAddress::ipv4_loopback());
+
+  auto mismatch = resolve(*resolver, "192.0.2.7", IpAddress::Family::IPv6);
+  ASSERT_FALSE(static_cast<bool>(mismatch));
+  EXPECT_EQ(addrinfo_error_code(mismatch.take_error()), EAI_NONAME);
+  EXPECT_EQ(server.queries(), 0);
+}
+
+TEST(ResolverTest, ResolvesAndCachesAddresses)
+{
+  StubDnsServer server;
+  auto resolver = Resolver::create(stub_options(server));
+  ASSERT_TRUE(static_cast<bool>(resolver));
+
+  auto endPoints = resolve(*resolver, "Example.Test.");
+  ASSERT_TRUE(static_cast<bool>(endPoints));
+  ASSERT_EQ(endPoints->size(), 3u);
+  // IPv6 first.
+  EXPECT_EQ((*endPoints)[0].address(), *IpAddress::parse("2001:db8::1"));
+  EXPECT_EQ((*endPoints)[1].address(), *IpAddress::parse("192.0.2.1"));
+  EXPECT_EQ((*endPoints)[2].address(), *IpAddress::parse("192.0.2.2"));
+  EXPECT_EQ((*endPoints)[2].port(), 443);
+  EXPECT_EQ(server.queries(), 2);
+  EXPECT_EQ(resolver->cached(), 2u);
+
+  // Served from the cache, synchronously.
+  bool completed = false;
+  resolver->resolve("example.test", 80,
+    [&](jvs::Expected<std::vector<IpEndPoint>> cached)
+    {
+      ASSERT_TRUE(static_cast<bool>(cached));
+      EXPECT_EQ(cached->size(), 3u);
+      completed = true;
+    });
+  EXPECT_TRUE(completed);
+  EXPECT_EQ(server.queries(), 2);
+
+  resolver->clear_cache();
+  EXPECT_EQ(resolver->cached(), 0u);
+  auto ipv4 = resolve(*resolver, "example.test", IpAddress::Family::IPv4);
+  ASSERT_TRUE(static_cast<bool>(ipv4));
+  EXPECT_EQ(ipv4->size(), 2u);
+  EXPECT_EQ(server.queries(), 3);
+}
+
+TEST(ResolverTest, CoalescesConcurrentLookups)
+{
+  StubDnsServer server(std::chrono::milliseconds(50));
+  auto resolver = Resolver::create(stub_options(server));
+  ASSERT_TRUE(static_cast<bool>(resolver));
+
+  constexpr int LookupCount = 5;
+  std::array<std::promise<std::size_t>, LookupCount> promises;
+  for (auto& promise : promises)
+  {
+    resolver->resolve("example.test", 443, IpAddress::Family::IPv4,
+      [&promise](jvs::Expected<std::vector<IpEndPoint>> endPoints)
+      {
+        promise.set_value(endPoints ? endPoints->size() : 0);
+        jvs::consume_error(endPoints.take_error());
+      });
+  }
+
+  for (auto& promise : promises)
+  {
+    EXPECT_EQ(promise.get_future().get(), 2u);
+  }
+
+  EXPECT_EQ(server.queries(), 1);
+}
+
+TEST(ResolverTest, NegativeAnswersAreCached)
+{
+  StubDnsServer server;
+  auto resolver = Resolver::create(stub_options(server));
+  ASSERT_TRUE(static_cast<bool>(resolver));
+
+  auto missing = resolve(*resolver, "missing.test");
+  ASSERT_FALSE(static_cast<bool>(missing));
+  EXPECT_EQ(addrinfo_error_code(missing.take_error()), EAI_NONAME);
+  EXPECT_EQ(server.queries(), 2);
+
+  missing = resolve(*resolver, "missing.test");
+  ASSERT_FALSE(static_cast<bool>(missing));
+  jvs::consume_error(missing.take_error());
+  EXPECT_EQ(server.queries(), 2);
+
+  auto invalid = resolve(*resolver, "bad..name");
+  ASSERT_FALSE(static_cast<bool>(invalid));
+  EXPECT_EQ(addrinfo_error_code(invalid.take_error()), EAI_NONAME);
+}
+
+TEST(ResolverTest, CachingCanBeDisabled)
+{
+  StubDnsServer server;
+  auto options = stub_options(server);
+  options.max_ttl = std::chrono::seconds(0);
+  auto resolver = Resolver::create(options);
+  ASSERT_TRUE(static_cast<bool>(resolver));
+
+  for (int i = 0; i < 2; ++i)
+  {
+    auto endPoints = resolve(*resolver, "example.test", IpAddress::Family::IPv6);
+    ASSERT_TRUE(static_cast<bool>(endPoints));
+    EXPECT_EQ(endPoints->size(), 1u);
+  }
+
+  EXPECT_EQ(server.queries(), 2);
+  EXPECT_EQ(resolver->cached(), 0u);
+}
+
+TEST(ResolverTest, TimesOutWithoutAnswer)
+{
+  StubDnsServer server(std::chrono::milliseconds(0), /*silent*/ true);
+  auto options = stub_options(server);
+  options.timeout = std::chrono::milliseconds(50);
+  options.attempts = 2;
+  auto resolver = Resolver::create(options);
+  ASSERT_TRUE(static_cast<bool>(resolver));
+
+  auto start = std::chrono::steady_clock::now();
+  auto endPoints = resolve(*resolver, "example.test", IpAddress::Family::IPv4);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  ASSERT_FALSE(static_cast<bool>(endPoints));
+  EXPECT_EQ(addrinfo_error_code(endPoints.take_error()), EAI_AGAIN);
+  EXPECT_GE(elapsed, std::chrono::milliseconds(100));
+  EXPECT_EQ(server.queries(), 2);
+  EXPECT_EQ(resolver->cached(), 0u);
+}
+
+TEST(ResolverTest, ChecksTheQuestionName)
+{
+  StubDnsServer upperCase(std::chrono::milliseconds(0), /*silent*/ false,
+    StubDnsServer::Echo::UpperCaseQuestion);
+  auto resolver = Resolver::create(stub_options(upperCase));
+  ASSERT_TRUE(static_cast<bool>(resolver));
+  auto endPoints = resolve(*resolver, "example.test", IpAddress::Family::IPv4);
+  ASSERT_TRUE(static_cast<bool>(endPoints));
+  EXPECT_EQ(endPoints->size(), 2u);
+
+  // Answers for another name are ignored even though the ID matches.
+  StubDnsServer other(std::chrono::milliseconds(0), /*silent*/ false,
+    StubDnsServer::Echo::OtherQuestion);
+  auto options = stub_options(other);
+  options.timeout = std::chrono::milliseconds(50);
+  auto otherResolver = Resolver::create(options);
+  ASSERT_TRUE(static_cast<bool>(otherResolver));
+  endPoints = resolve(*otherResolver, "example.test", IpAddress::Family::IPv4);
+  ASSERT_FALSE(static_cast<bool>(endPoints));
+  EXPECT_EQ(addrinfo_error_code(endPoints.take_error()), EAI_AGAIN);
+  EXPECT_EQ(other.queries(), 1);
+  EXPECT_EQ(otherResolver->cached(), 0u);
+}
+
+TEST(ResolverTest, PendingLookupsAreCanceled)
+{
+  StubDnsServer server(std::chrono::milliseconds(0), /*silent*/ true);
+  std::promise<bool> canceled;
+  {
+    auto resolver = Resolver::create(stub_options(server));
+    ASSERT_TRUE(static_cast<bool>(resolver));
+    resolver->resolve("example.test", 443,
+      [&](jvs::Expected<std::vector<IpEndPoint>> endPoints)
+      {
+        canceled.set_value(!endPoints && endPoints.error_is_a<jvs::net::SocketError>());
+        jvs::consume_error(endPoints.take_error());
+      });
+  }
+
+  EXPECT_TRUE(canceled.get_future().get());
+}
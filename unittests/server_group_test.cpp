@@ -0,0 +1,179 @@
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/reactor.h>
+#include <jvs-netlib/server_group.h>
+#include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_errors.h>
+
+namespace
+{
+
+using jvs::net::IpAddress;
+using jvs::net::IpEndPoint;
+using jvs::net::Reactor;
+using jvs::net::ServerGroup;
+using jvs::net::Socket;
+
+// Echoes everything received, recording the threads it ran on.
+class EchoHandler final
+{
+public:
+  bool operator()(Socket& connection, Reactor::EventMask)
+  {
+    {
+      std::lock_guard lock(mutex_);
+      threads_.insert(std::this_thread::get_id());
+    }
+
+    std::array<char, 256> buffer{};
+    for (;;)
+    {
+      auto received = connection.recv(buffer.data(), buffer.size());
+      if (!received)
+      {
+        bool pending = received.error_is_a<jvs::net::NonBlockingStatus>();
+        jvs::consume_error(received.take_error());
+        return pending;
+      }
+
+      if (*received == 0)
+      {
+        return false;
+      }
+
+      auto sent = connection.send(buffer.data(), *received);
+      if (!sent)
+      {
+        jvs::consume_error(sent.take_error());
+        return false;
+      }
+    }
+  }
+
+  std::size_t thread_count() const
+  {
+    std::lock_guard lock(mutex_);
+    return threads_.size();
+  }
+
+private:
+  mutable std::mutex mutex_{};
+  std::set<std::thread::id> threads_{};
+};
+
+bool wait_for_connections(const ServerGroup& group, std::size_t count)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+  while (group.connections() != count)
+  {
+    if (std::chrono::steady_clock::now() > deadline)
+    {
+      return false;
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  return true;
+}
+
+} // namespace
+
+TEST(ServerGroupTest, ReusePortAllowsSharedBind)
+{
+  Socket first(IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  Socket second(IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_FALSE(first.set_reuse_port(true));
+  ASSERT_FALSE(second.set_reuse_port(true));
+  auto bound = first.bind(*IpEndPoint::parse("127.0.0.1:0"));
+  ASSERT_TRUE(static_cast<bool>(bound));
+  auto listening = first.listen(16);
+  ASSERT_TRUE(static_cast<bool>(listening));
+  EXPECT_TRUE(static_cast<bool>(second.bind(*listening)));
+  first.close();
+  second.close();
+}
+
+TEST(ServerGroupTest, ShardsConnectionsAcrossWorkers)
+{
+  EchoHandler echo;
+  ServerGroup::Options options;
+  options.threads = 2;
+  options.pin_threads = false;
+  auto group = ServerGroup::create(*IpEndPoint::parse("127.0.0.1:0"),
+    [&echo](Socket& connection, Reactor::EventMask events) { return echo(connection, events); },
+    options);
+  ASSERT_TRUE(static_cast<bool>(group));
+  EXPECT_EQ(group->size(), 2u);
+  EXPECT_NE(group->local().port(), 0);
+
+  constexpr std::size_t ClientCount = 32;
+  std::vector<Socket> clients;
+  for (std::size_t i = 0; i < ClientCount; ++i)
+  {
+    clients.emplace_back(IpAddress::Family::IPv4, Socket::Transport::Tcp);
+    ASSERT_TRUE(static_cast<bool>(clients.back().connect(group->local())));
+  }
+
+  ASSERT_TRUE(wait_for_connections(*group, ClientCount));
+  for (auto& client : clients)
+  {
+    ASSERT_TRUE(static_cast<bool>(client.send("ping", 4)));
+    std::array<char, 4> reply{};
+    auto received = client.recv(reply.data(), reply.size(), MSG_WAITALL);
+    ASSERT_TRUE(static_cast<bool>(received));
+    EXPECT_EQ(std::string_view(reply.data(), *received), "ping");
+  }
+
+  // With 32 connections hashed over two listeners, both are all but certain
+  // to have been used.
+  EXPECT_EQ(echo.thread_count(), 2u);
+
+  for (std::size_t i = 0; i < ClientCount / 2; ++i)
+  {
+    clients[i].close();
+  }
+
+  EXPECT_TRUE(wait_for_connections(*group, ClientCount / 2));
+  group->stop();
+  EXPECT_EQ(group->connections(), 0u);
+
+  // The server side has been closed.
+  char c = 0;
+  auto received = clients.back().recv(&c, 1);
+  ASSERT_TRUE(static_cast<bool>(received));
+  EXPECT_EQ(*received, 0u);
+  for (std::size_t i = ClientCount / 2; i < ClientCount; ++i)
+  {
+    clients[i].close();
+  }
+}
+
+TEST(ServerGroupTest, CpuSteering)
+{
+  EchoHandler echo;
+  ServerGroup::Options options;
+  options.threads = 2;
+  options.cpu_steering = true;
+  auto group = ServerGroup::create(*IpEndPoint::parse("[::1]:0"),
+    [&echo](Socket& connection, Reactor::EventMask events) { return echo(connection, events); },
+    options);
+  ASSERT_TRUE(static_cast<bool>(group));
+
+  Socket client(IpAddress::Family::IPv6, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(client.connect(group->local())));
+  ASSERT_TRUE(static_cast<bool>(client.send("x", 1)));
+  char c = 0;
+  auto received = client.recv(&c, 1);
+  ASSERT_TRUE(static_cast<bool>(received));
+  EXPECT_EQ(c, 'x');
+  client.close();
+}
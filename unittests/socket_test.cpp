@@ -1,17 +1,21 @@
 #include <algorithm>
 #include <array>
+#include <cerrno>
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <future>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <span>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <vector>
 
 #if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
@@ -35,6 +39,7 @@
 #include <jvs-netlib/ip_end_point.h>
 #include <jvs-netlib/network_integers.h>
 #include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_options.h>
 #include <jvs-netlib/transport_end_point.h>
 
 namespace
@@ -669,3 +674,746 @@ TEST(SocketTest, UdpIpv4)
   waitForAll(serverTask, clientTask);
   EXPECT_TRUE(serverTask.get() && clientTask.get());
 }
+
+TEST(SocketTest, NonBlockingRecvWouldBlock)
+{
+  jvs::net::Socket sock(jvs::net::IpAddress::Family::IPv4,
+    jvs::net::Socket::Transport::Udp, /*nonBlocking*/ true);
+  EXPECT_TRUE(sock.is_nonblocking());
+  auto boundEp = sock.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"));
+  ASSERT_TRUE(static_cast<bool>(boundEp));
+
+  char buffer[16];
+  auto received = sock.recv(buffer, sizeof(buffer));
+  EXPECT_FALSE(static_cast<bool>(received));
+  EXPECT_TRUE(received.error_is_a<jvs::net::NonBlockingStatus>());
+  jvs::handle_all_errors(received.take_error(),
+    [](const jvs::net::NonBlockingStatus& e)
+    {
+      EXPECT_FALSE(e.is_fatal());
+      EXPECT_FALSE(e.message().empty());
+    });
+
+  EXPECT_FALSE(jvs::error_to_bool(sock.set_nonblocking(false)));
+  EXPECT_FALSE(sock.is_nonblocking());
+  sock.close();
+}
+
+TEST(SocketTest, NonBlockingConnectTcpv4)
+{
+  jvs::net::Socket server(jvs::net::IpAddress::Family::IPv4,
+    jvs::net::Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(
+    server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"))));
+  auto listenEp = server.listen();
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+
+  jvs::net::Socket client(jvs::net::IpAddress::Family::IPv4,
+    jvs::net::Socket::Transport::Tcp, /*nonBlocking*/ true);
+  auto connectEp = client.connect(*listenEp);
+  if (!connectEp)
+  {
+    ASSERT_TRUE(connectEp.error_is_a<jvs::net::NonBlockingStatus>());
+    jvs::consume_error(connectEp.take_error());
+    for (int i = 0; i < 100; ++i)
+    {
+      connectEp = client.finish_connect();
+      if (connectEp || !connectEp.error_is_a<jvs::net::NonBlockingStatus>())
+      {
+        break;
+      }
+
+      jvs::consume_error(connectEp.take_error());
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  ASSERT_TRUE(static_cast<bool>(connectEp));
+  EXPECT_EQ(connectEp->port(), listenEp->port());
+  EXPECT_FALSE(jvs::error_to_bool(client.connect_result()));
+
+  auto connection = server.accept();
+  ASSERT_TRUE(static_cast<bool>(connection));
+  EXPECT_FALSE(connection->is_nonblocking());
+  connection->close();
+  client.close();
+  server.close();
+}
+
+TEST(SocketTest, LocalEndPointTcpv4)
+{
+  jvs::net::Socket server(jvs::net::IpAddress::Family::IPv4,
+    jvs::net::Socket::Transport::Tcp);
+  auto boundEp = server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"));
+  ASSERT_TRUE(static_cast<bool>(boundEp));
+  EXPECT_NE(boundEp->port(), 0);
+  auto sameEndPoint = [](const jvs::net::IpEndPoint& a, const jvs::net::IpEndPoint& b)
+  {
+    return a.address() == b.address() && a.port() == b.port();
+  };
+
+  EXPECT_TRUE(sameEndPoint(server.local(), *boundEp));
+  auto listenEp = server.listen();
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+  EXPECT_TRUE(sameEndPoint(*listenEp, *boundEp));
+
+  // Connections are created and destroyed repeatedly to exercise reuse of
+  // the recycled implementation objects.
+  for (int i = 0; i < 4; ++i)
+  {
+    jvs::net::Socket client(jvs::net::IpAddress::Family::IPv4,
+      jvs::net::Socket::Transport::Tcp);
+    ASSERT_TRUE(static_cast<bool>(client.connect(*listenEp)));
+    auto connection = server.accept();
+    ASSERT_TRUE(static_cast<bool>(connection));
+    EXPECT_TRUE(sameEndPoint(connection->local(), *listenEp));
+    ASSERT_TRUE(connection->remote().has_value());
+    EXPECT_TRUE(sameEndPoint(*connection->remote(), client.local()));
+    ASSERT_TRUE(client.remote().has_value());
+    EXPECT_TRUE(sameEndPoint(*client.remote(), *listenEp));
+    connection->close();
+    EXPECT_EQ(connection->local().port(), 0);
+    client.close();
+  }
+
+  server.close();
+}
+
+TEST(SocketTest, AcceptFromWildcardListenerTcpv4)
+{
+  jvs::net::Socket server(jvs::net::IpAddress::Family::IPv4,
+    jvs::net::Socket::Transport::Tcp, /*nonBlocking*/ true);
+  auto listenEp = server.bind(*jvs::net::IpEndPoint::parse("0.0.0.0:0"));
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+  ASSERT_TRUE(static_cast<bool>(server.listen()));
+
+  jvs::net::Socket client(jvs::net::IpAddress::Family::IPv4,
+    jvs::net::Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(client.connect(
+    jvs::net::IpAddress::ipv4_loopback(), listenEp->port())));
+
+  auto connection = server.accept();
+  for (int i = 0; i < 100 && !connection &&
+    connection.error_is_a<jvs::net::NonBlockingStatus>(); ++i)
+  {
+    jvs::consume_error(connection.take_error());
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    connection = server.accept();
+  }
+
+  ASSERT_TRUE(static_cast<bool>(connection));
+  EXPECT_TRUE(connection->is_nonblocking());
+  // The local address is the one the connection arrived on, not the
+  // listener's wildcard address.
+  EXPECT_EQ(connection->local().address(), jvs::net::IpAddress::ipv4_loopback());
+  EXPECT_EQ(connection->local().port(), listenEp->port());
+  connection->close();
+  client.close();
+  server.close();
+}
+
+TEST(SocketTest, NonBlockingConnectRefused)
+{
+  // Reserve an ephemeral port that nothing is listening on.
+  jvs::net::Socket unused(jvs::net::IpAddress::Family::IPv4,
+    jvs::net::Socket::Transport::Tcp);
+  auto unusedEp = unused.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"));
+  ASSERT_TRUE(static_cast<bool>(unusedEp));
+
+  jvs::net::Socket client(jvs::net::IpAddress::Family::IPv4,
+    jvs::net::Socket::Transport::Tcp, /*nonBlocking*/ true);
+  auto connectEp = client.connect(*unusedEp);
+  for (int i = 0; i < 100 && !connectEp &&
+    connectEp.error_is_a<jvs::net::NonBlockingStatus>(); ++i)
+  {
+    jvs::consume_error(connectEp.take_error());
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    connectEp = client.finish_connect();
+  }
+
+  ASSERT_FALSE(static_cast<bool>(connectEp));
+  int errorCode = 0;
+  jvs::handle_all_errors(connectEp.take_error(),
+    [&](const jvs::net::SocketError& e) { errorCode = e.code(); });
+  EXPECT_EQ(errorCode, jvs::net::errcodes::EConnRefused);
+  client.close();
+  unused.close();
+}
+
+TEST(SocketTest, SocketErrorMessages)
+{
+  auto messageOf = [](jvs::Error e)
+  {
+    std::string message;
+    jvs::handle_all_errors(std::move(e),
+      [&](const jvs::ErrorInfoBase& info) { message = info.message(); });
+    return message;
+  };
+
+  auto refused = jvs::make_error<jvs::net::SocketError>(
+    jvs::net::errcodes::EConnRefused);
+  EXPECT_TRUE(refused.is_a<jvs::net::SocketError>());
+  std::string refusedMessage = messageOf(std::move(refused));
+  auto codePos = refusedMessage.find(
+    " (" + std::to_string(jvs::net::errcodes::EConnRefused) + " = 0x");
+  EXPECT_NE(codePos, std::string::npos);
+  EXPECT_GT(codePos, 0u);
+
+  auto explicitMessage = jvs::make_error<jvs::net::SocketError>(
+    jvs::net::errcodes::ETimedOut, "Custom message");
+  EXPECT_EQ(messageOf(std::move(explicitMessage)).rfind("Custom message (", 0), 0u);
+
+  // Subclasses describe their code lazily as well: UnsupportedError like any
+  // socket error, AddressInfoError with the resolver's description.
+  auto unsupported = jvs::make_error<jvs::net::UnsupportedError>(
+    jvs::net::errcodes::EOpNotSupp);
+  std::string unsupportedMessage = messageOf(std::move(unsupported));
+  codePos = unsupportedMessage.find(
+    " (" + std::to_string(jvs::net::errcodes::EOpNotSupp) + " = 0x");
+  EXPECT_NE(codePos, std::string::npos);
+  EXPECT_GT(codePos, 0u);
+  EXPECT_EQ(unsupportedMessage, messageOf(jvs::make_error<jvs::net::SocketError>(
+    jvs::net::errcodes::EOpNotSupp)));
+
+  auto addrInfo = jvs::make_error<jvs::net::AddressInfoError>(EAI_NONAME);
+  std::string addrInfoMessage = messageOf(std::move(addrInfo));
+  codePos = addrInfoMessage.find(" (" + std::to_string(EAI_NONAME) + " = 0x");
+  ASSERT_NE(codePos, std::string::npos);
+  EXPECT_EQ(addrInfoMessage.substr(0, codePos), std::string(gai_strerror(EAI_NONAME)));
+}
+
+TEST(SocketTest, ScatterGatherTcpv4)
+{
+  jvs::net::Socket server(jvs::net::IpAddress::Family::IPv4,
+    jvs::net::Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(
+    server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"))));
+  auto listenEp = server.listen();
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+
+  auto clientTask = std::async(std::launch::async, [ep = *listenEp]
+    {
+      jvs::net::Socket client(jvs::net::IpAddress::Family::IPv4,
+        jvs::net::Socket::Transport::Tcp);
+      auto remoteEp = client.connect(ep);
+      if (!remoteEp)
+      {
+        jvs::handle_all_errors(remoteEp.take_error(), HandleSocketError);
+        return false;
+      }
+
+      std::string_view header("HDR:");
+      std::string_view payload("payload");
+      std::string_view trailer(";");
+      std::array<std::span<const std::byte>, 3> buffers {
+        std::as_bytes(std::span(header)),
+        std::as_bytes(std::span(payload)),
+        std::as_bytes(std::span(trailer))
+      };
+
+      auto bytesSent = client.sendv(buffers);
+      if (!bytesSent)
+      {
+        jvs::handle_all_errors(bytesSent.take_error(), HandleSocketError);
+        return false;
+      }
+
+      client.close();
+      return *bytesSent == 12;
+    });
+
+  auto connection = server.accept();
+  ASSERT_TRUE(static_cast<bool>(connection));
+  EXPECT_TRUE(clientTask.get());
+
+  std::array<std::byte, 4> first{};
+  std::array<std::byte, 16> second{};
+  std::array<std::span<std::byte>, 2> buffers {
+    std::span(first), std::span(second)
+  };
+
+  std::size_t totalReceived = 0;
+  for (;;)
+  {
+    auto received = connection->recvv(buffers);
+    ASSERT_TRUE(static_cast<bool>(received));
+    if (*received == 0)
+    {
+      break;
+    }
+
+    // Everything was sent before the peer closed, so it arrives in one read.
+    totalReceived += *received;
+    EXPECT_EQ(*received, 12u);
+  }
+
+  EXPECT_EQ(totalReceived, 12u);
+  EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(first.data()), 4), "HDR:");
+  EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(second.data()), 8), "payload;");
+  connection->close();
+  server.close();
+}
+
+TEST(SocketTest, WriteAllManyBuffers)
+{
+  jvs::net::Socket server(jvs::net::IpAddress::Family::IPv4,
+    jvs::net::Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(
+    server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"))));
+  auto listenEp = server.listen();
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+
+  // More buffers than a single sendv call takes, and enough data to overflow
+  // the socket buffers so that partial writes occur.
+  constexpr std::size_t BufferCount = jvs::net::Socket::MaxIoBuffers * 3 + 5;
+  constexpr std::size_t BufferSize = 8191;
+  std::vector<std::vector<std::uint8_t>> storage(BufferCount);
+  std::vector<std::span<const std::byte>> buffers;
+  for (std::size_t i = 0; i < BufferCount; ++i)
+  {
+    storage[i].assign((i % 7 == 0) ? 0 : BufferSize, static_cast<std::uint8_t>(i));
+    buffers.push_back(std::as_bytes(std::span(storage[i])));
+  }
+
+  auto clientTask = std::async(std::launch::async, [&, ep = *listenEp]
+    {
+      jvs::net::Socket client(jvs::net::IpAddress::Family::IPv4,
+        jvs::net::Socket::Transport::Tcp);
+      auto remoteEp = client.connect(ep);
+      if (!remoteEp)
+      {
+        jvs::handle_all_errors(remoteEp.take_error(), HandleSocketError);
+        return false;
+      }
+
+      bool result = !jvs::error_to_bool(jvs::net::write_all(client, buffers));
+      client.close();
+      return result;
+    });
+
+  auto connection = server.accept();
+  ASSERT_TRUE(static_cast<bool>(connection));
+
+  std::vector<std::uint8_t> received;
+  std::vector<std::uint8_t> chunk(65536);
+  for (;;)
+  {
+    auto bytesReceived = connection->recv(chunk.data(), chunk.size());
+    ASSERT_TRUE(static_cast<bool>(bytesReceived));
+    if (*bytesReceived == 0)
+    {
+      break;
+    }
+
+    received.insert(received.end(), chunk.begin(), chunk.begin() + *bytesReceived);
+  }
+
+  EXPECT_TRUE(clientTask.get());
+  std::vector<std::uint8_t> expected;
+  for (const auto& buffer : storage)
+  {
+    expected.insert(expected.end(), buffer.begin(), buffer.end());
+  }
+
+  EXPECT_EQ(received.size(), expected.size());
+  EXPECT_TRUE(received == expected);
+  connection->close();
+  server.close();
+}
+
+TEST(SocketTest, BatchUdpv4)
+{
+  using jvs::net::Socket;
+
+  Socket receiver(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Udp);
+  auto receiverEp = receiver.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"));
+  ASSERT_TRUE(static_cast<bool>(receiverEp));
+
+  Socket sender(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Udp);
+  auto senderEp = sender.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"));
+  ASSERT_TRUE(static_cast<bool>(senderEp));
+
+  const std::array<std::string_view, 5> payloads{"one", "two", "three", "four", "five"};
+  std::array<Socket::SendSlot, 5> sendSlots{};
+  for (std::size_t i = 0; i < payloads.size(); ++i)
+  {
+    sendSlots[i].buffer = std::as_bytes(std::span(payloads[i].data(), payloads[i].size()));
+    sendSlots[i].remote = *receiverEp;
+  }
+
+  std::size_t sentCount = 0;
+  while (sentCount < sendSlots.size())
+  {
+    auto sent = sender.send_batch(std::span(sendSlots).subspan(sentCount));
+    ASSERT_TRUE(static_cast<bool>(sent));
+    sentCount += *sent;
+  }
+
+  for (std::size_t i = 0; i < payloads.size(); ++i)
+  {
+    EXPECT_EQ(sendSlots[i].length, payloads[i].size());
+  }
+
+  std::array<std::array<std::byte, 64>, 8> storage{};
+  std::array<Socket::RecvSlot, 8> recvSlots{};
+  for (std::size_t i = 0; i < recvSlots.size(); ++i)
+  {
+    recvSlots[i].buffer = storage[i];
+  }
+
+  std::vector<std::string> received;
+  while (received.size() < payloads.size())
+  {
+    auto count = receiver.recv_batch(std::span(recvSlots).first(4));
+    ASSERT_TRUE(static_cast<bool>(count));
+    ASSERT_GT(*count, 0u);
+    for (std::size_t i = 0; i < *count; ++i)
+    {
+      received.emplace_back(
+        reinterpret_cast<const char*>(recvSlots[i].buffer.data()), recvSlots[i].length);
+      EXPECT_EQ(recvSlots[i].remote.address(), senderEp->address());
+      EXPECT_EQ(recvSlots[i].remote.port(), senderEp->port());
+    }
+  }
+
+  ASSERT_EQ(received.size(), payloads.size());
+  for (std::size_t i = 0; i < payloads.size(); ++i)
+  {
+    EXPECT_EQ(received[i], payloads[i]);
+  }
+
+  // Without sender addresses, slots report an unspecified remote.
+  sendSlots[0].remote = *receiverEp;
+  auto sent = sender.send_batch(std::span(sendSlots).first(1));
+  ASSERT_TRUE(static_cast<bool>(sent));
+  auto count = receiver.recv_batch(recvSlots, /*fillRemote*/ false);
+  ASSERT_TRUE(static_cast<bool>(count));
+  ASSERT_EQ(*count, 1u);
+  EXPECT_EQ(recvSlots[0].length, payloads[0].size());
+  EXPECT_EQ(recvSlots[0].remote.address().family(), jvs::net::IpAddress::Family::Unspecified);
+
+  sender.close();
+  receiver.close();
+}
+
+TEST(SocketTest, SegmentationOffloadUdpv4)
+{
+  using jvs::net::Socket;
+
+  Socket receiver(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Udp);
+  auto receiverEp = receiver.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"));
+  ASSERT_TRUE(static_cast<bool>(receiverEp));
+  auto groEnabled = receiver.set_udp_gro(true);
+  if (groEnabled)
+  {
+    // Without GRO every segment simply arrives as its own datagram.
+    EXPECT_TRUE(groEnabled.is_a<jvs::net::UnsupportedError>());
+    jvs::consume_error(std::move(groEnabled));
+  }
+
+  Socket sender(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Udp);
+
+  constexpr std::size_t SegmentSize = 1000;
+  constexpr std::size_t SegmentCount = 10;
+  std::vector<std::uint8_t> payload(SegmentSize * SegmentCount - 123);
+  for (std::size_t i = 0; i < payload.size(); ++i)
+  {
+    payload[i] = static_cast<std::uint8_t>(i / SegmentSize);
+  }
+
+  auto sent = sender.sendto_segmented(payload.data(), payload.size(), SegmentSize, *receiverEp);
+  ASSERT_TRUE(static_cast<bool>(sent));
+  EXPECT_EQ(*sent, payload.size());
+
+  std::vector<std::byte> buffer(65536);
+  std::size_t receivedSize = 0;
+  std::size_t segmentIndex = 0;
+  while (receivedSize < payload.size())
+  {
+    auto datagram = receiver.recvfrom_segmented(buffer.data(), buffer.size());
+    ASSERT_TRUE(static_cast<bool>(datagram));
+    ASSERT_GT(datagram->segment_count(), 0u);
+    EXPECT_EQ(datagram->segment_size, SegmentSize);
+    for (std::size_t i = 0; i < datagram->segment_count(); ++i, ++segmentIndex)
+    {
+      auto segment = datagram->segment(i);
+      EXPECT_EQ(segment.size(),
+        std::min(SegmentSize, payload.size() - segmentIndex * SegmentSize));
+      EXPECT_TRUE(std::all_of(segment.begin(), segment.end(),
+        [&](std::byte b) { return std::to_integer<std::size_t>(b) == segmentIndex; }));
+      receivedSize += segment.size();
+    }
+  }
+
+  EXPECT_EQ(receivedSize, payload.size());
+  EXPECT_EQ(segmentIndex, SegmentCount);
+
+  for (std::size_t badSize : {std::size_t{0}, std::size_t{65536}, std::size_t{70000}})
+  {
+    auto rejected = sender.sendto_segmented(payload.data(), payload.size(), badSize, *receiverEp);
+    ASSERT_FALSE(static_cast<bool>(rejected));
+    int errorCode = 0;
+    jvs::handle_all_errors(rejected.take_error(),
+      [&](const jvs::net::SocketError& e) { errorCode = e.code(); });
+    EXPECT_EQ(errorCode, jvs::net::errcodes::EMsgSize);
+  }
+
+  sender.close();
+  receiver.close();
+}
+
+TEST(SocketTest, ZeroCopySendTcpv4)
+{
+  using jvs::net::Socket;
+
+  Socket server(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"))));
+  auto listenEp = server.listen();
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+
+  Socket client(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(client.connect(*listenEp)));
+  auto connection = server.accept();
+  ASSERT_TRUE(static_cast<bool>(connection));
+
+  constexpr std::size_t PayloadSize = 1 << 20;
+  std::vector<std::byte> payload(PayloadSize, std::byte{0x5a});
+  auto receiverTask = std::async(std::launch::async, [&]
+    {
+      std::vector<std::byte> buffer(64 * 1024);
+      std::size_t totalReceived = 0;
+      while (totalReceived < PayloadSize)
+      {
+        auto received = connection->recv(buffer.data(), buffer.size());
+        if (!received || *received == 0)
+        {
+          jvs::consume_error(received.take_error());
+          break;
+        }
+
+        totalReceived += *received;
+      }
+
+      return totalReceived;
+    });
+
+  std::size_t sentSize = 0;
+  std::uint32_t lastId = 0;
+  // An empty send would get no ID from the kernel, so it must not use one.
+  auto empty = client.send_zerocopy(payload.data(), 0);
+  ASSERT_FALSE(static_cast<bool>(empty));
+  int errorCode = 0;
+  jvs::handle_all_errors(empty.take_error(),
+    [&](const jvs::net::SocketError& e) { errorCode = e.code(); });
+  EXPECT_EQ(errorCode, EINVAL);
+  while (sentSize < PayloadSize)
+  {
+    auto sent = client.send_zerocopy(payload.data() + sentSize, PayloadSize - sentSize);
+    if (!sent && sentSize == 0 && sent.error_is_a<jvs::net::UnsupportedError>())
+    {
+      jvs::consume_error(sent.take_error());
+      client.close();
+      receiverTask.wait();
+      connection->close();
+      server.close();
+      GTEST_SKIP();
+    }
+
+    ASSERT_TRUE(static_cast<bool>(sent));
+    EXPECT_EQ(sent->id, (sentSize == 0) ? 0u : lastId + 1);
+
+    lastId = sent->id;
+    sentSize += sent->length;
+  }
+
+  EXPECT_EQ(receiverTask.get(), PayloadSize);
+
+  // The buffer is released once the receiver has consumed the data.
+  bool released = false;
+  for (int i = 0; i < 100 && !released; ++i)
+  {
+    auto completion = client.recv_zerocopy_completion();
+    if (!completion)
+    {
+      EXPECT_TRUE(completion.error_is_a<jvs::net::NonBlockingStatus>());
+      jvs::consume_error(completion.take_error());
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+
+    released = completion->contains(lastId);
+  }
+
+  EXPECT_TRUE(released);
+  auto none = client.recv_zerocopy_completion();
+  EXPECT_FALSE(static_cast<bool>(none));
+  jvs::consume_error(none.take_error());
+  connection->close();
+  client.close();
+  server.close();
+}
+
+#if defined(__linux__)
+
+TEST(SocketTest, SendFileAndSpliceTcpv4)
+{
+  using jvs::net::Socket;
+
+  Socket server(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"))));
+  auto listenEp = server.listen();
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+
+  Socket client(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(client.connect(*listenEp)));
+  auto connection = server.accept();
+  ASSERT_TRUE(static_cast<bool>(connection));
+
+  std::string contents(300000, '\0');
+  for (std::size_t i = 0; i < contents.size(); ++i)
+  {
+    contents[i] = static_cast<char>('a' + i % 26);
+  }
+
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(std::fwrite(contents.data(), 1, contents.size(), file), contents.size());
+  ASSERT_EQ(std::fflush(file), 0);
+  int fd = ::fileno(file);
+
+  // Skip the first 1000 bytes of the file; the relayed tail follows it.
+  constexpr std::size_t Offset = 1000;
+  std::string_view relayed("relayed through a pipe");
+  auto senderTask = std::async(std::launch::async, [&]
+    {
+      if (jvs::error_to_bool(
+        jvs::net::write_file(client, fd, Offset, contents.size() - Offset)))
+      {
+        return false;
+      }
+
+      int pipeFds[2];
+      if (::pipe(pipeFds) != 0)
+      {
+        return false;
+      }
+
+      bool spliced = ::write(pipeFds[1], relayed.data(), relayed.size()) ==
+        static_cast<ssize_t>(relayed.size());
+      std::size_t splicedSize = 0;
+      while (spliced && splicedSize < relayed.size())
+      {
+        auto moved = client.splice_from(pipeFds[0], relayed.size() - splicedSize);
+        spliced = static_cast<bool>(moved);
+        jvs::consume_error(moved.take_error());
+        splicedSize += spliced ? *moved : 0;
+      }
+
+      ::close(pipeFds[0]);
+      ::close(pipeFds[1]);
+      client.close();
+      return spliced;
+    });
+
+  std::string received;
+  std::vector<char> buffer(65536);
+  for (;;)
+  {
+    auto bytesRead = connection->recv(buffer.data(), buffer.size());
+    ASSERT_TRUE(static_cast<bool>(bytesRead));
+    if (*bytesRead == 0)
+    {
+      break;
+    }
+
+    received.append(buffer.data(), *bytesRead);
+  }
+
+  EXPECT_TRUE(senderTask.get());
+  EXPECT_EQ(received, contents.substr(Offset) + std::string(relayed));
+  // The file position is left alone.
+  EXPECT_EQ(::lseek(fd, 0, SEEK_CUR), static_cast<off_t>(contents.size()));
+  std::fclose(file);
+  connection->close();
+  server.close();
+}
+
+TEST(SocketTest, WriteFileReportsShortFile)
+{
+  using jvs::net::Socket;
+
+  Socket server(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(server.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"))));
+  auto listenEp = server.listen();
+  ASSERT_TRUE(static_cast<bool>(listenEp));
+
+  Socket client(jvs::net::IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(client.connect(*listenEp)));
+  auto connection = server.accept();
+  ASSERT_TRUE(static_cast<bool>(connection));
+
+  std::string_view contents("short file");
+  std::FILE* file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  ASSERT_EQ(std::fwrite(contents.data(), 1, contents.size(), file), contents.size());
+  ASSERT_EQ(std::fflush(file), 0);
+
+  auto e = jvs::net::write_file(client, ::fileno(file), 0, contents.size() + 1);
+  ASSERT_TRUE(e.is_a<jvs::StringError>());
+  std::string message;
+  jvs::handle_all_errors(std::move(e),
+    [&](const jvs::ErrorInfoBase& info) { message = info.message(); });
+  EXPECT_EQ(message, "file shorter than requested");
+
+  // What the file holds was still sent.
+  std::array<char, 64> buffer{};
+  auto bytesRead = connection->recv(buffer.data(), buffer.size());
+  ASSERT_TRUE(static_cast<bool>(bytesRead));
+  EXPECT_EQ(std::string_view(buffer.data(), *bytesRead), contents);
+  std::fclose(file);
+  client.close();
+  connection->close();
+  server.close();
+}
+
+#endif // __linux__
+
+TEST(SocketTest, TypedSocketOptions)
+{
+  namespace sockopt = jvs::net::sockopt;
+  static_assert(std::is_same_v<sockopt::TcpNoDelay::value_type, bool>);
+  static_assert(std::is_same_v<sockopt::ReceiveBufferSize::value_type, int>);
+
+  jvs::net::Socket s(jvs::net::IpAddress::Family::IPv4, jvs::net::Socket::Transport::Tcp);
+  auto noDelay = s.get_option<sockopt::TcpNoDelay>();
+  ASSERT_TRUE(static_cast<bool>(noDelay));
+  EXPECT_FALSE(*noDelay);
+  ASSERT_FALSE(s.set_option<sockopt::TcpNoDelay>(true));
+  noDelay = s.get_option<sockopt::TcpNoDelay>();
+  ASSERT_TRUE(static_cast<bool>(noDelay));
+  EXPECT_TRUE(*noDelay);
+
+  ASSERT_FALSE(s.set_option<sockopt::ReceiveBufferSize>(64 * 1024));
+  auto receiveBuffer = s.get_option<sockopt::ReceiveBufferSize>();
+  ASSERT_TRUE(static_cast<bool>(receiveBuffer));
+  EXPECT_GE(*receiveBuffer, 64 * 1024);
+
+  ASSERT_FALSE(s.set_option<sockopt::TypeOfService>(0x10));
+  auto tos = s.get_option<sockopt::TypeOfService>();
+  ASSERT_TRUE(static_cast<bool>(tos));
+  EXPECT_EQ(*tos, 0x10);
+
+  // Untyped access.
+  int type = 0;
+  auto length = s.get_option(SOL_SOCKET, SO_TYPE, &type, sizeof(type));
+  ASSERT_TRUE(static_cast<bool>(length));
+  EXPECT_EQ(*length, sizeof(type));
+  EXPECT_EQ(type, SOCK_STREAM);
+
+  // IPv6-only options fail on an IPv4 socket.
+  auto v6Only = s.get_option<sockopt::Ipv6Only>();
+  EXPECT_FALSE(static_cast<bool>(v6Only));
+  jvs::consume_error(v6Only.take_error());
+  s.close();
+}
+
@@ -0,0 +1,100 @@
+#include <coroutine>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/task.h>
+
+namespace
+{
+
+using jvs::net::Task;
+
+// Awaitable suspending until resumed by hand.
+struct ManualEvent
+{
+  std::coroutine_handle<> waiter{};
+
+  bool await_ready() const noexcept
+  {
+    return false;
+  }
+
+  void await_suspend(std::coroutine_handle<> coroutine) noexcept
+  {
+    waiter = coroutine;
+  }
+
+  void await_resume() const noexcept
+  {
+  }
+};
+
+Task<int> add(int a, int b, bool& started)
+{
+  started = true;
+  co_return a + b;
+}
+
+Task<std::string> concatenate(ManualEvent& event, bool& started)
+{
+  auto sum = co_await add(1, 2, started);
+  co_await event;
+  co_return "sum=" + std::to_string(sum);
+}
+
+Task<int> fail()
+{
+  throw std::runtime_error("failed");
+  co_return 0;
+}
+
+} // namespace
+
+TEST(TaskTest, LazyStartAndChaining)
+{
+  ManualEvent event;
+  bool started = false;
+  std::string result;
+  auto task = [](Task<std::string> inner, std::string& out) -> Task<>
+  {
+    out = co_await std::move(inner);
+  }(concatenate(event, started), result);
+
+  EXPECT_FALSE(started);
+  std::move(task).detach();
+  EXPECT_TRUE(started);
+  EXPECT_TRUE(result.empty());
+  ASSERT_TRUE(static_cast<bool>(event.waiter));
+  event.waiter.resume();
+  EXPECT_EQ(result, "sum=3");
+}
+
+TEST(TaskTest, ExceptionsPropagateToAwaiter)
+{
+  bool caught = false;
+  [](bool& out) -> Task<>
+  {
+    try
+    {
+      co_await fail();
+    }
+    catch (const std::runtime_error&)
+    {
+      out = true;
+    }
+  }(caught).detach();
+
+  EXPECT_TRUE(caught);
+}
+
+TEST(TaskTest, UnstartedTaskIsDestroyed)
+{
+  bool started = false;
+  {
+    auto task = add(1, 2, started);
+  }
+
+  EXPECT_FALSE(started);
+}
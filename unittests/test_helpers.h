@@ -0,0 +1,104 @@
+///
+/// @file test_helpers.h
+///
+/// Contains helpers shared by the unit tests.
+///
+
+#if !defined(JVS_NETLIB_TEST_HELPERS_H_)
+#define JVS_NETLIB_TEST_HELPERS_H_
+
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/error.h>
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_errors.h>
+
+namespace jvs::test
+{
+
+// Native code of a SocketError, or 0 for any other error.
+inline int socket_error_code(jvs::Error e)
+{
+  int code = 0;
+  jvs::handle_all_errors(std::move(e),
+    [&](const jvs::net::SocketError& error) { code = error.code(); });
+  return code;
+}
+
+// Loopback TCP listener which can be made to silently drop connection
+// attempts, the way a black-holed route would: once its accept queue is full
+// the kernel discards further SYNs.
+class Listener final
+{
+public:
+  explicit Listener(const char* endPoint = "127.0.0.1:0", bool blackHole = false)
+    : socket_(jvs::net::IpEndPoint::parse(endPoint)->address().family(),
+      jvs::net::Socket::Transport::Tcp)
+  {
+    auto bound = socket_.bind(*jvs::net::IpEndPoint::parse(endPoint));
+    EXPECT_TRUE(static_cast<bool>(bound));
+    auto listening = socket_.listen(blackHole ? 0 : 16);
+    EXPECT_TRUE(static_cast<bool>(listening));
+    end_point_ = *listening;
+    if (blackHole)
+    {
+      // Fill the accept queue.
+      for (int i = 0; i < 2; ++i)
+      {
+        fillers_.emplace_back(end_point_.address().family(), jvs::net::Socket::Transport::Tcp,
+          true);
+        jvs::consume_error(fillers_.back().connect(end_point_).take_error());
+      }
+    }
+  }
+
+  ~Listener()
+  {
+    for (auto& s : fillers_)
+    {
+      s.close();
+    }
+
+    socket_.close();
+  }
+
+  const jvs::net::IpEndPoint& end_point() const noexcept
+  {
+    return end_point_;
+  }
+
+  jvs::net::Socket& socket() noexcept
+  {
+    return socket_;
+  }
+
+  jvs::net::Socket accept()
+  {
+    auto accepted = socket_.accept();
+    EXPECT_TRUE(static_cast<bool>(accepted));
+    return std::move(*accepted);
+  }
+
+private:
+  jvs::net::Socket socket_;
+  jvs::net::IpEndPoint end_point_{};
+  std::vector<jvs::net::Socket> fillers_{};
+};
+
+// Returns a loopback end point nothing is listening on.
+inline jvs::net::IpEndPoint refused_end_point()
+{
+  jvs::net::Socket unused(jvs::net::IpAddress::Family::IPv4, jvs::net::Socket::Transport::Tcp);
+  auto ep = unused.bind(*jvs::net::IpEndPoint::parse("127.0.0.1:0"));
+  EXPECT_TRUE(static_cast<bool>(ep));
+  unused.close();
+  return *ep;
+}
+
+} // namespace jvs::test
+
+#endif // !JVS_NETLIB_TEST_HELPERS_H_
@@ -0,0 +1,167 @@
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/timer_wheel.h>
+
+namespace
+{
+
+using jvs::net::TimerWheel;
+using Clock = TimerWheel::Clock;
+using std::chrono::milliseconds;
+using std::chrono::microseconds;
+
+const Clock::time_point Start = Clock::time_point{} + std::chrono::hours(1);
+
+} // namespace
+
+TEST(TimerWheelTest, FiresInDeadlineOrder)
+{
+  TimerWheel wheel(milliseconds(1), Start);
+  std::vector<int> fired;
+  TimerWheel::Timer a([&] { fired.push_back(5); });
+  TimerWheel::Timer b([&] { fired.push_back(1); });
+  TimerWheel::Timer c([&] { fired.push_back(3); });
+  wheel.arm(a, Start + milliseconds(5));
+  wheel.arm(b, milliseconds(1));
+  wheel.arm(c, Start + milliseconds(3));
+  EXPECT_EQ(wheel.size(), 3u);
+  EXPECT_TRUE(a.armed());
+
+  EXPECT_EQ(wheel.advance(Start + milliseconds(2)), 1u);
+  EXPECT_EQ(fired, std::vector<int>({1}));
+  EXPECT_FALSE(b.armed());
+  EXPECT_EQ(wheel.advance(Start + milliseconds(10)), 2u);
+  EXPECT_EQ(fired, std::vector<int>({1, 3, 5}));
+  EXPECT_EQ(wheel.size(), 0u);
+  EXPECT_EQ(wheel.now(), Start + milliseconds(10));
+}
+
+TEST(TimerWheelTest, NeverFiresEarly)
+{
+  TimerWheel wheel(milliseconds(1), Start);
+  int fired = 0;
+  TimerWheel::Timer timer([&] { ++fired; });
+  wheel.arm(timer, Start + microseconds(1500));
+  EXPECT_EQ(timer.deadline(), Start + milliseconds(2));
+  EXPECT_EQ(wheel.advance(Start + microseconds(1999)), 0u);
+  EXPECT_EQ(wheel.advance(Start + milliseconds(2)), 1u);
+  EXPECT_EQ(fired, 1);
+
+  // Deadlines in the past fire on the next tick.
+  wheel.arm(timer, Start);
+  EXPECT_EQ(wheel.advance(Start + milliseconds(2)), 0u);
+  EXPECT_EQ(wheel.advance(Start + milliseconds(3)), 1u);
+}
+
+TEST(TimerWheelTest, CancelAndRearm)
+{
+  TimerWheel wheel(milliseconds(1), Start);
+  int periodic = 0;
+  int cancelled = 0;
+  TimerWheel::Timer victim([&] { ++cancelled; });
+  TimerWheel::Timer timer;
+  timer.set_callback([&]
+    {
+      ++periodic;
+      // Cancels a timer due in the same tick, and re-arms itself.
+      wheel.cancel(victim);
+      wheel.arm(timer, milliseconds(10));
+    });
+
+  wheel.arm(timer, milliseconds(10));
+  wheel.arm(victim, milliseconds(10));
+  EXPECT_EQ(wheel.advance(Start + milliseconds(35)), 3u);
+  EXPECT_EQ(periodic, 3);
+  EXPECT_EQ(cancelled, 0);
+  EXPECT_EQ(timer.deadline(), Start + milliseconds(40));
+
+  wheel.cancel(timer);
+  EXPECT_FALSE(timer.armed());
+  EXPECT_EQ(wheel.size(), 0u);
+  EXPECT_EQ(wheel.advance(Start + milliseconds(100)), 0u);
+
+  // Re-arming an armed timer replaces its deadline.
+  wheel.arm(timer, milliseconds(1000));
+  wheel.arm(timer, milliseconds(5));
+  EXPECT_EQ(wheel.size(), 1u);
+  EXPECT_EQ(wheel.advance(Start + milliseconds(105)), 1u);
+}
+
+TEST(TimerWheelTest, TimersAndWheelDisarmOnDestruction)
+{
+  auto wheel = std::make_unique<TimerWheel>(milliseconds(1), Start);
+  TimerWheel::Timer survivor;
+  {
+    TimerWheel::Timer timer([] { FAIL(); });
+    wheel->arm(timer, milliseconds(1));
+    wheel->arm(survivor, milliseconds(1));
+    EXPECT_EQ(wheel->size(), 2u);
+  }
+
+  EXPECT_EQ(wheel->size(), 1u);
+  wheel.reset();
+  EXPECT_FALSE(survivor.armed());
+}
+
+TEST(TimerWheelTest, Timeout)
+{
+  TimerWheel wheel(milliseconds(1), Start);
+  EXPECT_LT(wheel.timeout(Start).count(), 0);
+
+  TimerWheel::Timer timer([] {});
+  wheel.arm(timer, milliseconds(10));
+  EXPECT_EQ(wheel.timeout(Start), milliseconds(10));
+  EXPECT_EQ(wheel.timeout(Start + microseconds(3500)), milliseconds(7));
+  EXPECT_EQ(wheel.timeout(Start + milliseconds(20)), milliseconds(0));
+
+  // A far-off deadline may need the wheel to wake up earlier, to move it down
+  // a level, but never later.
+  wheel.arm(timer, std::chrono::hours(24 * 365));
+  auto timeout = wheel.timeout(Start);
+  EXPECT_GT(timeout, milliseconds(0));
+  EXPECT_LE(timeout, std::chrono::hours(24 * 365));
+}
+
+TEST(TimerWheelTest, ManyTimersAcrossLevels)
+{
+  TimerWheel wheel(milliseconds(1), Start);
+  constexpr std::size_t TimerCount = 100000;
+  std::mt19937_64 random(42);
+  // Up to about 12 days, spanning five levels.
+  std::uniform_int_distribution<std::int64_t> delays(0, std::int64_t{1} << 30);
+
+  std::vector<TimerWheel::Timer> timers(TimerCount);
+  std::vector<Clock::time_point> deadlines(TimerCount);
+  std::size_t early = 0;
+  std::size_t late = 0;
+  for (std::size_t i = 0; i < TimerCount; ++i)
+  {
+    deadlines[i] = Start + milliseconds(delays(random));
+    timers[i].set_callback([&, i]
+      {
+        early += (wheel.now() < deadlines[i]);
+        late += (wheel.now() > deadlines[i]);
+      });
+    wheel.arm(timers[i], deadlines[i]);
+  }
+
+  // Advance in uneven steps, as an event loop would.
+  std::size_t fired = 0;
+  std::uniform_int_distribution<std::int64_t> steps(1, std::int64_t{1} << 22);
+  auto now = Start;
+  while (wheel.size() != 0)
+  {
+    now += milliseconds(steps(random));
+    fired += wheel.advance(now);
+  }
+
+  EXPECT_EQ(fired, TimerCount);
+  EXPECT_EQ(early, 0u);
+  EXPECT_EQ(late, 0u);
+}
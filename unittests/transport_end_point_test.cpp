@@ -38,3 +38,17 @@ TEST(TransportEndPointTest, ParseTransportEndpoint_Bad)
   auto ep2 = jvs::net::TransportEndPoint::parse("192.168.123.114:8088/");
   EXPECT_FALSE(ep2);
 }
+
+TEST(TransportEndPointTest, EqualityAndHash)
+{
+  auto ep = jvs::net::TransportEndPoint::parse("192.168.123.114:8088/tcp");
+  auto same = jvs::net::TransportEndPoint::parse("192.168.123.114:8088");
+  auto udp = jvs::net::TransportEndPoint::parse("192.168.123.114:8088/udp");
+  ASSERT_TRUE(ep && same && udp);
+  EXPECT_EQ(*ep, *same);
+  EXPECT_NE(*ep, *udp);
+
+  std::hash<jvs::net::TransportEndPoint> hash;
+  EXPECT_EQ(hash(*ep), hash(*same));
+  EXPECT_NE(hash(*ep), hash(*udp));
+}
@@ -0,0 +1,65 @@
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/unix_end_point.h>
+
+using jvs::net::UnixEndPoint;
+
+TEST(UnixEndPointTest, DefaultIsUnnamed)
+{
+  UnixEndPoint ep;
+  EXPECT_TRUE(ep.is_unnamed());
+  EXPECT_FALSE(ep.is_abstract());
+  EXPECT_EQ(jvs::net::to_string(ep), "");
+}
+
+TEST(UnixEndPointTest, ParsePath)
+{
+  auto ep = UnixEndPoint::parse("/run/app.sock");
+  ASSERT_TRUE(static_cast<bool>(ep));
+  EXPECT_FALSE(ep->is_unnamed());
+  EXPECT_FALSE(ep->is_abstract());
+  EXPECT_EQ(ep->name(), "/run/app.sock");
+  EXPECT_EQ(jvs::net::to_string(*ep), "/run/app.sock");
+}
+
+TEST(UnixEndPointTest, ParseBadPath)
+{
+  EXPECT_FALSE(static_cast<bool>(UnixEndPoint::parse("")));
+  EXPECT_FALSE(static_cast<bool>(UnixEndPoint::path(std::string("a\0b", 3))));
+  EXPECT_FALSE(static_cast<bool>(
+    UnixEndPoint::path(std::string(UnixEndPoint::MaxNameLength + 1, 'a'))));
+  EXPECT_TRUE(static_cast<bool>(
+    UnixEndPoint::path(std::string(UnixEndPoint::MaxNameLength, 'a'))));
+}
+
+#if defined(__linux__)
+TEST(UnixEndPointTest, ParseAbstract)
+{
+  auto ep = UnixEndPoint::parse("@jvs-netlib");
+  ASSERT_TRUE(static_cast<bool>(ep));
+  EXPECT_TRUE(ep->is_abstract());
+  EXPECT_FALSE(ep->is_unnamed());
+  EXPECT_EQ(ep->name(), "jvs-netlib");
+  EXPECT_EQ(jvs::net::to_string(*ep), "@jvs-netlib");
+  EXPECT_FALSE(static_cast<bool>(
+    UnixEndPoint::abstract(std::string(UnixEndPoint::MaxNameLength + 1, 'a'))));
+}
+#endif
+
+TEST(UnixEndPointTest, Equality)
+{
+  auto ep = UnixEndPoint::parse("/tmp/a.sock");
+  auto same = UnixEndPoint::path("/tmp/a.sock");
+  auto other = UnixEndPoint::path("/tmp/b.sock");
+  ASSERT_TRUE(ep && same && other);
+  EXPECT_EQ(*ep, *same);
+  EXPECT_NE(*ep, *other);
+  EXPECT_NE(*ep, UnixEndPoint());
+#if defined(__linux__)
+  auto abstract = UnixEndPoint::abstract("/tmp/a.sock");
+  ASSERT_TRUE(static_cast<bool>(abstract));
+  EXPECT_NE(*ep, *abstract);
+#endif
+}
@@ -0,0 +1,293 @@
+#include <array>
+#include <cerrno>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include <jvs-netlib/ip_end_point.h>
+#include <jvs-netlib/socket.h>
+#include <jvs-netlib/socket_errors.h>
+#include <jvs-netlib/unix_end_point.h>
+#include <jvs-netlib/unix_socket.h>
+
+#include "test_helpers.h"
+
+namespace
+{
+
+using jvs::net::IpAddress;
+using jvs::net::IpEndPoint;
+using jvs::net::Socket;
+using jvs::net::UnixEndPoint;
+using jvs::net::UnixSocket;
+using jvs::test::socket_error_code;
+
+// Connects a client to `server`, which must be listening, and accepts it.
+std::pair<UnixSocket, UnixSocket> connect_pair(UnixSocket& server, const UnixEndPoint& ep)
+{
+  UnixSocket client(UnixSocket::Transport::Stream);
+  auto connected = client.connect(ep);
+  EXPECT_TRUE(static_cast<bool>(connected));
+  jvs::consume_error(connected.take_error());
+  auto accepted = server.accept();
+  EXPECT_TRUE(static_cast<bool>(accepted));
+  if (!accepted)
+  {
+    jvs::consume_error(accepted.take_error());
+    return {std::move(client), UnixSocket(UnixSocket::Transport::Stream)};
+  }
+
+  return {std::move(client), std::move(*accepted)};
+}
+
+void expect_echo(UnixSocket& from, UnixSocket& to, std::string_view data)
+{
+  auto sent = from.send(data.data(), data.size());
+  ASSERT_TRUE(static_cast<bool>(sent));
+  EXPECT_EQ(*sent, data.size());
+  std::array<char, 64> buffer{};
+  auto received = to.recv(buffer.data(), buffer.size());
+  ASSERT_TRUE(static_cast<bool>(received));
+  EXPECT_EQ(std::string_view(buffer.data(), *received), data);
+}
+
+} // namespace
+
+TEST(UnixSocketTest, StreamOverPath)
+{
+  auto ep = UnixEndPoint::path("/tmp/jvs-netlib-test-" + std::to_string(::getpid()) + ".sock");
+  ASSERT_TRUE(static_cast<bool>(ep));
+  ::unlink(ep->name().c_str());
+
+  UnixSocket server(UnixSocket::Transport::Stream);
+  ASSERT_GE(server.descriptor(), 0);
+  auto bound = server.bind(*ep);
+  ASSERT_TRUE(static_cast<bool>(bound));
+  EXPECT_EQ(*bound, *ep);
+  ASSERT_TRUE(static_cast<bool>(server.listen()));
+
+  auto [client, accepted] = connect_pair(server, *ep);
+  auto remote = client.remote();
+  ASSERT_TRUE(static_cast<bool>(remote));
+  EXPECT_EQ(*remote, *ep);
+  auto clientLocal = client.local();
+  ASSERT_TRUE(static_cast<bool>(clientLocal));
+  EXPECT_TRUE(clientLocal->is_unnamed());
+
+  expect_echo(client, accepted, "ping");
+  expect_echo(accepted, client, "pong");
+
+  // The socket file outlives the socket.
+  EXPECT_EQ(server.close(), 0);
+  EXPECT_EQ(::unlink(ep->name().c_str()), 0);
+  client.close();
+  accepted.close();
+}
+
+#if defined(__linux__)
+TEST(UnixSocketTest, StreamOverAbstractName)
+{
+  auto ep = UnixEndPoint::abstract("jvs-netlib-test-" + std::to_string(::getpid()));
+  ASSERT_TRUE(static_cast<bool>(ep));
+
+  UnixSocket server(UnixSocket::Transport::Stream, /*nonBlocking*/ true);
+  auto listening = server.bind(*ep);
+  ASSERT_TRUE(static_cast<bool>(listening));
+  EXPECT_EQ(*listening, *ep);
+  ASSERT_TRUE(static_cast<bool>(server.listen()));
+
+  auto pending = server.accept();
+  ASSERT_FALSE(static_cast<bool>(pending));
+  EXPECT_TRUE(pending.error_is_a<jvs::net::NonBlockingStatus>());
+  jvs::consume_error(pending.take_error());
+
+  auto [client, accepted] = connect_pair(server, *ep);
+  EXPECT_TRUE(accepted.is_nonblocking());
+  ASSERT_FALSE(jvs::error_to_bool(accepted.set_nonblocking(false)));
+  expect_echo(client, accepted, "abstract");
+
+  client.close();
+  accepted.close();
+  server.close();
+}
+
+TEST(UnixSocketTest, UnnamedBindAssignsAbstractName)
+{
+  UnixSocket s(UnixSocket::Transport::Stream);
+  auto bound = s.bind(UnixEndPoint());
+  ASSERT_TRUE(static_cast<bool>(bound));
+  EXPECT_TRUE(bound->is_abstract());
+  EXPECT_FALSE(bound->name().empty());
+  s.close();
+}
+#endif
+
+TEST(UnixSocketTest, ConnectWithoutListener)
+{
+  auto ep = UnixEndPoint::path("/tmp/jvs-netlib-test-missing-" + std::to_string(::getpid()));
+  ASSERT_TRUE(static_cast<bool>(ep));
+  UnixSocket client(UnixSocket::Transport::Stream);
+  auto connected = client.connect(*ep);
+  ASSERT_FALSE(static_cast<bool>(connected));
+  EXPECT_EQ(socket_error_code(connected.take_error()), ENOENT);
+  client.close();
+}
+
+TEST(UnixSocketTest, SeqPacketPreservesMessageBoundaries)
+{
+  auto sockets = UnixSocket::pair(UnixSocket::Transport::SeqPacket);
+  ASSERT_TRUE(static_cast<bool>(sockets));
+  auto& [a, b] = *sockets;
+  EXPECT_EQ(a.transport(), UnixSocket::Transport::SeqPacket);
+
+  ASSERT_TRUE(static_cast<bool>(a.send("ab", 2)));
+  ASSERT_TRUE(static_cast<bool>(a.send("cde", 3)));
+  std::array<char, 16> buffer{};
+  auto first = b.recv(buffer.data(), buffer.size());
+  ASSERT_TRUE(static_cast<bool>(first));
+  EXPECT_EQ(std::string_view(buffer.data(), *first), "ab");
+  auto second = b.recv(buffer.data(), buffer.size());
+  ASSERT_TRUE(static_cast<bool>(second));
+  EXPECT_EQ(std::string_view(buffer.data(), *second), "cde");
+
+  a.close();
+  b.close();
+}
+
+TEST(UnixSocketTest, PassesPipeDescriptor)
+{
+  auto sockets = UnixSocket::pair(UnixSocket::Transport::Stream);
+  ASSERT_TRUE(static_cast<bool>(sockets));
+  auto& [sender, receiver] = *sockets;
+
+  int pipeFds[2];
+  ASSERT_EQ(::pipe(pipeFds), 0);
+  std::array<int, 1> sent{pipeFds[1]};
+  auto sentLength = sender.send_fds("x", 1, sent);
+  ASSERT_TRUE(static_cast<bool>(sentLength));
+  EXPECT_EQ(*sentLength, 1u);
+  // The receiver gets its own descriptor for the pipe.
+  ::close(pipeFds[1]);
+
+  char byte = 0;
+  std::array<int, 4> fds{-1, -1, -1, -1};
+  auto received = receiver.recv_fds(&byte, 1, fds);
+  ASSERT_TRUE(static_cast<bool>(received));
+  EXPECT_EQ(received->length, 1u);
+  EXPECT_EQ(byte, 'x');
+  ASSERT_EQ(received->fd_count, 1u);
+  EXPECT_FALSE(received->truncated);
+  EXPECT_GE(fds[0], 0);
+  EXPECT_EQ(fds[1], -1);
+#if defined(__linux__)
+  EXPECT_NE(::fcntl(fds[0], F_GETFD) & FD_CLOEXEC, 0);
+#endif
+
+  std::string_view data("through the passed pipe");
+  ASSERT_EQ(::write(fds[0], data.data(), data.size()), static_cast<ssize_t>(data.size()));
+  ::close(fds[0]);
+  std::array<char, 64> buffer{};
+  auto length = ::read(pipeFds[0], buffer.data(), buffer.size());
+  EXPECT_EQ(std::string_view(buffer.data(), static_cast<std::size_t>(length)), data);
+  ::close(pipeFds[0]);
+
+  sender.close();
+  receiver.close();
+}
+
+TEST(UnixSocketTest, ReportsTruncatedDescriptors)
+{
+  auto sockets = UnixSocket::pair(UnixSocket::Transport::Stream);
+  ASSERT_TRUE(static_cast<bool>(sockets));
+  auto& [sender, receiver] = *sockets;
+
+  int pipeFds[2];
+  ASSERT_EQ(::pipe(pipeFds), 0);
+  std::array<int, 4> sent{pipeFds[0], pipeFds[1], pipeFds[0], pipeFds[1]};
+  ASSERT_TRUE(static_cast<bool>(sender.send_fds("x", 1, sent)));
+  ::close(pipeFds[0]);
+  ::close(pipeFds[1]);
+
+  char byte = 0;
+  std::array<int, 1> fds{-1};
+  auto received = receiver.recv_fds(&byte, 1, fds);
+  ASSERT_TRUE(static_cast<bool>(received));
+  EXPECT_EQ(received->fd_count, 1u);
+  EXPECT_TRUE(received->truncated);
+  ::close(fds[0]);
+
+  // Descriptors can't be sent without data.
+  auto empty = sender.send_fds(nullptr, 0, sent);
+  ASSERT_FALSE(static_cast<bool>(empty));
+  EXPECT_EQ(socket_error_code(empty.take_error()), EINVAL);
+
+  sender.close();
+  receiver.close();
+}
+
+TEST(UnixSocketTest, HandsOffTcpConnection)
+{
+  Socket listener(IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  auto listenerEp = listener.bind(*IpEndPoint::parse("127.0.0.1:0"));
+  ASSERT_TRUE(static_cast<bool>(listenerEp));
+  ASSERT_TRUE(static_cast<bool>(listener.listen()));
+  Socket client(IpAddress::Family::IPv4, Socket::Transport::Tcp);
+  ASSERT_TRUE(static_cast<bool>(client.connect(*listenerEp)));
+  auto accepted = listener.accept();
+  ASSERT_TRUE(static_cast<bool>(accepted));
+
+  // Hand the accepted connection to the other end of a Unix socket, as an
+  // acceptor process would to a worker process.
+  auto sockets = UnixSocket::pair(UnixSocket::Transport::SeqPacket);
+  ASSERT_TRUE(static_cast<bool>(sockets));
+  auto& [acceptor, worker] = *sockets;
+  std::array<int, 1> sent{static_cast<int>(accepted->descriptor())};
+  ASSERT_TRUE(static_cast<bool>(acceptor.send_fds("c", 1, sent)));
+  accepted->close();
+
+  char tag = 0;
+  std::array<int, 1> fds{-1};
+  auto received = worker.recv_fds(&tag, 1, fds);
+  ASSERT_TRUE(static_cast<bool>(received));
+  ASSERT_EQ(received->fd_count, 1u);
+
+  auto adopted = Socket::adopt(fds[0]);
+  ASSERT_TRUE(static_cast<bool>(adopted));
+  EXPECT_EQ(adopted->descriptor(), fds[0]);
+  EXPECT_FALSE(adopted->is_nonblocking());
+  EXPECT_EQ(adopted->local(), *listenerEp);
+  ASSERT_TRUE(adopted->remote().has_value());
+  EXPECT_EQ(*adopted->remote(), client.local());
+
+  std::string_view data("handed off");
+  ASSERT_TRUE(static_cast<bool>(adopted->send(data.data(), data.size())));
+  std::array<char, 64> buffer{};
+  auto length = client.recv(buffer.data(), buffer.size());
+  ASSERT_TRUE(static_cast<bool>(length));
+  EXPECT_EQ(std::string_view(buffer.data(), *length), data);
+
+  adopted->close();
+  client.close();
+  listener.close();
+  acceptor.close();
+  worker.close();
+}
+
+TEST(UnixSocketTest, AdoptRejectsNonIpSockets)
+{
+  UnixSocket s(UnixSocket::Transport::Stream);
+  auto adopted = Socket::adopt(s.descriptor());
+  ASSERT_FALSE(static_cast<bool>(adopted));
+  EXPECT_EQ(socket_error_code(adopted.take_error()), jvs::net::errcodes::EAFNoSupport);
+  // The descriptor is still owned by the caller.
+  EXPECT_EQ(s.close(), 0);
+
+  auto closed = Socket::adopt(s.descriptor());
+  ASSERT_FALSE(static_cast<bool>(closed));
+  EXPECT_EQ(socket_error_code(closed.take_error()), EBADF);
+}